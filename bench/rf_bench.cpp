@@ -0,0 +1,355 @@
+/*
+ * rf_bench - ESP433RF benchmarks on the host (PlatformIO env `native-bench`)
+ *
+ * Runs the library benchmarks against the simulated hardware of NativeHAL
+ * and prints their JSON reports on stdout, one line per run. The firmware's
+ * Serial output is discarded unless --console is given (it is still
+ * formatted, as on the device).
+ *
+ *   rf_bench rx [options]    receive path (RFRxBench)
+ *     --lines N              lines to replay (default 2000)
+ *     --rate N               lines per second, 0 = unthrottled (default 500)
+ *     --format lc|rx|hex|mix generated stream (default mix)
+ *     --recording FILE       replay recorded module output instead
+ *     --mode event|poll      event-driven receive task or polling task (default event)
+ *     --poll-ms N            polling interval (default 10)
+ *     --no-dispatcher        run the callback in the receive task
+ *     --label TEXT           copied into the report
+ *     --console              keep the firmware's Serial output
+ *   Exits with status 1 when the receive path allocated heap memory during
+ *   the run (allocs_per_frame must be 0).
+ *
+ *   rf_bench tx [options]    transmit path and waveform timing (RFTxBench)
+ *     --protocols LIST       comma separated protocol numbers (default 1)
+ *     --pulse LIST           pulse lengths in us, 0 = protocol default (default 0)
+ *     --repeats LIST         repeat counts (default 10)
+ *     --bits N               code length (default 32)
+ *     --sends N              sends per combination (default 20)
+ *     --backend rcswitch|rmt transmitter backend (default rcswitch)
+ *     --task                 send through the transmitter task
+ *     --precomputed          send precomputed waveforms (sendWaveform)
+ *     --label TEXT           copied into the reports
+ *     --console              keep the firmware's Serial output
+ *
+ *   One report per protocol/pulse/repeat combination. RMT output is
+ *   simulated with ideal edge times, so pulse errors are only meaningful
+ *   for the bit-banged rcswitch backend.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#include <Arduino.h>
+#include <NativeHAL.h>
+#include <ESP433RF.h>
+#include <RFRxBench.h>
+#include <RFTxBench.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#define BENCH_TX_PIN 14
+#define BENCH_RX_PIN 18
+#define BENCH_MODULE_UART 1  // ESP433RF接收使用Serial1
+
+// 分配计数：替换glibc的malloc入口（operator new和String最终都调用这里）
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+static std::atomic<uint32_t> allocations(0);
+
+extern "C" void* malloc(size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+static uint32_t countAllocations() {
+  return allocations.load(std::memory_order_relaxed);
+}
+#endif
+
+// 报告输出到stdout（Serial可能被丢弃）
+class StdoutPrint : public Print {
+public:
+  size_t write(uint8_t c) override {
+    return fputc(c, stdout) != EOF ? 1 : 0;
+  }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    return fwrite(buffer, 1, size, stdout);
+  }
+};
+
+static ESP433RF rf(BENCH_TX_PIN, BENCH_RX_PIN, 9600);
+static uint32_t pollMs = 10;
+
+static size_t injectLine(const uint8_t* data, size_t length, void* context) {
+  (void)context;
+  return nativeUartInject(BENCH_MODULE_UART, data, length);
+}
+
+static void pollTask(void* parameter) {
+  (void)parameter;
+  RFSignal signal;
+  while (true) {
+    rf.receive(signal);
+    delay(pollMs);
+  }
+}
+
+static bool parseList(const char* text, std::vector<uint32_t>& values) {
+  values.clear();
+  char* end = nullptr;
+  do {
+    values.push_back(strtoul(text, &end, 10));
+    if (end == text || (*end != ',' && *end != '\0')) {
+      return false;
+    }
+    text = end + 1;
+  } while (*end == ',');
+  return true;
+}
+
+static bool readFile(const char* path, std::string& content) {
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  char buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    content.append(buffer, n);
+  }
+  fclose(file);
+  return true;
+}
+
+static int usage() {
+  fprintf(stderr, "用法: rf_bench rx [--lines N] [--rate N] [--format lc|rx|hex|mix] [--recording FILE]\n"
+                  "                  [--mode event|poll] [--poll-ms N] [--no-dispatcher] [--label TEXT] [--console]\n"
+                  "      rf_bench tx [--protocols LIST] [--pulse LIST] [--repeats LIST] [--bits N] [--sends N]\n"
+                  "                  [--backend rcswitch|rmt] [--task] [--precomputed] [--label TEXT] [--console]\n");
+  return 2;
+}
+
+static int runReceiveBench(int argc, char** argv) {
+  RFRxBenchConfig config = {};
+  config.lines = 2000;
+  config.rate = 500;
+  config.format = RF_RX_BENCH_MIX;
+  config.drainMs = 1000;
+  config.target = "native";
+  config.label = "";
+  bool eventMode = true;
+  bool dispatcher = true;
+  bool console = false;
+  std::string recording;
+  
+  for (int i = 0; i < argc; i++) {
+    std::string option = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (option == "--lines" && hasValue) {
+      config.lines = strtoul(argv[++i], nullptr, 10);
+    } else if (option == "--rate" && hasValue) {
+      config.rate = strtoul(argv[++i], nullptr, 10);
+    } else if (option == "--format" && hasValue) {
+      std::string format = argv[++i];
+      if (format == "lc") {
+        config.format = RF_RX_BENCH_LC;
+      } else if (format == "rx") {
+        config.format = RF_RX_BENCH_RX;
+      } else if (format == "hex") {
+        config.format = RF_RX_BENCH_HEX;
+      } else if (format == "mix") {
+        config.format = RF_RX_BENCH_MIX;
+      } else {
+        return usage();
+      }
+    } else if (option == "--recording" && hasValue) {
+      if (!readFile(argv[++i], recording)) {
+        fprintf(stderr, "无法读取录制文件: %s\n", argv[i]);
+        return 1;
+      }
+      config.recording = recording.c_str();
+    } else if (option == "--mode" && hasValue) {
+      std::string mode = argv[++i];
+      if (mode != "event" && mode != "poll") {
+        return usage();
+      }
+      eventMode = mode == "event";
+    } else if (option == "--poll-ms" && hasValue) {
+      pollMs = strtoul(argv[++i], nullptr, 10);
+    } else if (option == "--no-dispatcher") {
+      dispatcher = false;
+    } else if (option == "--label" && hasValue) {
+      config.label = argv[++i];
+    } else if (option == "--console") {
+      console = true;
+    } else {
+      return usage();
+    }
+  }
+  
+  if (!console) {
+    nativeSetConsole(nullptr);
+  }
+  Serial.begin(115200);
+  
+  // 与固件相同的接收配置（src/main.cpp）
+  rf.begin();
+  if (dispatcher) {
+    rf.startDispatcher(1, 4096);
+  }
+  if (eventMode) {
+    rf.enableEventReceive(2, 4096);
+  } else {
+    xTaskCreate(pollTask, "RFPoll", 4096, nullptr, 2, nullptr);
+  }
+  
+  RFRxBench bench(rf, injectLine);
+  #ifdef __GLIBC__
+  bench.setAllocationCounter(countAllocations);
+  #endif
+  if (!bench.run(config)) {
+    fprintf(stderr, "基准测试无法运行（录制文件没有数据行？）\n");
+    return 1;
+  }
+  StdoutPrint out;
+  bench.printReport(out);
+  
+  // 接收路径不允许堆分配：每帧分配次数不为0时以失败退出
+  const RFRxBenchResult& result = bench.result();
+  if (result.allocations > 0) {
+    fprintf(stderr, "失败：接收路径在%lu行中分配了%ld次堆内存（allocs_per_frame必须为0）\n",
+            (unsigned long)result.lines, (long)result.allocations);
+    return 1;
+  }
+  return 0;
+}
+
+// 发送引脚的电平变化送入发送基准测试（相当于设备上的回环接线）
+static void captureTxPin(uint8_t pin, uint8_t level, uint32_t timeUs, void* context) {
+  if (pin == BENCH_TX_PIN) {
+    static_cast<RFTxBench*>(context)->recordEdge(level, timeUs);
+  }
+}
+
+static int runTransmitBench(int argc, char** argv) {
+  RFTxBenchConfig config = {};
+  config.sends = 20;
+  config.bits = 32;
+  config.timeoutMs = 5000;
+  config.target = "native";
+  config.label = "";
+  std::vector<uint32_t> protocols = {1};
+  std::vector<uint32_t> pulses = {0};
+  std::vector<uint32_t> repeats = {10};
+  RFTxBackend backend = RF_TX_RCSWITCH;
+  bool task = false;
+  bool console = false;
+  
+  for (int i = 0; i < argc; i++) {
+    std::string option = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (option == "--protocols" && hasValue) {
+      if (!parseList(argv[++i], protocols)) {
+        return usage();
+      }
+    } else if (option == "--pulse" && hasValue) {
+      if (!parseList(argv[++i], pulses)) {
+        return usage();
+      }
+    } else if (option == "--repeats" && hasValue) {
+      if (!parseList(argv[++i], repeats)) {
+        return usage();
+      }
+    } else if (option == "--bits" && hasValue) {
+      config.bits = strtoul(argv[++i], nullptr, 10);
+    } else if (option == "--sends" && hasValue) {
+      config.sends = strtoul(argv[++i], nullptr, 10);
+    } else if (option == "--backend" && hasValue) {
+      std::string name = argv[++i];
+      if (name != "rcswitch" && name != "rmt") {
+        return usage();
+      }
+      backend = name == "rmt" ? RF_TX_RMT : RF_TX_RCSWITCH;
+    } else if (option == "--task") {
+      task = true;
+    } else if (option == "--precomputed") {
+      config.precomputed = true;
+    } else if (option == "--label" && hasValue) {
+      config.label = argv[++i];
+    } else if (option == "--console") {
+      console = true;
+    } else {
+      return usage();
+    }
+  }
+  
+  if (!console) {
+    nativeSetConsole(nullptr);
+  }
+  Serial.begin(115200);
+  
+  rf.begin();
+  if (!rf.setTxBackend(backend)) {
+    fprintf(stderr, "无法切换发送后端\n");
+    return 1;
+  }
+  if (task) {
+    rf.startTransmitter();
+  }
+  
+  static RFTxBench bench(rf);
+  nativeSetPinListener(captureTxPin, &bench);
+  StdoutPrint out;
+  int status = 0;
+  for (uint32_t protocol : protocols) {
+    for (uint32_t pulse : pulses) {
+      for (uint32_t repeat : repeats) {
+        // 脉宽0：协议的默认脉宽
+        const RFProtocol* table = rfGetProtocol(protocol);
+        config.protocol = protocol;
+        config.pulseLength = pulse == 0 && table != nullptr ? table->pulseLength : pulse;
+        config.repeats = repeat;
+        if (bench.run(config)) {
+          bench.printReport(out);
+        } else {
+          fprintf(stderr, "无法运行: 协议%u 脉宽%u 重复%u\n", protocol, pulse, repeat);
+          status = 1;
+        }
+      }
+    }
+  }
+  nativeSetPinListener(nullptr, nullptr);
+  return status;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    return usage();
+  }
+  std::string bench = argv[1];
+  int status;
+  if (bench == "rx") {
+    status = runReceiveBench(argc - 2, argv + 2);
+  } else if (bench == "tx") {
+    status = runTransmitBench(argc - 2, argv + 2);
+  } else {
+    status = usage();
+  }
+  // 接收/发送任务仍在运行：不执行全局析构
+  fflush(nullptr);
+  _Exit(status);
+}
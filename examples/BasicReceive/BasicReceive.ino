@@ -11,10 +11,11 @@
 ESP433RF rf(14, 18, 9600);
 
 // Receive callback function
-void onReceive(RFSignal signal) {
+void onReceive(const RFSignal& signal) {
+  char hex[RF_SIGNAL_HEX_LEN + 1];
+  signal.toHex(hex);
   Serial.print("Received: ");
-  Serial.print(signal.address);
-  Serial.print(signal.key);
+  Serial.print(hex);
   Serial.println();
 }
 
@@ -40,9 +41,10 @@ void loop() {
   if (rf.receiveAvailable()) {
     RFSignal signal;
     if (rf.receive(signal)) {
+      char hex[RF_SIGNAL_HEX_LEN + 1];
+      signal.toHex(hex);
       Serial.print("Signal received: ");
-      Serial.print(signal.address);
-      Serial.print(signal.key);
+      Serial.print(hex);
       Serial.print(" (Send: ");
       Serial.print(rf.getSendCount());
       Serial.print(", Receive: ");
@@ -34,18 +34,19 @@ void setup() {
 
 void loop() {
   // Send signal: address code (6 hex digits) + key (2 hex digits)
-  RFSignal signal;
-  signal.address = "62E7E8";
-  signal.key = "31";
+  RFSignal signal = {};
+  signal.code = 0x62E7E831;  // 62E7E8 + 31
+  signal.pulseLength = 380;  // Per-signal pulse length (0 = library setting)
   
+  char hex[RF_SIGNAL_HEX_LEN + 1];
+  signal.toHex(hex);
   Serial.print("Sending: ");
-  Serial.print(signal.address);
-  Serial.print(signal.key);
+  Serial.print(hex);
   Serial.print(" (Total sent: ");
   Serial.print(rf.getSendCount());
   Serial.println(")");
   
-  rf.send(signal, 380);
+  rf.send(signal);
   
   delay(3000);  // Wait 3 seconds
 }
@@ -3,6 +3,9 @@
  * 
  * This example demonstrates sending random signals
  * and verifying received signals.
+ * 
+ * All 32 bits of each code (address + key) are sent, so a receiver
+ * module in range reports exactly the code that was sent.
  */
 
 #include <ESP433RF.h>
@@ -12,16 +15,16 @@ ESP433RF rf(14, 18, 9600);
 
 // Random signals array
 RFSignal signals[] = {
-  {"62E7E8", "31"},
-  {"A3B4C5", "32"},
-  {"D6E7F8", "33"},
-  {"1A2B3C", "34"},
-  {"4D5E6F", "35"},
-  {"7A8B9C", "36"},
-  {"AB12CD", "37"},
-  {"EF34AB", "38"},
-  {"5678EF", "39"},
-  {"9ABC12", "3A"}
+  {0x62E7E831},
+  {0xA3B4C532},
+  {0xD6E7F833},
+  {0x1A2B3C34},
+  {0x4D5E6F35},
+  {0x7A8B9C36},
+  {0xAB12CD37},
+  {0xEF34AB38},
+  {0x5678EF39},
+  {0x9ABC123A}
 };
 
 #define SIGNAL_COUNT (sizeof(signals) / sizeof(signals[0]))
@@ -35,8 +38,8 @@ void setup() {
   Serial.println("ESP433RF - Random Send Example");
   Serial.println("==================================");
   
-  // Initialize library with RCSwitch
-  rf.begin(true);  // true = use RCSwitch library
+  // Initialize library (RCSwitch transmit)
+  rf.begin();
   
   // Configure
   rf.setRepeatCount(5);
@@ -55,15 +58,17 @@ void loop() {
   // Randomly select a signal
   int index = random(0, SIGNAL_COUNT);
   currentSent = signals[index];
+  currentSent.pulseLength = 380;
   
   Serial.print("Sending [");
   Serial.print(index);
   Serial.print("]: ");
-  Serial.print(currentSent.address);
-  Serial.print(currentSent.key);
+  char hex[RF_SIGNAL_HEX_LEN + 1];
+  currentSent.toHex(hex);
+  Serial.print(hex);
   Serial.println();
   
-  rf.send(currentSent, 380);
+  rf.send(currentSent);
   
   // Check for received signals
   delay(1000);  // Wait a bit for signal to be received
@@ -71,13 +76,12 @@ void loop() {
   if (rf.receiveAvailable()) {
     RFSignal received;
     if (rf.receive(received)) {
+      received.toHex(hex);
       Serial.print("Received: ");
-      Serial.print(received.address);
-      Serial.print(received.key);
+      Serial.print(hex);
       
       // Verify match
-      if (received.address == currentSent.address && 
-          received.key == currentSent.key) {
+      if (received.sameCode(currentSent)) {
         Serial.println(" ✓ MATCH!");
       } else {
         Serial.println(" ✗ No match");
@@ -0,0 +1,90 @@
+/*
+ * ESP433RF - Receive Benchmark Example
+ *
+ * Measures the receive path (UART, line parser, dispatcher, callback) with
+ * RFRxBench and prints one JSON report per run on Serial.
+ *
+ * Wiring: the receiver module's output is replaced by Serial2. Disconnect
+ * the module DATA line from GPIO18 and connect GPIO17 (Serial2 TX) to
+ * GPIO18 (ESP433RF RX). Send 'r' over Serial to run the benchmarks again.
+ *
+ * The same benchmark runs on the host: pio run -e native-bench
+ */
+
+#include <ESP433RF.h>
+#include <RFRxBench.h>
+
+#define BENCH_TX_PIN 17  // Serial2 TX, wired to the ESP433RF RX pin
+
+// Create instance: TX pin, RX pin, baud rate
+ESP433RF rf(14, 18, 9600);
+
+// Recorded receiver module output (two remotes, one garbled line)
+const char recording[] =
+  "LC:2DD9A4AA\r\n"
+  "LC:2DD9A4AA\r\n"
+  "LC:2DD9A4AA\r\n"
+  "LC:62E7E831\r\n"
+  "LC:62E7E831\r\n"
+  "L\xFF:62E7\r\n"
+  "LC:2DD9A4A8\r\n";
+
+size_t writeSerial2(const uint8_t* data, size_t length, void* context) {
+  return Serial2.write(data, length);
+}
+
+uint32_t freeHeap() {
+  return ESP.getFreeHeap();
+}
+
+RFRxBench bench(rf, writeSerial2);
+
+void runBenchmarks() {
+  RFRxBenchConfig config = {};
+  config.format = RF_RX_BENCH_MIX;
+  config.drainMs = 1000;
+  config.target = "esp32";
+  config.label = "event+dispatcher";
+  
+  // 9600 baud: one 13-byte line takes about 13.5ms on the wire (about 74 lines/s)
+  const uint32_t rates[] = {10, 40, 70};
+  for (uint8_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+    config.rate = rates[i];
+    config.lines = rates[i] * 10;
+    if (bench.run(config)) {
+      bench.printReport(Serial);
+    }
+  }
+  
+  config.recording = recording;
+  config.rate = 40;
+  config.lines = 400;
+  if (bench.run(config)) {
+    bench.printReport(Serial);
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+  
+  Serial.println("ESP433RF - Receive Benchmark Example");
+  Serial.println("==================================");
+  
+  Serial2.begin(9600, SERIAL_8N1, -1, BENCH_TX_PIN);
+  
+  // Same receive configuration as the firmware
+  rf.begin();
+  rf.startDispatcher(1, 4096);
+  rf.enableEventReceive(2, 4096);
+  
+  bench.setHeapProbe(freeHeap);
+  runBenchmarks();
+}
+
+void loop() {
+  if (Serial.available() && Serial.read() == 'r') {
+    runBenchmarks();
+  }
+  delay(10);
+}
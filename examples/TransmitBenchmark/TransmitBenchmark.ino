@@ -0,0 +1,85 @@
+/*
+ * ESP433RF - Transmit Benchmark Example
+ *
+ * Measures the transmit path (send() call, completion, back-to-back rate)
+ * with RFTxBench and compares the waveform on the TX pin with the ideal
+ * waveform of the protocol. Prints one JSON report per combination of
+ * protocol, pulse length and repeat count on Serial.
+ *
+ * Wiring: connect GPIO14 (ESP433RF TX) to GPIO19 (loopback capture). The
+ * transmitter module may stay connected. Send 'r' over Serial to run the
+ * benchmarks again.
+ *
+ * The same benchmark runs on the host: pio run -e native-bench
+ */
+
+#include <ESP433RF.h>
+#include <RFTxBench.h>
+
+#define BENCH_LOOPBACK_PIN 19  // Wired to the ESP433RF TX pin
+
+// Create instance: TX pin, RX pin, baud rate
+ESP433RF rf(14, 18, 9600);
+
+RFTxBench bench(rf);
+
+void runSweep(RFTxBackend backend, bool task, const char* label) {
+  if (!rf.setTxBackend(backend)) {
+    Serial.printf("Backend not available: %s\n", label);
+    return;
+  }
+  if (task) {
+    rf.startTransmitter();
+  } else {
+    rf.stopTransmitter();
+  }
+  
+  RFTxBenchConfig config = {};
+  config.sends = 20;
+  config.bits = 32;
+  config.timeoutMs = 5000;
+  config.target = "esp32";
+  config.label = label;
+  
+  const uint8_t protocols[] = {1, 2, 6};
+  const uint16_t pulses[] = {0, 200};  // 0 = protocol default
+  const uint8_t repeats[] = {1, 10};
+  for (uint8_t p = 0; p < sizeof(protocols); p++) {
+    for (uint8_t l = 0; l < sizeof(pulses) / sizeof(pulses[0]); l++) {
+      for (uint8_t r = 0; r < sizeof(repeats); r++) {
+        config.protocol = protocols[p];
+        config.pulseLength = pulses[l] != 0 ? pulses[l] : rfGetProtocol(protocols[p])->pulseLength;
+        config.repeats = repeats[r];
+        if (bench.run(config)) {
+          bench.printReport(Serial);
+        }
+      }
+    }
+  }
+}
+
+void runBenchmarks() {
+  runSweep(RF_TX_RCSWITCH, false, "rcswitch+sync");
+  runSweep(RF_TX_RCSWITCH, true, "rcswitch+task");
+  runSweep(RF_TX_RMT, true, "rmt+task");
+  rf.setTxBackend(RF_TX_RCSWITCH);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+  
+  Serial.println("ESP433RF - Transmit Benchmark Example");
+  Serial.println("===================================");
+  
+  rf.begin();
+  bench.attachLoopback(BENCH_LOOPBACK_PIN);
+  runBenchmarks();
+}
+
+void loop() {
+  if (Serial.available() && Serial.read() == 'r') {
+    runBenchmarks();
+  }
+  delay(10);
+}
@@ -5,6 +5,94 @@
 
 #include "ESP433RF.h"
 
+// ========== RFSignal Hex Conversion ==========
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+// Convert hex character to number (-1 if not a hex digit)
+static int8_t hexDigitValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// Parse exactly `digits` hex characters (at most 16)
+static bool parseHex(const char* hex, uint8_t digits, uint64_t &value) {
+  if (hex == nullptr) return false;
+  value = 0;
+  for (uint8_t i = 0; i < digits; i++) {
+    int8_t v = hexDigitValue(hex[i]);
+    if (v < 0) return false;
+    value = (value << 4) | (uint8_t)v;
+  }
+  return true;
+}
+
+void RFSignal::toHex(char* out) const {
+  uint64_t value = code;
+  uint8_t digits = (bits() + 3) / 4;
+  for (int i = digits - 1; i >= 0; i--) {
+    out[i] = HEX_DIGITS[value & 0x0F];
+    value >>= 4;
+  }
+  out[digits] = '\0';
+}
+
+bool RFSignal::fromHex(const char* hex, RFSignal& signal) {
+  uint64_t value;
+  size_t digits = hex != nullptr ? strlen(hex) : 0;
+  if (digits == 0 || digits > RF_SIGNAL_HEX_LEN || !parseHex(hex, digits, value)) return false;
+  signal = RFSignal();
+  signal.code = value;
+  signal.bitLength = digits * 4;
+  return true;
+}
+
+bool RFSignal::fromHex(const char* address, const char* key, RFSignal& signal) {
+  uint64_t addr, k;
+  if (address == nullptr || key == nullptr || strlen(address) != 6 || strlen(key) != 2) return false;
+  if (!parseHex(address, 6, addr) || !parseHex(key, 2, k)) return false;
+  signal = RFSignal();
+  signal.code = (addr << 8) | k;
+  signal.bitLength = RF_SIGNAL_DEFAULT_BITS;
+  return true;
+}
+
+bool RFSignal::setBitLength(uint8_t bits) {
+  if (bits == 0 || bits > RF_SIGNAL_MAX_BITS || (bits < 64 && (code >> bits) != 0)) return false;
+  bitLength = bits;
+  return true;
+}
+
+// Receiver module code: exactly 8 hex digits, anything after them is ignored
+static bool parseModuleCode(const char* hex, RFSignal& signal) {
+  uint64_t value;
+  if (!parseHex(hex, RF_SIGNAL_MODULE_HEX_LEN, value)) return false;
+  signal = RFSignal();
+  signal.code = value;
+  signal.bitLength = RF_SIGNAL_DEFAULT_BITS;
+  return true;
+}
+
+// ========== Metrics ==========
+// 所有实例共用（导出见RFMetrics.h）
+
+static RFCounter rxLines("rf_rx_lines_total", "Receiver module lines read");
+static RFCounter rxParseErrors("rf_rx_parse_errors_total", "Receiver module lines that did not parse as a signal");
+static RFHistogram rxParseTime("rf_rx_parse_seconds", "Receiver module line parse time");
+static RFCounter rxFrames("rf_rx_frames_total", "Frames decoded (module lines and raw receive) after the echo filter");
+static RFCounter rxPresses("rf_rx_presses_total", "Presses received (frames when deduplication is off)");
+static RFCounter rxEchoSuppressed("rf_rx_echo_suppressed_total", "Frames dropped as the echo of an own send");
+static RFCounter rxQueueDropped("rf_rx_queue_dropped_total", "Receive events dropped because the dispatcher queue was full");
+static RFGauge rxQueueHighWater("rf_rx_queue_high_water", "Most receive events waiting for the dispatcher");
+static RFHistogram rxQueueWait("rf_rx_queue_wait_seconds", "Receive event published to dispatcher callback start");
+static RFCounter txSignals("rf_tx_signals_total", "Signals transmitted");
+static RFCounter txQueueFull("rf_tx_queue_full_total", "Send requests rejected because the transmit queue was full");
+static RFGauge txQueueHighWater("rf_tx_queue_high_water", "Most send requests waiting for the transmitter task");
+static RFHistogram txQueueWait("rf_tx_queue_wait_seconds", "Send request queued to transmitter task start");
+static RFHistogram txTime("rf_tx_seconds", "Transmit time per signal (encoding and time on air)");
+
 // Constructor
 ESP433RF::ESP433RF(uint8_t txPin, uint8_t rxPin, uint32_t baudRate) {
   _txPin = txPin;
@@ -16,30 +104,102 @@ ESP433RF::ESP433RF(uint8_t txPin, uint8_t rxPin, uint32_t baudRate) {
   _pulseLength = 320;
   _sendCount = 0;
   _receiveCount = 0;
+  _frameCount = 0;
   _receiveCallback = nullptr;
+  _transmitCallback = nullptr;
+  _pressCallback = nullptr;
+  
+  // Initialize press tracking
+  memset(_presses, 0, sizeof(_presses));
+  _openPresses = 0;
+  _dedupWindowMs = RF_DEDUP_WINDOW_MS;
   _rcSwitch = nullptr;
   
+  // Initialize transmit backend
+  _txBackend = RF_TX_RCSWITCH;
+  #ifdef ESP32
+  _rmtChannel = RMT_CHANNEL_0;
+  _rmtInstalled = false;
+  _rmtWaveform = nullptr;
+  #endif
+  
+  // Initialize transmit queue
+  _txNextHandle = 0;
+  _txCompleted = 0;
+  _txHighWater = 0;
+  _txDropped = 0;
+  
+  // Initialize echo filter
+  for (uint8_t i = 0; i < RF_ECHO_FILTER_SIZE; i++) {
+    _echo[i].digest = 0;
+    _echo[i].until = 0;
+  }
+  _echoNext = 0;
+  _echoWindowMs = RF_ECHO_WINDOW_MS;
+  _echoSuppressed = 0;
+  #ifdef ESP32
+  _txQueue = nullptr;
+  _txMutex = nullptr;
+  _txTask = nullptr;
+  #endif
+  
   // Initialize replay buffer
   _replayBufferEnabled = false;
   _replayBuffer = nullptr;
   _replayBufferSize = 0;
   _replayBufferIndex = 0;
   _replayBufferCount = 0;
-  _lastReceived = {"", ""};
+  _lastReceived = RFSignal();
   
   // Initialize capture mode
   _captureMode = false;
-  _capturedSignal = {"", ""};
+  _capturedSignal = RFSignal();
   _hasCapturedSignal = false;
   
   // Initialize receive control
   _receiveEnabled = true;
   
+  // Initialize line parser
+  _lineLength = 0;
+  _lineState = LINE_IDLE;
+  
+  // Initialize dispatcher
+  #ifdef ESP32
+  _dispatchTask = nullptr;
+  #endif
+  
+  // Initialize event-driven receive (Serial1 = UART1)
+  #ifdef ESP32
+  _uartNum = UART_NUM_1;
+  _uartQueue = nullptr;
+  _eventTask = nullptr;
+  #endif
+  
+  // Initialize raw receive
+  _rawHead = 0;
+  _rawTail = 0;
+  _rawLastEdge = 0;
+  _rawDropped = 0;
+  _rawDecoded = 0;
+  _rawCaptureState = RAW_CAPTURE_IDLE;
+  _capturePulses = nullptr;
+  _capturedTrace = nullptr;
+  _capturedTraceLength = 0;
+  _captureCount = 0;
+  _captureMaxPulses = 0;
+  _captureUs = 0;
+  _captureMaxUs = 0;
+  #ifdef ESP32
+  _rawTask = nullptr;
+  #endif
+  
   // Initialize flash storage
   #ifdef ESP32
   _flashStorageEnabled = false;
   _preferences = nullptr;
   _flashNamespace = "rf_replay";
+  _persistence = nullptr;
+  _persistClient = -1;
   #endif
 }
 
@@ -61,11 +221,38 @@ void ESP433RF::begin() {
     _rcSwitch->setRepeatTransmit(_repeatCount);
   }
   
+  // RMT要在pinMode之后接管引脚（pinMode会把引脚切回普通GPIO输出）
+  #ifdef ESP32
+  if (_txBackend == RF_TX_RMT && !beginRMT()) {
+    _txBackend = RF_TX_RCSWITCH;
+  }
+  #endif
+  
   resetCounters();
 }
 
 // End
 void ESP433RF::end() {
+  #ifdef ESP32
+  if (_txTask != nullptr) {
+    stopTransmitter();
+  }
+  if (_eventTask != nullptr) {
+    disableEventReceive();
+  }
+  if (_rawTask != nullptr) {
+    disableRawReceive();
+  }
+  if (_dispatchTask != nullptr) {
+    stopDispatcher();
+  }
+  endRMT();
+  #endif
+  // 解码任务已停止，录制缓冲区不再被访问
+  _rawCaptureState = RAW_CAPTURE_IDLE;
+  free(_capturePulses);
+  _capturePulses = nullptr;
+  _capturedTrace = nullptr;
   if (_rcSwitch != nullptr) {
     delete _rcSwitch;
     _rcSwitch = nullptr;
@@ -79,112 +266,656 @@ bool ESP433RF::receiveAvailable() {
 }
 
 // Receive signal
+// 读取串口中已到达的所有数据，每解析出一帧就处理一次（计数、复刻缓冲区、捕获、回调），
+// signal返回最后一帧
 bool ESP433RF::receive(RFSignal &signal) {
-  static String buffer = "";
-  
   // 如果接收被禁用，清空缓冲区并返回false
   if (!_receiveEnabled) {
     while (_serial->available()) {
       _serial->read();  // 丢弃数据
     }
+    _lineLength = 0;
+    _lineState = LINE_IDLE;
     return false;
   }
   
-  while (_serial->available()) {
-    char c = _serial->read();
-    
-    if (c == '\n' || c == '\r') {
-      if (buffer.length() > 0) {
-        // 调试输出：显示接收到的原始数据
-        Serial.printf("[ESP433RF] 接收原始数据: %s\n", buffer.c_str());
-        bool result = parseSignal(buffer, signal);
-        if (result) {
-          Serial.printf("[ESP433RF] 解析结果: 地址码=%s, 按键值=%s (完整数据=%s%s)\n", 
-                       signal.address.c_str(), signal.key.c_str(),
-                       signal.address.c_str(), signal.key.c_str());
+  // 轮询模式下在每次调用时结束超时的按键
+  expirePresses(millis());
+  
+  bool received = false;
+  uint8_t chunk[32];
+  int available;
+  while ((available = _serial->available()) > 0) {
+    size_t n = _serial->read(chunk, (size_t)available < sizeof(chunk) ? (size_t)available : sizeof(chunk));
+    for (size_t i = 0; i < n; i++) {
+      RFSignal frame;
+      if (feedByte((char)chunk[i], frame) && handleSignal(frame)) {
+        signal = frame;
+        received = true;
+      }
+    }
+  }
+  
+  return received;
+}
+
+// Feed one byte into the line parser, returns true when a complete line parsed into signal
+bool ESP433RF::feedByte(char c, RFSignal &signal) {
+  bool endOfLine = (c == '\n' || c == '\r');
+  
+  switch (_lineState) {
+    case LINE_IDLE:
+      if (endOfLine || c == ' ' || c == '\t') {
+        return false;
+      }
+      _lineLength = 0;
+      _lineState = LINE_DATA;
+      // fall through
+      
+    case LINE_DATA:
+      if (!endOfLine) {
+        if (_lineLength >= RF_LINE_BUFFER_SIZE - 1) {
+          _lineState = LINE_OVERFLOW;  // Buffer overflow protection
+        } else {
+          _lineBuffer[_lineLength++] = c;
         }
-        buffer = "";
-        if (result) {
-          _receiveCount++;
-          
-          // 添加到复刻缓冲区
-          addToReplayBuffer(signal);
-          
-          // 检查捕获模式
-          checkCaptureMode(signal);
-          
-          if (_receiveCallback != nullptr) {
-            _receiveCallback(signal);
-          }
-          return true;
+        return false;
+      }
+      _lineBuffer[_lineLength] = '\0';
+      _lineState = LINE_IDLE;
+      
+      // 调试输出：显示接收到的原始数据
+      RF_TRACE("ESP433RF", "接收原始数据: %s", _lineBuffer);
+      rxLines.add();
+      {
+        uint32_t start = micros();
+        bool parsed = parseSignal(_lineBuffer, _lineLength, signal);
+        rxParseTime.observe(micros() - start);
+        if (!parsed) {
+          rxParseErrors.add();
+          return false;
         }
       }
-    } else {
-      buffer += c;
-      if (buffer.length() > 64) {
-        buffer = "";  // Buffer overflow protection
+      RF_TRACE("ESP433RF", "解析结果: 地址码=%06lX, 按键值=%02X (完整数据=%08lX)",
+               (unsigned long)signal.address(), signal.key(), (unsigned long)signal.code);
+      return true;
+      
+    case LINE_OVERFLOW:
+      if (endOfLine) {
+        _lineState = LINE_IDLE;
       }
+      return false;
+  }
+  return false;
+}
+
+// Process a parsed signal
+// 返回false表示帧被过滤（回声或重复帧）
+bool ESP433RF::handleSignal(const RFSignal& signal) {
+  if (isEcho(signal.digest())) {
+    _echoSuppressed++;  // 自己刚发送的信号，不计入接收
+    rxEchoSuppressed.add();
+    return false;
+  }
+  
+  _frameCount++;
+  rxFrames.add();
+  if (_dedupWindowMs > 0 && !trackPress(signal, millis())) {
+    return false;  // 同一次按键的重复帧
+  }
+  
+  _receiveCount++;
+  rxPresses.add();
+  
+  // 添加到复刻缓冲区
+  addToReplayBuffer(signal);
+  
+  // 检查捕获模式
+  checkCaptureMode(signal);
+  
+  RFReceiveEvent event;
+  event.signal = signal;
+  event.timestamp = micros();
+  event.frames = 0;
+  event.holdMs = 0;
+  publishEvent(event);
+  return true;
+}
+
+// 返回true表示新按键，false表示正在进行的按键的重复帧
+bool ESP433RF::trackPress(const RFSignal& signal, uint32_t now) {
+  expirePresses(now);
+  
+  uint8_t freeSlot = RF_PRESS_TRACK_SIZE;
+  uint8_t oldest = 0;
+  for (uint8_t i = 0; i < RF_PRESS_TRACK_SIZE; i++) {
+    PressEntry& entry = _presses[i];
+    if (entry.frames == 0) {
+      freeSlot = i;
+      continue;
+    }
+    if (entry.signal.sameCode(signal)) {
+      entry.frames++;
+      entry.last = now;
+      return false;
+    }
+    if ((int32_t)(entry.first - _presses[oldest].first) < 0 || _presses[oldest].frames == 0) {
+      oldest = i;
     }
   }
   
-  return false;
+  if (freeSlot == RF_PRESS_TRACK_SIZE) {
+    // 同时按下的信号太多：提前结束最早的按键
+    endPress(oldest);
+    freeSlot = oldest;
+  }
+  PressEntry& entry = _presses[freeSlot];
+  entry.signal = signal;
+  entry.first = now;
+  entry.last = now;
+  entry.frames = 1;
+  _openPresses++;
+  return true;
+}
+
+// 结束windowMs内没有新帧的按键
+void ESP433RF::expirePresses(uint32_t now) {
+  if (_openPresses == 0) {
+    return;
+  }
+  for (uint8_t i = 0; i < RF_PRESS_TRACK_SIZE; i++) {
+    if (_presses[i].frames > 0 && now - _presses[i].last > _dedupWindowMs) {
+      endPress(i);
+    }
+  }
+}
+
+void ESP433RF::endPress(uint8_t slot) {
+  PressEntry& entry = _presses[slot];
+  RFReceiveEvent event;
+  event.signal = entry.signal;
+  event.timestamp = micros();
+  event.frames = entry.frames;
+  event.holdMs = entry.last - entry.first;
+  entry.frames = 0;
+  _openPresses--;
+  if (_pressCallback != nullptr) {
+    publishEvent(event);
+  }
 }
 
-// Parse signal from string
-bool ESP433RF::parseSignal(String data, RFSignal &signal) {
-  data.trim();
+void ESP433RF::publishEvent(const RFReceiveEvent& event) {
+  #ifdef ESP32
+  TaskHandle_t dispatcher = _dispatchTask;
+  if (dispatcher != nullptr) {
+    // 交给分发任务执行回调；队列满时丢弃并计数，不阻塞接收
+    if (_receiveQueue.push(event)) {
+      rxQueueHighWater.raise(_receiveQueue.size());
+      xTaskNotifyGive(dispatcher);
+    } else {
+      rxQueueDropped.add();
+    }
+    return;
+  }
+  #endif
   
-  // Format 1: LC:XXXXXXYY
-  if (data.startsWith("LC:") && data.length() >= 11) {
-    String signalStr = data.substring(3, 11);
-    signal.address = signalStr.substring(0, 6);
-    signal.key = signalStr.substring(6, 8);
-    signal.address.toUpperCase();
-    signal.key.toUpperCase();
-    return true;
+  deliverEvent(event);
+}
+
+void ESP433RF::deliverEvent(const RFReceiveEvent& event) {
+  if (event.frames == 0) {
+    if (_receiveCallback != nullptr) {
+      _receiveCallback(event.signal);
+    }
+  } else if (_pressCallback != nullptr) {
+    _pressCallback(event.signal, event.frames, event.holdMs);
+  }
+}
+
+// Parse signal from a receiver module line (parsed in place, no copies)
+bool ESP433RF::parseSignal(const char* data, size_t length, RFSignal &signal) {
+  if (data == nullptr) return false;
+  while (length > 0 && (*data == ' ' || *data == '\t')) {
+    data++;
+    length--;
   }
   
+  // Format 1: LC:XXXXXXYY
   // Format 2: RX:XXXXXXYY
-  if (data.startsWith("RX:") && data.length() >= 11) {
-    String signalStr = data.substring(3, 11);
-    signal.address = signalStr.substring(0, 6);
-    signal.key = signalStr.substring(6, 8);
-    signal.address.toUpperCase();
-    signal.key.toUpperCase();
-    return true;
+  if (length >= 3 + RF_SIGNAL_MODULE_HEX_LEN && data[2] == ':' &&
+      ((data[0] == 'L' && data[1] == 'C') || (data[0] == 'R' && data[1] == 'X'))) {
+    return parseModuleCode(data + 3, signal);
   }
   
   // Format 3: Direct 8-digit hex
-  if (data.length() >= 8) {
-    bool isHex = true;
-    for (int i = 0; i < 8; i++) {
-      char c = data.charAt(i);
-      if (!((c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'))) {
-        isHex = false;
-        break;
+  if (length >= RF_SIGNAL_MODULE_HEX_LEN) {
+    return parseModuleCode(data, signal);
+  }
+  
+  return false;
+}
+
+// ========== Dispatcher Task (ESP32 only) ==========
+
+#ifdef ESP32
+bool ESP433RF::startDispatcher(UBaseType_t priority, uint32_t stackSize) {
+  if (_dispatchTask != nullptr) {
+    return true;
+  }
+  _receiveQueue.clear();
+  if (xTaskCreate(dispatchTaskEntry, "RFDispatch", stackSize, this, priority, &_dispatchTask) != pdPASS) {
+    _dispatchTask = nullptr;
+    RF_LOGE("ESP433RF", "分发任务创建失败");
+    return false;
+  }
+  return true;
+}
+
+void ESP433RF::stopDispatcher() {
+  if (_dispatchTask == nullptr) {
+    return;
+  }
+  TaskHandle_t task = _dispatchTask;
+  _dispatchTask = nullptr;  // 之后的帧直接同步回调
+  vTaskDelete(task);
+}
+
+void ESP433RF::dispatchTaskEntry(void* arg) {
+  static_cast<ESP433RF*>(arg)->dispatchLoop();
+}
+
+void ESP433RF::dispatchLoop() {
+  RFReceiveEvent event;
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (_receiveQueue.pop(event)) {
+      rxQueueWait.observe(micros() - event.timestamp);
+      deliverEvent(event);
+    }
+  }
+}
+#endif
+
+// Send signal
+RFTxHandle ESP433RF::send(uint32_t address, uint8_t key) {
+  RFSignal signal = RFSignal();
+  signal.code = (address << 8) | key;
+  return send(signal);
+}
+
+// Send signal (RFSignal struct)
+RFTxHandle ESP433RF::send(const RFSignal& signal, uint8_t flags) {
+  return sendWaveform(signal, nullptr, flags);
+}
+
+// Send signal with an optional precomputed waveform (the request takes its own reference)
+RFTxHandle ESP433RF::sendWaveform(const RFSignal& signal, RFWaveform* waveform, uint8_t flags) {
+  RFTxRequest request = RFTxRequest();
+  request.signal = signal;
+  request.waveform = waveform;
+  request.flags = flags;
+  if (waveform != nullptr) {
+    waveform->retain();
+  }
+  return submit(request);
+}
+
+RFTxHandle ESP433RF::sendBatch(const RFTxItem* items, uint8_t count, uint8_t flags) {
+  if (items == nullptr || count == 0 || count > RF_TX_BATCH_MAX) {
+    return 0;
+  }
+  
+  // 复制到请求自己的内存块，调用者的数组在返回后即可释放
+  RFTxItem* batch = (RFTxItem*)malloc(sizeof(RFTxItem) * count);
+  if (batch == nullptr) {
+    return 0;
+  }
+  memcpy(batch, items, sizeof(RFTxItem) * count);
+  for (uint8_t i = 0; i < count; i++) {
+    if (batch[i].waveform != nullptr) {
+      batch[i].waveform->retain();
+    }
+  }
+  
+  RFTxRequest request = RFTxRequest();
+  request.signal = batch[count - 1].signal;
+  request.batch = batch;
+  request.batchCount = count;
+  request.flags = flags;
+  return submit(request);
+}
+
+// Queue a request (or send it in the caller without transmitter task); takes over its references
+RFTxHandle ESP433RF::submit(RFTxRequest& request) {
+  request.queuedUs = micros();
+  #ifdef ESP32
+  if (_txTask != nullptr) {
+    // 句柄分配和入队在同一互斥区内，保证句柄顺序与发送顺序一致
+    xSemaphoreTake(_txMutex, portMAX_DELAY);
+    request.handle = nextTxHandle();
+    bool queued = xQueueSend(_txQueue, &request, 0) == pdTRUE;
+    if (queued) {
+      _txNextHandle = request.handle;
+    }
+    xSemaphoreGive(_txMutex);
+    
+    if (!queued) {
+      releaseRequest(request);
+      _txDropped++;
+      txQueueFull.add();
+      return 0;
+    }
+    uint32_t depth = uxQueueMessagesWaiting(_txQueue);
+    if (depth > _txHighWater) {
+      _txHighWater = depth;
+    }
+    txQueueHighWater.raise(depth);
+    return request.handle;
+  }
+  #endif
+  
+  request.handle = nextTxHandle();
+  _txNextHandle = request.handle;
+  transmit(request);
+  return request.handle;
+}
+
+RFWaveform* ESP433RF::encodeWaveform(const RFSignal& signal, uint8_t repeats) {
+  uint8_t protocolNumber = signal.protocol != 0 ? signal.protocol : _protocol;
+  const RFProtocol* protocol = rfGetProtocol(protocolNumber);
+  if (repeats == 0) {
+    repeats = _repeatCount;
+  }
+  if (protocol == nullptr || repeats == 0) {
+    return nullptr;
+  }
+  uint16_t pulseLength = signal.pulseLength != 0 ? signal.pulseLength : _pulseLength;
+  
+  // 按信号记录的位数原样发送
+  RFWaveform* waveform = RFWaveform::create(*protocol, pulseLength, signal.code, signal.bits(),
+                                            repeats, RF_WAVEFORM_MAX_ITEMS);
+  if (waveform != nullptr) {
+    waveform->code = signal.code;
+    waveform->bitLength = signal.bits();
+    waveform->protocol = protocolNumber;
+  }
+  return waveform;
+}
+
+bool ESP433RF::isWaveformCurrent(const RFWaveform* waveform, const RFSignal& signal, uint8_t repeats) {
+  if (signal.protocol == RF_PROTOCOL_RAW) {
+    // 原始波形自带时序和重复次数，与设置无关
+    return waveform != nullptr && waveform->protocol == RF_PROTOCOL_RAW && waveform->code == signal.code;
+  }
+  return waveform != nullptr &&
+         waveform->code == signal.code &&
+         waveform->bitLength == signal.bits() &&
+         waveform->protocol == (signal.protocol != 0 ? signal.protocol : _protocol) &&
+         waveform->pulseLength == (signal.pulseLength != 0 ? signal.pulseLength : _pulseLength) &&
+         waveform->repeats == (repeats != 0 ? repeats : _repeatCount);
+}
+
+RFWaveform* ESP433RF::encodeRawWaveform(const uint8_t* trace, uint16_t length) {
+  return RFWaveform::createRaw(trace, length, RF_WAVEFORM_MAX_ITEMS);
+}
+
+RFTxHandle ESP433RF::sendRaw(const uint8_t* trace, uint16_t length, uint8_t flags) {
+  RFWaveform* waveform = encodeRawWaveform(trace, length);
+  if (waveform == nullptr) {
+    return 0;
+  }
+  RFSignal signal = RFSignal();
+  signal.code = waveform->code;
+  signal.protocol = RF_PROTOCOL_RAW;
+  RFTxHandle handle = sendWaveform(signal, waveform, flags);
+  waveform->release();  // 入队的请求持有自己的引用
+  return handle;
+}
+
+RFTxHandle ESP433RF::nextTxHandle() {
+  RFTxHandle handle = _txNextHandle + 1;
+  return handle != 0 ? handle : 1;  // 0保留为无效句柄
+}
+
+bool ESP433RF::isSendComplete(RFTxHandle handle) {
+  return handle != 0 && (int32_t)(_txCompleted - handle) >= 0;
+}
+
+void ESP433RF::setTransmitCallback(TransmitCallback callback) {
+  _transmitCallback = callback;
+}
+
+uint32_t ESP433RF::getTxQueueDepth() {
+  #ifdef ESP32
+  if (_txQueue != nullptr) {
+    return uxQueueMessagesWaiting(_txQueue);
+  }
+  #endif
+  return 0;
+}
+
+// Transmit one request (transmitter task or synchronous caller)
+// Release the references a request holds
+void ESP433RF::releaseRequest(const RFTxRequest& request) {
+  if (request.waveform != nullptr) {
+    request.waveform->release();
+  }
+  if (request.batch != nullptr) {
+    for (uint8_t i = 0; i < request.batchCount; i++) {
+      if (request.batch[i].waveform != nullptr) {
+        request.batch[i].waveform->release();
       }
     }
-    if (isHex) {
-      signal.address = data.substring(0, 6);
-      signal.key = data.substring(6, 8);
-      signal.address.toUpperCase();
-      signal.key.toUpperCase();
-      return true;
+    free(request.batch);
+  }
+}
+
+void ESP433RF::transmit(const RFTxRequest& request) {
+  // 批量发送时整批只暂停和恢复一次接收
+  bool pauseReceive = (request.flags & RF_TX_PAUSE_RECEIVE) && _receiveEnabled;
+  if (pauseReceive) {
+    disableReceive();
+  }
+  
+  bool suppressEcho = (request.flags & RF_TX_SUPPRESS_ECHO) != 0;
+  if (request.batch != nullptr) {
+    for (uint8_t i = 0; i < request.batchCount; i++) {
+      const RFTxItem& item = request.batch[i];
+      uint8_t echoSlot = suppressEcho ? beginEcho(item.signal.digest()) : 0;
+      transmitSignal(item.signal, item.waveform, item.repeats);
+      if (suppressEcho) {
+        endEcho(echoSlot);
+      }
+      if (_transmitCallback != nullptr) {
+        _transmitCallback(request.handle, item.signal);
+      }
+      if (item.gapMs > 0 && i + 1 < request.batchCount) {
+        delay(item.gapMs);
+      }
     }
+  } else {
+    uint8_t echoSlot = suppressEcho ? beginEcho(request.signal.digest()) : 0;
+    transmitSignal(request.signal, request.waveform, 0);
+    if (suppressEcho) {
+      endEcho(echoSlot);
+    }
+  }
+  releaseRequest(request);
+  
+  if (pauseReceive) {
+    delay(RF_TX_RECEIVE_HOLDOFF_MS);  // 等待接收模块输出完自己发送的信号
+    enableReceive();
   }
   
+  _txCompleted = request.handle;
+  if (_transmitCallback != nullptr && request.batch == nullptr) {
+    _transmitCallback(request.handle, request.signal);
+  }
+}
+
+// 登记即将发送的信号码（发送期间有效），返回槽位
+// 槽位循环复用，只在发送任务中写入；先清除期限再改信号码，接收路径不会看到新旧混合的条目
+uint8_t ESP433RF::beginEcho(uint32_t digest) {
+  uint8_t slot = _echoNext;
+  _echoNext = (_echoNext + 1) % RF_ECHO_FILTER_SIZE;
+  EchoEntry& entry = _echo[slot];
+  entry.until.store(0);
+  entry.digest.store(digest);
+  entry.until.store((millis() + RF_ECHO_TX_MAX_MS) | 1);
+  return slot;
+}
+
+// 发送结束：接收模块输出可能滞后，再保留一个窗口
+void ESP433RF::endEcho(uint8_t slot) {
+  _echo[slot].until.store((millis() + _echoWindowMs) | 1);
+}
+
+bool ESP433RF::isEcho(uint32_t digest) {
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < RF_ECHO_FILTER_SIZE; i++) {
+    uint32_t until = _echo[i].until.load();
+    if (until != 0 && (int32_t)(until - now) > 0 && _echo[i].digest.load() == digest) {
+      return true;
+    }
+  }
   return false;
 }
 
-// Send signal
-void ESP433RF::send(String address, String key) {
+void ESP433RF::transmitSignal(const RFSignal& signal, RFWaveform* waveform, uint8_t repeats) {
+  if (signal.protocol == RF_PROTOCOL_RAW && !isWaveformCurrent(waveform, signal)) {
+    // 原始波形只能回放录制的时序，不能按协议重新编码
+    RF_LOGE("ESP433RF", "原始波形%08lX没有波形数据，无法发送", (unsigned long)signal.code);
+    return;
+  }
   _sendCount++;
-  sendSignalRCSwitch(address, key);
+  txSignals.add();
+  uint32_t start = micros();
+  if (repeats == 0) {
+    repeats = _repeatCount;
+  }
+  
+  // 预编码波形在设置变化后作废，按当前设置发送
+  if (waveform != nullptr && !isWaveformCurrent(waveform, signal, repeats)) {
+    waveform = nullptr;
+  }
+  #ifdef ESP32
+  if (waveform == nullptr && _txBackend == RF_TX_RMT) {
+    // RMT需要脉冲序列：同一信号连续发送时复用上次编码结果
+    if (!isWaveformCurrent(_rmtWaveform, signal, repeats)) {
+      if (_rmtWaveform != nullptr) {
+        _rmtWaveform->release();
+      }
+      _rmtWaveform = encodeWaveform(signal, repeats);
+    }
+    waveform = _rmtWaveform;
+  }
+  #endif
+  
+  if (waveform != nullptr) {
+    replayWaveform(*waveform);
+  } else {
+    sendSignalRCSwitch(signal, repeats);
+  }
+  txTime.observe(micros() - start);
 }
 
-// Send signal (RFSignal struct)
-void ESP433RF::send(RFSignal signal) {
-  send(signal.address, signal.key);
+// ========== Transmitter Task (ESP32 only) ==========
+
+#ifdef ESP32
+bool ESP433RF::startTransmitter(UBaseType_t priority, uint32_t stackSize) {
+  if (_txTask != nullptr) {
+    return true;
+  }
+  if (_txQueue == nullptr) {
+    _txQueue = xQueueCreate(RF_TX_QUEUE_SIZE, sizeof(RFTxRequest));
+  }
+  if (_txMutex == nullptr) {
+    _txMutex = xSemaphoreCreateMutex();
+  }
+  if (_txQueue == nullptr || _txMutex == nullptr) {
+    RF_LOGE("ESP433RF", "发送队列创建失败");
+    return false;
+  }
+  if (xTaskCreate(txTaskEntry, "RFTransmit", stackSize, this, priority, &_txTask) != pdPASS) {
+    _txTask = nullptr;
+    RF_LOGE("ESP433RF", "发送任务创建失败");
+    return false;
+  }
+  return true;
+}
+
+void ESP433RF::stopTransmitter() {
+  if (_txTask == nullptr) {
+    return;
+  }
+  // 丢弃排队的请求并放入停止标记（句柄0），等待正在进行的发送完成后任务退出
+  xSemaphoreTake(_txMutex, portMAX_DELAY);
+  discardTxQueue();
+  RFTxRequest stop = RFTxRequest();
+  xQueueSend(_txQueue, &stop, portMAX_DELAY);
+  xSemaphoreGive(_txMutex);
+  while (_txTask != nullptr) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  discardTxQueue();
+  _txCompleted = _txNextHandle;  // 被丢弃的请求视为已结束
+}
+
+// Drop queued requests, releasing their waveforms
+void ESP433RF::discardTxQueue() {
+  RFTxRequest request;
+  while (xQueueReceive(_txQueue, &request, 0) == pdTRUE) {
+    releaseRequest(request);
+  }
+}
+
+void ESP433RF::txTaskEntry(void* arg) {
+  static_cast<ESP433RF*>(arg)->txLoop();
+}
+
+void ESP433RF::txLoop() {
+  RFTxRequest request;
+  while (true) {
+    if (xQueueReceive(_txQueue, &request, portMAX_DELAY) != pdTRUE) {
+      continue;
+    }
+    if (request.handle == 0) {
+      break;  // stopTransmitter()
+    }
+    txQueueWait.observe(micros() - request.queuedUs);
+    transmit(request);
+  }
+  _txTask = nullptr;  // 之后的发送在调用者中同步执行
+  vTaskDelete(nullptr);
+}
+#endif
+
+// Select transmit backend
+bool ESP433RF::setTxBackend(RFTxBackend backend, uint8_t rmtChannel) {
+  #ifdef ESP32
+  if (backend == RF_TX_RMT) {
+    if (rmtChannel >= RMT_CHANNEL_MAX - 1) {
+      return false;  // 使用两个内存块，需要下一个通道的内存
+    }
+    if (_rmtInstalled && _rmtChannel != (rmt_channel_t)rmtChannel) {
+      endRMT();
+    }
+    _rmtChannel = (rmt_channel_t)rmtChannel;
+    // begin()之前只记录选择，由begin()初始化
+    if (_rcSwitch != nullptr && !beginRMT()) {
+      return false;
+    }
+    _txBackend = RF_TX_RMT;
+    return true;
+  }
+  endRMT();
+  #else
+  if (backend == RF_TX_RMT) {
+    return false;
+  }
+  #endif
+  _txBackend = RF_TX_RCSWITCH;
+  return true;
 }
 
 // Set repeat count
@@ -215,6 +946,7 @@ void ESP433RF::setPulseLength(uint16_t pulseLength) {
 void ESP433RF::resetCounters() {
   _sendCount = 0;
   _receiveCount = 0;
+  _frameCount = 0;
 }
 
 // Set receive callback
@@ -222,66 +954,120 @@ void ESP433RF::setReceiveCallback(ReceiveCallback callback) {
   _receiveCallback = callback;
 }
 
-// Convert hex character to number
-uint8_t ESP433RF::hexToNum(char c) {
-  if (c >= '0' && c <= '9') return c - '0';
-  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-  return 0;
+// Set press callback
+void ESP433RF::setPressCallback(PressCallback callback) {
+  _pressCallback = callback;
+}
+
+// 应在接收空闲时修改（未结束的按键在下一帧或超时时按新窗口结束）
+void ESP433RF::setDedupWindow(uint16_t windowMs) {
+  _dedupWindowMs = windowMs;
 }
 
 // Send signal via RCSwitch
-void ESP433RF::sendSignalRCSwitch(String address, String key) {
+void ESP433RF::sendSignalRCSwitch(const RFSignal& signal, uint8_t repeats) {
   if (_rcSwitch == nullptr) return;
   
-  // RCSwitch方式：将地址码和按键值转换为24位数据
-  // 注意：1527编码是24位，RCSwitch只支持24位
-  // 接收模块返回的格式：地址码（6位十六进制）+ 按键值（2位十六进制）= 8位十六进制
-  // 例如：E7E83100 = 地址码E7E831 + 按键值00
-  // 这8位数据组合后就是24位数据，直接发送即可
-  
-  String fullHex = address + key;  // 例如：E7E83100 (8位十六进制)
-  
-  // 解析为32位数据
-  uint32_t fullData = 0;
-  for (int i = 0; i < 8 && i < fullHex.length(); i++) {
-    uint8_t val = hexToNum(fullHex.charAt(i));
-    fullData = (fullData << 4) | val;
-  }
-  
-  // 1527编码格式：24位数据
-  // 接收模块返回格式：地址码（6位十六进制）+ 按键值（2位十六进制）= 8位十六进制
-  // 例如：62E7E831 = 地址码62E7E8（24位） + 按键值31（8位）
-  // 
-  // 为什么地址码可以是8位但很多信号助手显示6位？
-  // 1. 433MHz编码协议（EV1527/PT2262）只支持24位数据
-  // 2. 24位 = 6位十六进制（6 × 4 = 24）
-  // 3. 显示方式差异：
-  //    - 6位显示：只显示地址码（如 62E7E8），这是433MHz编码的实际有效位
-  //    - 8位显示：地址码（6位）+ 按键值（2位），如 62E7E831
-  //      但实际只有前24位（地址码）有效，后8位（按键值）可能用于其他用途
-  // 4. 接收模块可能返回8位十六进制（32位），但协议只支持24位
-  //    所以发送时只使用前24位（地址码），忽略后8位（按键值）
-  //
-  // 提取24位数据：取前24位（地址码），去掉后8位（按键值）
-  // 例如：0x62E7E831 -> 右移8位 -> 0x0062E7E8（前24位，地址码）
-  uint32_t code24bit = (fullData >> 8) & 0xFFFFFF;  // 前24位（地址码）
-  
-  // 调试输出：显示发送的数据
-  Serial.printf("[ESP433RF] 发送数据 - 输入:%s%s (32位:0x%08lX), 24位:0x%06lX\n", 
-               address.c_str(), key.c_str(), fullData, code24bit);
+  // 发送信号记录的全部位（接收模块的信号为32位：地址码 + 按键值，原始接收的信号为解码出的位数）
+  uint8_t bitLength = signal.bits();
+  if (bitLength > RF_RCSWITCH_MAX_BITS) {
+    // RCSwitch只能发送32位以内的编码：按协议编码后直接翻转引脚
+    RFWaveform* waveform = encodeWaveform(signal, repeats);
+    if (waveform != nullptr) {
+      replayWaveform(*waveform);
+      waveform->release();
+    }
+    return;
+  }
+  uint8_t protocol = signal.protocol != 0 ? signal.protocol : _protocol;
+  uint16_t pulseLength = signal.pulseLength != 0 ? signal.pulseLength : _pulseLength;
   
   // 确保RCSwitch配置正确（每次发送前检查）
-  _rcSwitch->setProtocol(_protocol);
-  _rcSwitch->setPulseLength(_pulseLength);
-  _rcSwitch->setRepeatTransmit(_repeatCount);
+  _rcSwitch->setProtocol(protocol);
+  _rcSwitch->setPulseLength(pulseLength);
+  _rcSwitch->setRepeatTransmit(repeats);
+  _rcSwitch->send((unsigned long)signal.code, bitLength);
+  
+  #if RF_TRACE_ENABLED
+  if (rfLog.isEnabled(RF_LOG_DEBUG, "ESP433RF")) {
+    char hex[RF_SIGNAL_HEX_LEN + 1];
+    signal.toHex(hex);
+    RF_TRACE("ESP433RF", "已发送%u位数据: 0x%s (重复%d次)", bitLength, hex, repeats);
+  }
+  #endif
+}
+
+// Replay a precomputed waveform (RMT hardware, or direct pin toggling without RCSwitch)
+void ESP433RF::replayWaveform(const RFWaveform& waveform) {
+  #ifdef ESP32
+  if (_txBackend == RF_TX_RMT && _rmtInstalled) {
+    for (uint8_t sent = 0; sent < waveform.repeats; sent += waveform.burstRepeats) {
+      rmt_write_items(_rmtChannel, (const rmt_item32_t*)waveform.items, waveform.itemCount, true);
+    }
+    return;
+  }
+  #endif
   
-  // 发送24位数据
-  _rcSwitch->send(code24bit, 24);
+  // 按预编码的时序直接翻转引脚，省去逐位编码和协议/脉宽设置
+  for (uint8_t sent = 0; sent < waveform.repeats; sent += waveform.burstRepeats) {
+    for (uint16_t i = 0; i < waveform.itemCount; i++) {
+      const RFPulse& item = waveform.items[i];
+      if (item.duration0 == 0) {
+        break;
+      }
+      digitalWrite(_txPin, item.level0);
+      delayMicroseconds(item.duration0);
+      if (item.duration1 == 0) {
+        break;
+      }
+      digitalWrite(_txPin, item.level1);
+      delayMicroseconds(item.duration1);
+    }
+  }
+  digitalWrite(_txPin, LOW);
+}
+
+// ========== RMT Transmit (ESP32 only) ==========
+
+#ifdef ESP32
+static_assert(sizeof(RFPulse) == sizeof(rmt_item32_t), "RFPulse must match rmt_item32_t");
+
+bool ESP433RF::beginRMT() {
+  if (_rmtInstalled) {
+    return true;
+  }
   
-  Serial.printf("[ESP433RF] 已发送24位数据: 0x%06lX (重复%d次)\n", code24bit, _repeatCount);
+  rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)_txPin, _rmtChannel);
+  config.clk_div = 80;        // APB 80MHz / 80 = 1us per tick
+  config.mem_block_num = 2;   // 128个item的硬件缓冲，WiFi中断繁忙时也来得及补充
+  config.tx_config.carrier_en = false;
+  config.tx_config.loop_en = false;
+  config.tx_config.idle_output_en = true;
+  config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+  
+  if (rmt_config(&config) != ESP_OK || rmt_driver_install(_rmtChannel, 0, 0) != ESP_OK) {
+    RF_LOGW("ESP433RF", "RMT初始化失败，使用RCSwitch发送");
+    return false;
+  }
+  _rmtInstalled = true;
+  return true;
 }
 
+void ESP433RF::endRMT() {
+  if (_rmtInstalled) {
+    rmt_driver_uninstall(_rmtChannel);
+    _rmtInstalled = false;
+    // 把引脚交还给普通GPIO输出（RCSwitch）
+    pinMode(_txPin, OUTPUT);
+    digitalWrite(_txPin, LOW);
+  }
+  if (_rmtWaveform != nullptr) {
+    _rmtWaveform->release();
+    _rmtWaveform = nullptr;
+  }
+}
+#endif
+
 // ========== Replay Buffer Functions ==========
 
 void ESP433RF::enableReplayBuffer(uint8_t size) {
@@ -329,7 +1115,7 @@ void ESP433RF::clearReplayBuffer() {
   _replayBufferCount = 0;
 }
 
-void ESP433RF::addToReplayBuffer(RFSignal signal) {
+void ESP433RF::addToReplayBuffer(const RFSignal& signal) {
   if (!_replayBufferEnabled || _replayBuffer == nullptr) {
     return;
   }
@@ -346,7 +1132,7 @@ void ESP433RF::addToReplayBuffer(RFSignal signal) {
 void ESP433RF::enableCaptureMode() {
   _captureMode = true;
   _hasCapturedSignal = false;
-  _capturedSignal = {"", ""};
+  _capturedSignal = RFSignal();
 }
 
 void ESP433RF::disableCaptureMode() {
@@ -367,28 +1153,33 @@ RFSignal ESP433RF::getCapturedSignal() {
 
 void ESP433RF::clearCapturedSignal() {
   _hasCapturedSignal = false;
-  _capturedSignal = {"", ""};
-  #ifdef ESP32
-  if (_flashStorageEnabled) {
-    clearFlash();
-  }
-  #endif
+  _capturedSignal = RFSignal();
+  persistCapture();
 }
 
-void ESP433RF::checkCaptureMode(RFSignal signal) {
+void ESP433RF::checkCaptureMode(const RFSignal& signal) {
   if (_captureMode) {
     _capturedSignal = signal;
     _hasCapturedSignal = true;
     _captureMode = false;  // 捕获完成后自动退出捕获模式
-    
-    #ifdef ESP32
-    if (_flashStorageEnabled) {
-      saveToFlash();
-    }
-    #endif
+    persistCapture();
   }
 }
 
+// Save capture state: deferred to the persistence task when one is set
+void ESP433RF::persistCapture() {
+  #ifdef ESP32
+  if (!_flashStorageEnabled) {
+    return;
+  }
+  if (_persistence != nullptr) {
+    _persistence->markDirty(_persistClient);
+  } else {
+    saveToFlash();
+  }
+  #endif
+}
+
 // ========== Flash Storage Functions (ESP32 only) ==========
 
 #ifdef ESP32
@@ -400,6 +1191,22 @@ void ESP433RF::enableFlashStorage(const char* namespace_name) {
   }
 }
 
+void ESP433RF::setPersistence(RFPersistence* persistence) {
+  _persistence = persistence;
+  _persistClient = persistence != nullptr ? persistence->registerClient("ESP433RF", persistFlush, this) : -1;
+  if (_persistClient < 0) {
+    _persistence = nullptr;  // 注册失败时回退到同步写入
+  }
+}
+
+bool ESP433RF::persistFlush(void* context) {
+  ESP433RF* rf = static_cast<ESP433RF*>(context);
+  if (rf->_flashStorageEnabled) {
+    rf->saveToFlash();  // 返回值表示是否有捕获信号，不是写入结果
+  }
+  return true;
+}
+
 void ESP433RF::disableFlashStorage() {
   _flashStorageEnabled = false;
   if (_preferences != nullptr) {
@@ -414,13 +1221,20 @@ bool ESP433RF::saveToFlash() {
   }
   
   _preferences->begin(_flashNamespace.c_str(), false);
-  if (_hasCapturedSignal && _capturedSignal.address.length() > 0) {
-    _preferences->putString("address", _capturedSignal.address);
-    _preferences->putString("key", _capturedSignal.key);
+  if (_hasCapturedSignal) {
+    // 完整信号码（十六进制）+ 位数；旧版的"address"/"key"只能保存32位信号码，不再写入
+    char hex[RF_SIGNAL_HEX_LEN + 1];
+    _capturedSignal.toHex(hex);
+    _preferences->putString("code", hex);
+    _preferences->putUChar("bits", _capturedSignal.bits());
+    _preferences->remove("address");
+    _preferences->remove("key");
     _preferences->putBool("captured", true);
     _preferences->end();
     return true;
   } else {
+    _preferences->remove("code");
+    _preferences->remove("bits");
     _preferences->remove("address");
     _preferences->remove("key");
     _preferences->putBool("captured", false);
@@ -437,9 +1251,21 @@ bool ESP433RF::loadFromFlash() {
   _preferences->begin(_flashNamespace.c_str(), true);
   bool saved = _preferences->getBool("captured", false);
   if (saved) {
-    _capturedSignal.address = _preferences->getString("address", "");
-    _capturedSignal.key = _preferences->getString("key", "");
-    if (_capturedSignal.address.length() > 0 && _capturedSignal.key.length() > 0) {
+    char code[RF_SIGNAL_HEX_LEN + 1] = "";
+    char address[8] = "";
+    char key[4] = "";
+    bool valid;
+    if (_preferences->isKey("code")) {
+      _preferences->getString("code", code, sizeof(code));
+      valid = RFSignal::fromHex(code, _capturedSignal) &&
+              _capturedSignal.setBitLength(_preferences->getUChar("bits", _capturedSignal.bitLength));
+    } else {
+      // 旧版格式
+      _preferences->getString("address", address, sizeof(address));
+      _preferences->getString("key", key, sizeof(key));
+      valid = RFSignal::fromHex(address, key, _capturedSignal);
+    }
+    if (valid) {
       _hasCapturedSignal = true;
       _preferences->end();
       return true;
@@ -455,6 +1281,8 @@ void ESP433RF::clearFlash() {
     return;
   }
   _preferences->begin(_flashNamespace.c_str(), false);
+  _preferences->remove("code");
+  _preferences->remove("bits");
   _preferences->remove("address");
   _preferences->remove("key");
   _preferences->putBool("captured", false);
@@ -465,14 +1293,343 @@ void ESP433RF::clearFlash() {
 // Receive control functions
 void ESP433RF::enableReceive() {
   _receiveEnabled = true;
-  Serial.println("[ESP433RF] 接收已启用");
+  RF_LOGI("ESP433RF", "接收已启用");
 }
 
 void ESP433RF::disableReceive() {
   _receiveEnabled = false;
-  Serial.println("[ESP433RF] 接收已禁用");
+  RF_LOGI("ESP433RF", "接收已禁用");
 }
 
 bool ESP433RF::isReceiving() {
   return _receiveEnabled;
 }
+
+// ========== Event-Driven Receive (ESP32 only) ==========
+
+#ifdef ESP32
+bool ESP433RF::enableEventReceive(UBaseType_t priority, uint32_t stackSize) {
+  if (_eventTask != nullptr) {
+    return true;
+  }
+  
+  // UART交给IDF驱动管理（带事件队列），不再经过HardwareSerial
+  _serial->end();
+  
+  uart_config_t config = {};
+  config.baud_rate = _baudRate;
+  config.data_bits = UART_DATA_8_BITS;
+  config.parity = UART_PARITY_DISABLE;
+  config.stop_bits = UART_STOP_BITS_1;
+  config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  config.source_clk = UART_SCLK_APB;
+  
+  if (uart_driver_install(_uartNum, RF_UART_RX_BUFFER_SIZE, 0, RF_UART_EVENT_QUEUE_SIZE, &_uartQueue, 0) != ESP_OK) {
+    RF_LOGE("ESP433RF", "UART驱动安装失败");
+    _serial->begin(_baudRate, SERIAL_8N1, _rxPin, -1);
+    return false;
+  }
+  uart_param_config(_uartNum, &config);
+  uart_set_pin(_uartNum, UART_PIN_NO_CHANGE, _rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+  
+  // 换行符模式检测：每收到一个'\n'产生一次UART_PATTERN_DET事件
+  uart_enable_pattern_det_baud_intr(_uartNum, '\n', 1, 9, 0, 0);
+  uart_pattern_queue_reset(_uartNum, RF_UART_EVENT_QUEUE_SIZE);
+  
+  _lineLength = 0;
+  _lineState = LINE_IDLE;
+  
+  if (xTaskCreate(eventTaskEntry, "RFEventRx", stackSize, this, priority, &_eventTask) != pdPASS) {
+    _eventTask = nullptr;
+    uart_driver_delete(_uartNum);
+    _uartQueue = nullptr;
+    _serial->begin(_baudRate, SERIAL_8N1, _rxPin, -1);
+    RF_LOGE("ESP433RF", "接收任务创建失败");
+    return false;
+  }
+  
+  RF_LOGI("ESP433RF", "事件驱动接收已启用");
+  return true;
+}
+
+void ESP433RF::disableEventReceive() {
+  if (_eventTask == nullptr) {
+    return;
+  }
+  vTaskDelete(_eventTask);
+  _eventTask = nullptr;
+  uart_driver_delete(_uartNum);
+  _uartQueue = nullptr;
+  
+  // 恢复HardwareSerial轮询接收
+  _serial->begin(_baudRate, SERIAL_8N1, _rxPin, -1);
+  RF_LOGI("ESP433RF", "事件驱动接收已禁用");
+}
+
+void ESP433RF::eventTaskEntry(void* arg) {
+  static_cast<ESP433RF*>(arg)->eventLoop();
+}
+
+void ESP433RF::eventLoop() {
+  uart_event_t event;
+  uint8_t chunk[32];
+  RFSignal signal;
+  
+  while (true) {
+    // 有未结束的按键时限时等待，没有新帧到达也能按时结束按键
+    TickType_t wait = _openPresses > 0 ? pdMS_TO_TICKS(_dedupWindowMs) + 1 : portMAX_DELAY;
+    if (xQueueReceive(_uartQueue, &event, wait) != pdTRUE) {
+      expirePresses(millis());
+      continue;
+    }
+    
+    switch (event.type) {
+      case UART_PATTERN_DET: {
+        // 读取到换行符为止（含换行符），不完整的行留在驱动缓冲区
+        int pos = uart_pattern_pop_pos(_uartNum);
+        if (pos < 0) {
+          // 模式位置队列已满，位置丢失：丢弃缓冲数据重新同步
+          uart_flush_input(_uartNum);
+          _lineState = LINE_IDLE;
+          break;
+        }
+        size_t remaining = (size_t)pos + 1;
+        while (remaining > 0) {
+          int n = uart_read_bytes(_uartNum, chunk, remaining < sizeof(chunk) ? remaining : sizeof(chunk), pdMS_TO_TICKS(20));
+          if (n <= 0) {
+            break;
+          }
+          remaining -= n;
+          if (!_receiveEnabled) {
+            _lineState = LINE_IDLE;
+            continue;  // 接收被禁用：丢弃数据
+          }
+          for (int i = 0; i < n; i++) {
+            if (feedByte((char)chunk[i], signal)) {
+              handleSignal(signal);
+            }
+          }
+        }
+        break;
+      }
+      
+      case UART_FIFO_OVF:
+      case UART_BUFFER_FULL:
+        // 溢出：清空缓冲区和事件队列，重新同步行边界
+        uart_flush_input(_uartNum);
+        xQueueReset(_uartQueue);
+        uart_pattern_queue_reset(_uartNum, RF_UART_EVENT_QUEUE_SIZE);
+        _lineState = LINE_IDLE;
+        break;
+        
+      default:
+        // UART_DATA等事件：等待完整一行（换行符事件）再处理
+        break;
+    }
+  }
+}
+
+bool ESP433RF::enableRawReceive(UBaseType_t priority, uint32_t stackSize) {
+  if (_rawTask != nullptr) {
+    return true;
+  }
+  
+  // 引脚交给GPIO中断，不再作为UART接收
+  if (_eventTask != nullptr) {
+    disableEventReceive();
+  }
+  _serial->end();
+  pinMode(_rxPin, INPUT);
+  
+  _decoder.reset();
+  _rawTail = _rawHead;
+  _rawLastEdge = micros();
+  
+  if (xTaskCreate(rawTaskEntry, "RFRawRx", stackSize, this, priority, &_rawTask) != pdPASS) {
+    _rawTask = nullptr;
+    _serial->begin(_baudRate, SERIAL_8N1, _rxPin, -1);
+    RF_LOGE("ESP433RF", "解码任务创建失败");
+    return false;
+  }
+  attachInterruptArg(digitalPinToInterrupt(_rxPin), rawEdgeISR, this, CHANGE);
+  
+  RF_LOGI("ESP433RF", "原始脉冲接收已启用");
+  return true;
+}
+
+void ESP433RF::disableRawReceive() {
+  if (_rawTask == nullptr) {
+    return;
+  }
+  detachInterrupt(digitalPinToInterrupt(_rxPin));
+  vTaskDelete(_rawTask);
+  _rawTask = nullptr;
+  
+  // 恢复HardwareSerial轮询接收
+  _serial->begin(_baudRate, SERIAL_8N1, _rxPin, -1);
+  RF_LOGI("ESP433RF", "原始脉冲接收已禁用");
+}
+
+// 每个电平跳变记录刚结束的一段电平（时长 | 电平），长低电平（可能是同步间隔）时唤醒解码任务
+void IRAM_ATTR ESP433RF::rawEdgeISR(void* arg) {
+  ESP433RF* self = static_cast<ESP433RF*>(arg);
+  uint32_t now = micros();
+  uint32_t duration = now - self->_rawLastEdge;
+  self->_rawLastEdge = now;
+  
+  uint16_t pulse = duration > RF_PULSE_MAX_DURATION ? RF_PULSE_MAX_DURATION : duration;
+  bool endedHigh = digitalRead(self->_rxPin) == LOW;  // 当前是新电平
+  if (endedHigh) {
+    pulse |= RF_RAW_LEVEL_HIGH;
+  }
+  
+  uint32_t head = self->_rawHead;
+  if (head - self->_rawTail >= RF_RAW_PULSE_QUEUE_SIZE) {
+    self->_rawDropped++;
+    return;
+  }
+  self->_rawPulses[head & (RF_RAW_PULSE_QUEUE_SIZE - 1)] = pulse;
+  self->_rawHead = head + 1;
+  
+  if (!endedHigh && duration >= RF_DECODER_MIN_GAP_US) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(self->_rawTask, &woken);
+    if (woken == pdTRUE) {
+      portYIELD_FROM_ISR();
+    }
+  }
+}
+
+void ESP433RF::rawTaskEntry(void* arg) {
+  static_cast<ESP433RF*>(arg)->rawLoop();
+}
+
+void ESP433RF::rawLoop() {
+  RFDecodedFrame frame;
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RF_RAW_POLL_MS));
+    
+    while (_rawTail != _rawHead) {
+      uint16_t pulse = _rawPulses[_rawTail & (RF_RAW_PULSE_QUEUE_SIZE - 1)];
+      _rawTail = _rawTail + 1;
+      if (_rawCaptureState.load() != RAW_CAPTURE_IDLE) {
+        captureRawPulse(pulse);
+      }
+      if (!_decoder.feed(pulse, frame)) {
+        continue;
+      }
+      _rawDecoded++;
+      if (!_receiveEnabled) {
+        continue;
+      }
+      // 保留解码出的位数，发送时原样发送
+      RFSignal signal = RFSignal();
+      signal.code = frame.code;
+      signal.bitLength = frame.bitLength;
+      signal.protocol = frame.protocol;
+      signal.pulseLength = frame.pulseLength;
+      handleSignal(signal);
+    }
+    
+    // 接收模块静默（没有跳变）时结束录制，最后一段电平还没有结束，不会进入队列
+    if (_rawCaptureState.load() == RAW_CAPTURE_RECORDING &&
+        micros() - _rawLastEdge >= RF_RAW_CAPTURE_IDLE_MS * 1000UL) {
+      finishRawCapture();
+    }
+    
+    // 没有新帧时按时结束按键
+    expirePresses(millis());
+  }
+}
+
+// ========== Raw Capture ==========
+
+bool ESP433RF::enableRawCapture(uint16_t maxPulses, uint16_t maxMs) {
+  if (_rawTask == nullptr) {
+    RF_LOGW("ESP433RF", "原始波形捕获需要先启用原始脉冲接收");
+    return false;
+  }
+  if (_capturePulses == nullptr) {
+    // 录制缓冲区和编码结果放在同一块内存中，首次捕获时分配，end()时释放
+    _capturePulses = (uint16_t*)malloc(sizeof(uint16_t) * RF_RAW_TRACE_MAX_PULSES + RF_RAW_TRACE_MAX_BYTES);
+    if (_capturePulses == nullptr) {
+      return false;
+    }
+    _capturedTrace = (uint8_t*)(_capturePulses + RF_RAW_TRACE_MAX_PULSES);
+  }
+  
+  // 先回到空闲再修改参数，解码任务不会用到一半新一半旧的设置
+  _rawCaptureState = RAW_CAPTURE_IDLE;
+  _captureMaxPulses = maxPulses > RF_RAW_TRACE_MAX_PULSES ? RF_RAW_TRACE_MAX_PULSES : maxPulses;
+  _captureMaxUs = (uint32_t)maxMs * 1000;
+  _capturedTraceLength = 0;
+  _rawCaptureState = RAW_CAPTURE_ARMED;
+  RF_LOGI("ESP433RF", "原始波形捕获已启用，请按下遥控器按键");
+  return true;
+}
+
+void ESP433RF::disableRawCapture() {
+  uint8_t state = _rawCaptureState.load();
+  if (state == RAW_CAPTURE_ARMED || state == RAW_CAPTURE_RECORDING) {
+    _rawCaptureState.compare_exchange_strong(state, RAW_CAPTURE_IDLE);
+  }
+}
+#endif
+
+bool ESP433RF::isRawCapture() {
+  uint8_t state = _rawCaptureState.load();
+  return state == RAW_CAPTURE_ARMED || state == RAW_CAPTURE_RECORDING;
+}
+
+bool ESP433RF::hasCapturedTrace() {
+  return _rawCaptureState.load() == RAW_CAPTURE_DONE;
+}
+
+uint16_t ESP433RF::getCapturedTrace(uint8_t* trace, uint16_t maxBytes) {
+  if (!hasCapturedTrace() || trace == nullptr || _capturedTraceLength > maxBytes) {
+    return 0;
+  }
+  memcpy(trace, _capturedTrace, _capturedTraceLength);
+  return _capturedTraceLength;
+}
+
+void ESP433RF::clearCapturedTrace() {
+  uint8_t state = RAW_CAPTURE_DONE;
+  _rawCaptureState.compare_exchange_strong(state, RAW_CAPTURE_IDLE);
+}
+
+// 解码任务中调用：分隔符（长低电平）之后开始录制，录到上限后编码
+void ESP433RF::captureRawPulse(uint16_t pulse) {
+  uint8_t state = _rawCaptureState.load();
+  if (state == RAW_CAPTURE_ARMED) {
+    if ((pulse & RF_RAW_LEVEL_HIGH) == 0 && (pulse & RF_RAW_DURATION_MASK) >= RF_DECODER_MIN_GAP_US) {
+      _captureCount = 0;
+      _captureUs = 0;
+      _rawCaptureState.compare_exchange_strong(state, RAW_CAPTURE_RECORDING);
+    }
+    return;
+  }
+  if (state != RAW_CAPTURE_RECORDING) {
+    return;
+  }
+  
+  _capturePulses[_captureCount++] = pulse;
+  _captureUs += pulse & RF_RAW_DURATION_MASK;
+  if (_captureCount >= _captureMaxPulses || _captureUs >= _captureMaxUs) {
+    finishRawCapture();
+  }
+}
+
+void ESP433RF::finishRawCapture() {
+  uint16_t length = rfRawTraceEncode(_capturePulses, _captureCount, _capturedTrace, RF_RAW_TRACE_MAX_BYTES);
+  uint8_t state = RAW_CAPTURE_RECORDING;
+  if (length == 0) {
+    // 太短（噪声）：等待下一个分隔符重新录制
+    _rawCaptureState.compare_exchange_strong(state, RAW_CAPTURE_ARMED);
+    return;
+  }
+  _capturedTraceLength = length;
+  if (_rawCaptureState.compare_exchange_strong(state, RAW_CAPTURE_DONE)) {
+    RF_LOGI("ESP433RF", "原始波形已捕获：%u个脉冲，编码后%u字节", _captureCount, length);
+  }
+}
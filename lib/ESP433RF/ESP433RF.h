@@ -17,6 +17,7 @@
 
 #include <Arduino.h>
 #include <HardwareSerial.h>
+#include <atomic>
 
 // This library requires RCSwitch - auto-define if not already defined
 #ifndef USE_RCSWITCH
@@ -24,16 +25,135 @@
 #endif
 
 #include <RCSwitch.h>
+#include "RFSignalQueue.h"
+#include "RFPersistence.h"
+#include "RFProtocol.h"
+#include "RFDecoder.h"
+#include "RFRawTrace.h"
+#include "RFMetrics.h"
+#include "RFLog.h"
 
-// ESP32 Preferences for flash storage
+// ESP32 Preferences for flash storage, UART driver for event-driven receive
 #ifdef ESP32
 #include <Preferences.h>
+#include <driver/uart.h>
+#include <driver/rmt.h>
 #endif
 
-// Signal structure
+// Hex digits of a receiver module code (6-digit address + 2-digit key)
+#define RF_SIGNAL_MODULE_HEX_LEN 8
+
+// Longest hex form of a signal code (64 bits); toHex() buffers hold RF_SIGNAL_HEX_LEN + 1 chars
+#define RF_SIGNAL_HEX_LEN 16
+
+// Code bits of a signal without an explicit bit length (receiver module output: 24-bit address + 8-bit key)
+#define RF_SIGNAL_DEFAULT_BITS 32
+#define RF_SIGNAL_MAX_BITS 64
+
+// Longest code RCSwitch can send; longer codes are encoded and sent by pin toggling
+#define RF_RCSWITCH_MAX_BITS 32
+
+// Receiver module line buffer ("LC:XXXXXXYY" plus slack for other output)
+#define RF_LINE_BUFFER_SIZE 64
+
+// Decoded frames buffered between receive task and dispatcher task (power of two)
+#define RF_RECEIVE_QUEUE_SIZE 32
+
+// Event-driven receive (UART driver buffer and event queue sizes)
+#define RF_UART_RX_BUFFER_SIZE 512
+#define RF_UART_EVENT_QUEUE_SIZE 16
+
+// Async transmit: pending send requests, receiver hold-off after a paused send
+#define RF_TX_QUEUE_SIZE 16
+#define RF_TX_RECEIVE_HOLDOFF_MS 200
+
+// Raw receive: pulses buffered between GPIO interrupt and decoder task (power of two),
+// decoder task poll interval (also ends presses when no pulses arrive)
+#define RF_RAW_PULSE_QUEUE_SIZE 1024
+#define RF_RAW_POLL_MS 20
+
+// Raw capture: longest recording, recording ends early when no edge arrives for this long
+#define RF_RAW_CAPTURE_MAX_MS 500
+#define RF_RAW_CAPTURE_IDLE_MS 50
+
+// Repeat-frame deduplication: frames of the same code closer than the window
+// belong to one press; number of presses tracked at the same time
+#define RF_DEDUP_WINDOW_MS 150
+#define RF_PRESS_TRACK_SIZE 8
+
+// Echo filter: recently sent codes tracked, default window after a send ends,
+// upper bound for one transmission while it is in progress
+#define RF_ECHO_FILTER_SIZE 8
+#define RF_ECHO_WINDOW_MS 200
+#define RF_ECHO_TX_MAX_MS 5000
+
+// Most signals in one batch send (one queue entry regardless of the item count)
+#define RF_TX_BATCH_MAX 64
+
+// Largest precomputed waveform (items; 1 item = 1 bit or sync pulse)
+#define RF_WAVEFORM_MAX_ITEMS 256
+
+// Transmit backend
+enum RFTxBackend : uint8_t {
+  RF_TX_RCSWITCH,  // RCSwitch bit-bang (busy-wait on a CPU core)
+  RF_TX_RMT        // RMT peripheral (hardware timing, CPU free while sending, ESP32 only)
+};
+
+// Send request flags
+#define RF_TX_PAUSE_RECEIVE 0x01  // 发送期间暂停接收，避免收到自己发送的信号
+#define RF_TX_SUPPRESS_ECHO 0x02  // 发送期间继续接收，只丢弃与发送的信号码相同的帧（回声）
+
+// Signal structure (fixed-size POD, no heap allocation)
 struct RFSignal {
-  String address;  // 6-digit hex address code
-  String key;      // 2-digit hex key value
+  uint64_t code;         // Code bits as sent, last bit in bit 0 (module codes: address (24 bit) << 8 | key (8 bit))
+  uint8_t bitLength;     // Bits on air (0 = RF_SIGNAL_DEFAULT_BITS)
+  uint8_t protocol;      // RCSwitch protocol (0 = use ESP433RF setting)
+  uint16_t pulseLength;  // Pulse length in us (0 = use ESP433RF setting)
+  
+  uint8_t bits() const { return bitLength != 0 ? bitLength : RF_SIGNAL_DEFAULT_BITS; }
+  uint32_t address() const { return (uint32_t)(code >> 8); }  // Module codes: 6-digit hex address code
+  uint8_t key() const { return code & 0xFF; }                 // Module codes: 2-digit hex key value
+  bool sameCode(const RFSignal& other) const { return code == other.code && bits() == other.bits(); }
+  
+  // 32-bit digest of code and bit length (hash index, echo filter); same code, same digest
+  uint32_t digest() const { return (uint32_t)code ^ (uint32_t)(code >> 32) * 0x9E3779B1u ^ bits(); }
+  
+  // Hex conversion, only used at the edges (serial log, JSON, web API, flash)
+  void toHex(char* out) const;  // (bits + 3) / 4 digits, out must hold RF_SIGNAL_HEX_LEN + 1 chars
+  static bool fromHex(const char* hex, RFSignal& signal);  // 1-16 digits, 4 bits per digit
+  static bool fromHex(const char* address, const char* key, RFSignal& signal);
+  // Exact bit length after fromHex() (hex gives multiples of 4), false when the code does not fit
+  bool setBitLength(uint8_t bits);
+};
+
+// Send handle: increases per accepted request, 0 = rejected (transmit queue full)
+typedef uint32_t RFTxHandle;
+
+// One signal of a batch send (scene)
+struct RFTxItem {
+  RFSignal signal;
+  RFWaveform* waveform;  // Precomputed waveform or nullptr (sendBatch() takes its own reference)
+  uint8_t repeats;       // Code repetitions on air (0 = setRepeatCount() setting)
+  uint16_t gapMs;        // Pause before the next item
+};
+
+// Send request as queued to the transmitter task
+struct RFTxRequest {
+  RFSignal signal;
+  RFWaveform* waveform;  // Precomputed waveform (one reference held by the request) or nullptr
+  RFTxItem* batch;       // Batch items (heap block owned by the request), nullptr for a single signal
+  uint8_t batchCount;
+  uint8_t flags;         // RF_TX_* flags
+  RFTxHandle handle;
+  uint32_t queuedUs;     // micros() when submitted (queue wait metric)
+};
+
+// Received frame or finished press as published to the dispatcher queue
+struct RFReceiveEvent {
+  RFSignal signal;
+  uint32_t timestamp;  // micros() when the frame was parsed / the press ended
+  uint16_t frames;     // 0 = new frame (press start), otherwise a finished press with this many frames
+  uint32_t holdMs;     // Finished press: time from first to last frame
 };
 
 class ESP433RF {
@@ -48,26 +168,99 @@ public:
   // Receive functions
   bool receiveAvailable();
   bool receive(RFSignal &signal);
-  bool parseSignal(String data, RFSignal &signal);
+  bool parseSignal(const char* data, size_t length, RFSignal &signal);
   
   // Send functions
-  void send(String address, String key);
-  void send(RFSignal signal);
+  // 启动发送任务后只入队并立即返回句柄（队列满返回0）；未启动时在调用者中同步发送
+  RFTxHandle send(uint32_t address, uint8_t key);
+  RFTxHandle send(const RFSignal& signal, uint8_t flags = 0);
+  bool isSendComplete(RFTxHandle handle);
+  
+  // Precomputed waveforms (预编码波形，由调用者缓存，发送时直接回放)
+  // encodeWaveform按当前协议/脉宽/重复次数编码，调用者持有一个引用
+  // 设置变化后isWaveformCurrent返回false，需要重新编码
+  // repeats不为0时覆盖重复次数设置
+  RFWaveform* encodeWaveform(const RFSignal& signal, uint8_t repeats = 0);
+  bool isWaveformCurrent(const RFWaveform* waveform, const RFSignal& signal, uint8_t repeats = 0);
+  RFTxHandle sendWaveform(const RFSignal& signal, RFWaveform* waveform, uint8_t flags = 0);
+  
+  // Raw trace send (原始波形发送)
+  // 按录制的时序原样回放（见RFRawTrace.h），不受协议/脉宽/重复次数设置影响
+  // 原始波形的信号为protocol = RF_PROTOCOL_RAW、code = 内容哈希，没有波形时无法发送
+  RFWaveform* encodeRawWaveform(const uint8_t* trace, uint16_t length);
+  RFTxHandle sendRaw(const uint8_t* trace, uint16_t length, uint8_t flags = 0);
+  
+  // Batch send (场景批量发送)
+  // 所有信号作为一个请求依次发送，只暂停/恢复一次接收；每项可指定重复次数和发送后的间隔
+  // 返回整批的句柄（整批发送完成后isSendComplete返回true），发送回调对每项各调用一次
+  RFTxHandle sendBatch(const RFTxItem* items, uint8_t count, uint8_t flags = 0);
+  
+  // Send completion callback (runs in the transmitter task, or in the caller when sending synchronously)
+  typedef void (*TransmitCallback)(RFTxHandle handle, const RFSignal& signal);
+  void setTransmitCallback(TransmitCallback callback);
+  
+  // Transmitter task (发送任务，仅ESP32)
+  // 发送是忙等位操作（5次重复约300ms），放到独立任务中，Web服务器和按钮任务不再被阻塞
+  #ifdef ESP32
+  bool startTransmitter(UBaseType_t priority = 3, uint32_t stackSize = 4096);
+  void stopTransmitter();
+  bool isTransmitterRunning() { return _txTask != nullptr; }
+  #endif
+  uint32_t getTxQueueDepth();
+  uint32_t getTxQueueHighWater() { return _txHighWater; }
+  uint32_t getTxQueueDropped() { return _txDropped; }
+  
+  // Echo filter (回声过滤，用于RF_TX_SUPPRESS_ECHO发送)
+  // 发送开始到发送结束后windowMs内，接收到的相同信号码视为自己的回声并丢弃，其他信号照常接收
+  void setEchoWindow(uint16_t windowMs) { _echoWindowMs = windowMs; }
+  uint32_t getEchoSuppressed() { return _echoSuppressed; }
+  
+  // Transmit backend (发送后端)
+  // RMT：脉冲序列按信号预先编码一次，由硬件输出，不受WiFi中断抢占影响
+  // 应在发送空闲时切换（begin()之前或发送任务启动之前）
+  bool setTxBackend(RFTxBackend backend, uint8_t rmtChannel = 0);
+  RFTxBackend getTxBackend() { return _txBackend; }
   
-  // Configuration (RCSwitch only)
+  // Configuration (RCSwitch and RMT)
   void setRepeatCount(uint8_t count);
   void setProtocol(uint8_t protocol);
   void setPulseLength(uint16_t pulseLength);
+  uint8_t getRepeatCount() { return _repeatCount; }
+  uint8_t getProtocol() { return _protocol; }
+  uint16_t getPulseLength() { return _pulseLength; }
   
   // Status
   uint32_t getSendCount() { return _sendCount; }
-  uint32_t getReceiveCount() { return _receiveCount; }
+  uint32_t getReceiveCount() { return _receiveCount; }  // Presses (frames when dedup is off)
+  uint32_t getFrameCount() { return _frameCount; }      // All decoded frames
   void resetCounters();
   
   // Callback support
-  typedef void (*ReceiveCallback)(RFSignal signal);
+  // 未启动分发任务时回调在接收路径中同步执行；启动后在分发任务中执行
+  typedef void (*ReceiveCallback)(const RFSignal& signal);
   void setReceiveCallback(ReceiveCallback callback);
   
+  // Repeat-frame deduplication (按键去重)
+  // 遥控器一次按键会重复发送多帧：同一信号码间隔小于windowMs的帧合并为一次按键，
+  // 只有第一帧进入接收回调、计数、复刻缓冲区和捕获模式；
+  // 按键结束（windowMs内没有新帧）后以帧数和按住时长调用按键回调。windowMs为0时关闭
+  // 轮询模式下receive()只对新按键返回true，按键在receive()调用时结束
+  typedef void (*PressCallback)(const RFSignal& signal, uint16_t frames, uint32_t holdMs);
+  void setPressCallback(PressCallback callback);
+  void setDedupWindow(uint16_t windowMs);
+  uint16_t getDedupWindow() { return _dedupWindowMs; }
+  
+  // Dispatcher task (分发任务，仅ESP32)
+  // 接收路径只把解码帧放入无锁队列，回调由独立任务执行，慢速消费者不再阻塞UART读取
+  #ifdef ESP32
+  bool startDispatcher(UBaseType_t priority = 1, uint32_t stackSize = 4096);
+  void stopDispatcher();
+  bool isDispatching() { return _dispatchTask != nullptr; }
+  #endif
+  uint32_t getQueueDepth() { return _receiveQueue.size(); }
+  uint32_t getQueueHighWater() { return _receiveQueue.highWater(); }
+  uint32_t getQueueDropped() { return _receiveQueue.dropped(); }
+  
   // Replay buffer functions (信号历史记录)
   void enableReplayBuffer(uint8_t size = 10);  // 启用复刻缓冲区
   void disableReplayBuffer();  // 禁用复刻缓冲区
@@ -89,6 +282,41 @@ public:
   void disableReceive();  // 禁用接收
   bool isReceiving();  // 是否正在接收
   
+  // Event-driven receive (事件驱动接收，仅ESP32)
+  // 由UART换行符模式中断唤醒接收任务，收到完整一行才处理，替代轮询receive()
+  // 回调在接收任务中执行；启用后receive()/receiveAvailable()不再返回数据
+  #ifdef ESP32
+  bool enableEventReceive(UBaseType_t priority = 2, uint32_t stackSize = 4096);
+  void disableEventReceive();
+  bool isEventReceive() { return _eventTask != nullptr; }
+  #endif
+  
+  // Raw receive (原始脉冲接收，仅ESP32)
+  // 接收引脚接普通OOK接收模块（无解码芯片）：GPIO中断记录每段电平的时长，
+  // 解码任务按协议表软件解码全部12种协议，不经过接收模块的串口输出和解码延迟
+  // 与串口接收互斥：启用时关闭串口/事件驱动接收，禁用后恢复串口轮询接收
+  // 输出8到64位的码（RF_DECODER_MIN_BITS..RF_DECODER_MAX_BITS），保留解码出的位数和协议，发送时原样发送
+  #ifdef ESP32
+  bool enableRawReceive(UBaseType_t priority = 2, uint32_t stackSize = 4096);
+  void disableRawReceive();
+  bool isRawReceive() { return _rawTask != nullptr; }
+  #endif
+  uint32_t getRawPulseDropped() { return _rawDropped; }
+  uint32_t getRawDecodedCount() { return _rawDecoded; }
+  
+  // Raw capture (原始波形捕获，仅ESP32，需要先启用原始脉冲接收)
+  // 解码器无法识别的信号（滚动码、未知的固定码协议）按脉冲时序录制：从下一个分隔符（长低电平）
+  // 之后开始，录满maxPulses个脉冲、maxMs毫秒或RF_RAW_CAPTURE_IDLE_MS内没有跳变时结束，
+  // 压缩编码后可用getCapturedTrace()取出并存入SignalManager；录制期间解码照常进行
+  #ifdef ESP32
+  bool enableRawCapture(uint16_t maxPulses = RF_RAW_TRACE_MAX_PULSES, uint16_t maxMs = RF_RAW_CAPTURE_MAX_MS);
+  void disableRawCapture();
+  #endif
+  bool isRawCapture();  // 等待或正在录制
+  bool hasCapturedTrace();
+  uint16_t getCapturedTrace(uint8_t* trace, uint16_t maxBytes);  // 返回编码后的字节数，没有或放不下时返回0
+  void clearCapturedTrace();
+  
   // Flash persistence functions (闪存持久化，仅ESP32)
   #ifdef ESP32
   void enableFlashStorage(const char* namespace_name = "rf_replay");  // 启用闪存存储
@@ -96,6 +324,8 @@ public:
   bool saveToFlash();  // 保存捕获的信号到闪存
   bool loadFromFlash();  // 从闪存加载信号
   void clearFlash();  // 清空闪存
+  // 设置后捕获状态交给持久化任务延迟写入，不再在接收路径中同步写闪存
+  void setPersistence(RFPersistence* persistence);
   #endif
   
 private:
@@ -115,12 +345,67 @@ private:
   uint8_t _protocol;
   uint16_t _pulseLength;
   
+  // Transmit backend
+  RFTxBackend _txBackend;
+  #ifdef ESP32
+  rmt_channel_t _rmtChannel;
+  bool _rmtInstalled;
+  RFWaveform* _rmtWaveform;   // Last signal sent without a precomputed waveform
+  #endif
+  
   // Statistics
   uint32_t _sendCount;
   uint32_t _receiveCount;
   
+  uint32_t _frameCount;
+  
   // Callback
   ReceiveCallback _receiveCallback;
+  TransmitCallback _transmitCallback;
+  PressCallback _pressCallback;
+  
+  // Press tracking (owned by the receive path)
+  struct PressEntry {
+    RFSignal signal;
+    uint32_t first;   // millis() of the first frame
+    uint32_t last;    // millis() of the latest frame
+    uint16_t frames;  // 0 = unused
+  };
+  PressEntry _presses[RF_PRESS_TRACK_SIZE];
+  uint8_t _openPresses;
+  volatile uint16_t _dedupWindowMs;
+  
+  // Transmit queue (producers: any task, consumer: transmitter task)
+  volatile RFTxHandle _txNextHandle;   // Last handle handed out
+  volatile RFTxHandle _txCompleted;    // Last handle transmitted
+  uint32_t _txHighWater;
+  uint32_t _txDropped;
+  
+  // Echo filter (writer: transmitter, reader: receive path)
+  struct EchoEntry {
+    std::atomic<uint32_t> digest;  // RFSignal::digest()
+    std::atomic<uint32_t> until;  // millis() deadline, 0 = unused
+  };
+  EchoEntry _echo[RF_ECHO_FILTER_SIZE];
+  uint8_t _echoNext;
+  uint16_t _echoWindowMs;
+  volatile uint32_t _echoSuppressed;
+  #ifdef ESP32
+  QueueHandle_t _txQueue;
+  SemaphoreHandle_t _txMutex;  // Keeps handle order equal to queue order
+  TaskHandle_t _txTask;
+  static void txTaskEntry(void* arg);
+  void txLoop();
+  void discardTxQueue();
+  #endif
+  
+  // Receive queue (producer: receive path, consumer: dispatcher task)
+  RFSignalQueue<RFReceiveEvent, RF_RECEIVE_QUEUE_SIZE> _receiveQueue;
+  #ifdef ESP32
+  TaskHandle_t _dispatchTask;
+  static void dispatchTaskEntry(void* arg);
+  void dispatchLoop();
+  #endif
   
   // Replay buffer
   bool _replayBufferEnabled;
@@ -136,20 +421,96 @@ private:
   bool _hasCapturedSignal;
   
   // Receive control
-  bool _receiveEnabled;
+  volatile bool _receiveEnabled;
+  
+  // Event-driven receive (ESP32 only)
+  #ifdef ESP32
+  uart_port_t _uartNum;
+  QueueHandle_t _uartQueue;
+  TaskHandle_t _eventTask;
+  static void eventTaskEntry(void* arg);
+  void eventLoop();
+  #endif
+  
+  // Raw receive (producer: GPIO interrupt, consumer: decoder task)
+  // Plain ring instead of RFSignalQueue: everything the interrupt touches must stay in IRAM
+  uint16_t _rawPulses[RF_RAW_PULSE_QUEUE_SIZE];
+  volatile uint32_t _rawHead;
+  volatile uint32_t _rawTail;
+  volatile uint32_t _rawLastEdge;
+  volatile uint32_t _rawDropped;
+  uint32_t _rawDecoded;
+  RFDecoder _decoder;
+  
+  // Raw capture (armed by the API, recorded and encoded by the decoder task)
+  enum RawCaptureState : uint8_t {
+    RAW_CAPTURE_IDLE,
+    RAW_CAPTURE_ARMED,      // 等待分隔符
+    RAW_CAPTURE_RECORDING,
+    RAW_CAPTURE_DONE        // _capturedTrace有效
+  };
+  std::atomic<uint8_t> _rawCaptureState;
+  uint16_t* _capturePulses;      // RF_RAW_TRACE_MAX_PULSES, allocated on first capture
+  uint8_t* _capturedTrace;       // RF_RAW_TRACE_MAX_BYTES, same block
+  uint16_t _capturedTraceLength;
+  uint16_t _captureCount;
+  uint16_t _captureMaxPulses;
+  uint32_t _captureUs;
+  uint32_t _captureMaxUs;
+  void captureRawPulse(uint16_t pulse);
+  void finishRawCapture();
+  #ifdef ESP32
+  TaskHandle_t _rawTask;
+  static void rawEdgeISR(void* arg);
+  static void rawTaskEntry(void* arg);
+  void rawLoop();
+  #endif
+  
+  // Line parser state (owned by the instance, no heap allocation)
+  enum LineState : uint8_t {
+    LINE_IDLE,      // 等待行首（跳过空白和换行）
+    LINE_DATA,      // 正在接收一行
+    LINE_OVERFLOW   // 行过长，丢弃直到行尾
+  };
+  char _lineBuffer[RF_LINE_BUFFER_SIZE];
+  uint8_t _lineLength;
+  LineState _lineState;
   
   // Flash storage (ESP32 only)
   #ifdef ESP32
   bool _flashStorageEnabled;
   Preferences* _preferences;
   String _flashNamespace;
+  RFPersistence* _persistence;
+  int8_t _persistClient;
+  static bool persistFlush(void* context);
   #endif
   
   // Internal functions
-  uint8_t hexToNum(char c);
-  void sendSignalRCSwitch(String address, String key);
-  void addToReplayBuffer(RFSignal signal);
-  void checkCaptureMode(RFSignal signal);
+  bool feedByte(char c, RFSignal &signal);
+  bool handleSignal(const RFSignal& signal);
+  bool trackPress(const RFSignal& signal, uint32_t now);
+  void expirePresses(uint32_t now);
+  void endPress(uint8_t slot);
+  void publishEvent(const RFReceiveEvent& event);
+  void deliverEvent(const RFReceiveEvent& event);
+  RFTxHandle nextTxHandle();
+  RFTxHandle submit(RFTxRequest& request);
+  void releaseRequest(const RFTxRequest& request);
+  uint8_t beginEcho(uint32_t digest);
+  void endEcho(uint8_t slot);
+  bool isEcho(uint32_t digest);
+  void transmit(const RFTxRequest& request);
+  void transmitSignal(const RFSignal& signal, RFWaveform* waveform, uint8_t repeats);
+  void sendSignalRCSwitch(const RFSignal& signal, uint8_t repeats);
+  void replayWaveform(const RFWaveform& waveform);
+  #ifdef ESP32
+  bool beginRMT();
+  void endRMT();
+  #endif
+  void addToReplayBuffer(const RFSignal& signal);
+  void checkCaptureMode(const RFSignal& signal);
+  void persistCapture();
 };
 
 #endif // ESP433RF_H
@@ -0,0 +1,145 @@
+/*
+ * RFDecoder - Table-driven 433MHz pulse decoder implementation
+ */
+
+#include "RFDecoder.h"
+
+RFDecoder::RFDecoder() {
+  _tolerance = RF_DECODER_TOLERANCE;
+  reset();
+}
+
+void RFDecoder::reset() {
+  _count = 0;
+  _frames = 0;
+  _hasCandidate = false;
+}
+
+bool RFDecoder::feed(uint16_t pulse, RFDecodedFrame& frame) {
+  _history[_count & (RF_DECODER_HISTORY - 1)] = pulse;
+  _count++;
+  
+  // 只有足够长的低电平才可能是同步间隔（一帧的结尾）
+  if ((pulse & RF_RAW_LEVEL_HIGH) || (pulse & RF_RAW_DURATION_MASK) < RF_DECODER_MIN_GAP_US) {
+    return false;
+  }
+  
+  // 多个协议都能解码时（如协议7近似于两倍脉宽的协议1）取时序误差最小的；
+  // 时序比例完全相同的（协议11/12只有脉宽不同）取默认脉宽最接近的；
+  // 误差相近时沿用上一次重复的协议（协议8/9的脉冲序列互为移位，只能靠前后一致区分）
+  RFDecodedFrame decoded;
+  uint32_t bestError = UINT32_MAX;
+  RFDecodedFrame previous;
+  uint32_t previousError = UINT32_MAX;
+  for (uint8_t p = 1; p <= RF_PROTOCOL_COUNT; p++) {
+    RFDecodedFrame attempt;
+    uint32_t error;
+    if (!decodeAt(p, attempt, error)) {
+      continue;
+    }
+    if (error < bestError ||
+        (error == bestError && distance(attempt.pulseLength, rfGetProtocol(p)->pulseLength) <
+                               distance(decoded.pulseLength, rfGetProtocol(decoded.protocol)->pulseLength))) {
+      decoded = attempt;
+      bestError = error;
+    }
+    if (_hasCandidate && p == _candidate.protocol) {
+      previous = attempt;
+      previousError = error;
+    }
+  }
+  if (previousError != UINT32_MAX && previousError <= bestError * 2) {
+    decoded = previous;
+  }
+  if (bestError == UINT32_MAX) {
+    return false;  // 数据位中的长低电平（如协议8）也会走到这里，不影响上一次的解码结果
+  }
+  _frames++;
+  
+  // 紧接着的下一次重复（相隔正好一帧的脉冲数）解码结果相同才输出，过滤恰好符合协议时序的噪声
+  bool confirmed = _hasCandidate &&
+                   _count - _candidateAt == (uint32_t)decoded.bitLength * 2 + 2 &&
+                   _candidate.code == decoded.code &&
+                   _candidate.bitLength == decoded.bitLength &&
+                   _candidate.protocol == decoded.protocol;
+  _candidate = decoded;
+  _candidateAt = _count;
+  _hasCandidate = true;
+  if (confirmed) {
+    frame = decoded;
+  }
+  return confirmed;
+}
+
+// 以最新的脉冲为同步长脉冲，向前逐位匹配协议的位时序
+// error返回数据位时序偏差之和（千分比，相对于总时长）
+bool RFDecoder::decodeAt(uint8_t protocolNumber, RFDecodedFrame& frame, uint32_t& error) {
+  const RFProtocol& protocol = *rfGetProtocol(protocolNumber);
+  
+  // 同步对中的长低电平：正相协议是第二段，反相协议是第一段
+  uint8_t gapUnits = protocol.inverted ? protocol.sync.high : protocol.sync.low;
+  uint32_t unit = (pulseAt(0) & RF_RAW_DURATION_MASK) / gapUnits;
+  if (unit < RF_DECODER_MIN_UNIT_US) {
+    return false;
+  }
+  
+  uint32_t available = _count < RF_DECODER_HISTORY ? _count : RF_DECODER_HISTORY;
+  uint32_t back = 1;
+  if (!protocol.inverted) {
+    // 正相：同步对的高电平在间隔之前；反相：同步对的高电平在间隔之后，尚未收到
+    if (back >= available || !matches(pulseAt(back), true, protocol.sync.high, unit)) {
+      return false;
+    }
+    back++;
+  }
+  
+  // 每位两段：正相先高后低，反相先低后高；从最后一位向前解码
+  bool firstHigh = !protocol.inverted;
+  uint64_t code = 0;
+  uint8_t bits = 0;
+  uint32_t totalUs = 0;
+  uint32_t totalUnits = 0;
+  uint32_t deviation = 0;
+  while (bits < RF_DECODER_MAX_BITS && back + 1 < available) {
+    uint16_t second = pulseAt(back);
+    uint16_t first = pulseAt(back + 1);
+    const RFPulsePair* pair;
+    if (matches(first, firstHigh, protocol.one.high, unit) && matches(second, !firstHigh, protocol.one.low, unit)) {
+      pair = &protocol.one;
+      code |= (uint64_t)1 << bits;
+    } else if (matches(first, firstHigh, protocol.zero.high, unit) && matches(second, !firstHigh, protocol.zero.low, unit)) {
+      pair = &protocol.zero;
+    } else {
+      break;
+    }
+    totalUs += (first & RF_RAW_DURATION_MASK) + (second & RF_RAW_DURATION_MASK);
+    totalUnits += pair->high + pair->low;
+    deviation += distance(first, pair->high * unit) + distance(second, pair->low * unit);
+    bits++;
+    back += 2;
+  }
+  
+  if (bits < RF_DECODER_MIN_BITS) {
+    return false;
+  }
+  frame.code = code;
+  frame.bitLength = bits;
+  frame.protocol = protocolNumber;
+  frame.pulseLength = totalUs / totalUnits;  // 按所有数据位平均，比只看同步间隔更准
+  error = (uint64_t)deviation * 1000 / totalUs;
+  return true;
+}
+
+bool RFDecoder::matches(uint16_t pulse, bool high, uint32_t units, uint32_t unit) {
+  if (((pulse & RF_RAW_LEVEL_HIGH) != 0) != high) {
+    return false;
+  }
+  // 短脉冲按脉宽的百分比，长脉冲（同步）按自身长度的1/4再乘百分比
+  uint32_t scale = units < 4 ? unit : units * unit / 4;
+  return distance(pulse, units * unit) <= scale * _tolerance / 100;
+}
+
+uint32_t RFDecoder::distance(uint16_t pulse, uint32_t expected) {
+  uint32_t duration = pulse & RF_RAW_DURATION_MASK;
+  return duration > expected ? duration - expected : expected - duration;
+}
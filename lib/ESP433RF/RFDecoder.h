@@ -0,0 +1,83 @@
+/*
+ * RFDecoder - Table-driven 433MHz pulse decoder
+ *
+ * Decodes frames of every protocol in the RFProtocol table (EV1527/PT2262,
+ * HT6P20B, HT12E, ...) from raw pulse durations, so a plain OOK receiver on
+ * a GPIO can be used instead of a decoding receiver module. The decoder has
+ * no hardware dependency: it is fed (level, duration) pulses, on the device
+ * from a GPIO edge interrupt, offline from recorded timings.
+ *
+ * Every repeat of a frame ends with the protocol's sync pair, whose long low
+ * phase separates repeats. When a long low pulse arrives the pulses before
+ * it are matched backwards against each protocol's sync and bit timings.
+ * A code is reported once two consecutive repeats decode identically, which
+ * rejects noise that happens to fit a protocol.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_DECODER_H
+#define RF_DECODER_H
+
+#include <stdint.h>
+#include "RFProtocol.h"
+
+// Pulse encoding: duration in us (15 bits, clamped to RF_PULSE_MAX_DURATION) | level bit
+#define RF_RAW_LEVEL_HIGH 0x8000
+#define RF_RAW_DURATION_MASK 0x7FFF
+
+// Pulses kept for backward matching (2 per bit plus the sync pair, power of two)
+#define RF_DECODER_HISTORY 256
+
+// Shortest low pulse tried as a repeat separator (protocol 4 sync is 6 x 380us)
+#define RF_DECODER_MIN_GAP_US 1500
+
+// Shortest pulse length (unit) accepted, and bit count limits
+#define RF_DECODER_MIN_UNIT_US 40
+#define RF_DECODER_MIN_BITS 8
+#define RF_DECODER_MAX_BITS 64
+
+// Default timing tolerance in percent of the pulse length (same as RCSwitch)
+#define RF_DECODER_TOLERANCE 60
+
+struct RFDecodedFrame {
+  uint64_t code;         // Decoded bits, last bit received in bit 0
+  uint8_t bitLength;
+  uint8_t protocol;      // Protocol number (1-based)
+  uint16_t pulseLength;  // Measured pulse length in us
+};
+
+class RFDecoder {
+public:
+  RFDecoder();
+  
+  // Feed one pulse (level | duration). Returns true with the frame when a
+  // repeat confirmed a code.
+  bool feed(uint16_t pulse, RFDecodedFrame& frame);
+  void reset();
+  
+  void setTolerance(uint8_t percent) { _tolerance = percent; }
+  
+  // Statistics
+  uint32_t getPulseCount() { return _count; }
+  uint32_t getFrameCount() { return _frames; }  // Decoded repeats (before confirmation)
+
+private:
+  uint16_t _history[RF_DECODER_HISTORY];
+  uint32_t _count;        // Pulses fed since reset
+  uint8_t _tolerance;
+  uint32_t _frames;
+  
+  // Last decoded repeat, waiting for confirmation
+  RFDecodedFrame _candidate;
+  uint32_t _candidateAt;  // _count when it was decoded
+  bool _hasCandidate;
+  
+  bool decodeAt(uint8_t protocolNumber, RFDecodedFrame& frame, uint32_t& error);
+  uint16_t pulseAt(uint32_t back) { return _history[(_count - 1 - back) & (RF_DECODER_HISTORY - 1)]; }
+  bool matches(uint16_t pulse, bool high, uint32_t units, uint32_t unit);
+  static uint32_t distance(uint16_t pulse, uint32_t expected);
+};
+
+#endif // RF_DECODER_H
@@ -0,0 +1,332 @@
+/*
+ * RFLog - Deferred, rate-limited logger implementation
+ */
+
+#include "RFLog.h"
+#include "RFMetrics.h"
+
+RFLog rfLog;
+
+static RFCounter logDropped("rf_log_dropped_total", "Log records dropped because the log ring was full");
+
+// ========== Encoding ==========
+
+// 放不下的参数和之后的所有参数都不写入，格式化时显示为"?"
+void RFLogEncoder::put(const void* data, size_t size) {
+  if (!_truncated && _length + size <= _size) {
+    memcpy(_buffer + _length, data, size);
+    _length += size;
+  } else {
+    _truncated = true;
+  }
+}
+
+// 字符串按值复制（调用者的缓冲区在返回后可能改变），放不下的部分截断
+void RFLogEncoder::putString(const char* text) {
+  if (text == nullptr) {
+    text = "(null)";
+  }
+  if (_truncated || _length >= _size) {
+    _truncated = true;
+    return;
+  }
+  size_t room = _size - _length - 1;
+  size_t length = strnlen(text, room);
+  memcpy(_buffer + _length, text, length);
+  _buffer[_length + length] = '\0';
+  _length += length + 1;
+}
+
+// ========== Logger ==========
+
+RFLog::RFLog() : _tagCount(0), _head(0), _tail(0), _dropped(0), _written(0) {
+  _out = &Serial;
+  _defaultLevel = RF_LOG_INFO;
+  _rate = RF_LOG_DEFAULT_RATE;
+  #ifdef ESP32
+  _lock = portMUX_INITIALIZER_UNLOCKED;
+  _task = nullptr;
+  _stopRequested = false;
+  #endif
+}
+
+bool RFLog::setLevel(const char* tag, RFLogLevel level) {
+  uint8_t count = _tagCount.load();
+  for (uint8_t i = 0; i < count; i++) {
+    if (strcmp(_tags[i].tag, tag) == 0) {
+      _tags[i].level = level;
+      return true;
+    }
+  }
+  if (count >= RF_LOG_MAX_TAGS) {
+    return false;
+  }
+  // 先写条目再增加计数，并发的getLevel()不会看到未初始化的条目
+  _tags[count].tag = tag;
+  _tags[count].level = level;
+  _tagCount.store(count + 1);
+  return true;
+}
+
+RFLogLevel RFLog::getLevel(const char* tag) {
+  uint8_t count = _tagCount.load();
+  for (uint8_t i = 0; i < count; i++) {
+    if (_tags[i].tag == tag || strcmp(_tags[i].tag, tag) == 0) {
+      return (RFLogLevel)_tags[i].level;
+    }
+  }
+  return _defaultLevel;
+}
+
+void RFLog::commit(RFLogLevel level, const char* tag, const char* format, uint8_t* record, size_t argsLength) {
+  Header header;
+  header.tag = tag;
+  header.format = format;
+  header.length = sizeof(Header) + argsLength;
+  header.level = level;
+  memcpy(record, &header, sizeof(header));
+  
+  #ifdef ESP32
+  TaskHandle_t task = _task;
+  if (task != nullptr) {
+    // 放入环形缓冲区（只复制字节），由日志任务格式化输出；放不下时丢弃并计数
+    bool queued = false;
+    portENTER_CRITICAL(&_lock);
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    if (RF_LOG_BUFFER_SIZE - (head - _tail.load(std::memory_order_acquire)) >= header.length) {
+      uint32_t offset = head & (RF_LOG_BUFFER_SIZE - 1);
+      uint32_t first = RF_LOG_BUFFER_SIZE - offset < header.length ? RF_LOG_BUFFER_SIZE - offset : header.length;
+      memcpy(_ring + offset, record, first);
+      memcpy(_ring, record + first, header.length - first);
+      _head.store(head + header.length, std::memory_order_release);
+      queued = true;
+    }
+    portEXIT_CRITICAL(&_lock);
+  
+    if (queued) {
+      xTaskNotifyGive(task);
+    } else {
+      _dropped++;
+      logDropped.add();
+    }
+    return;
+  }
+  #endif
+  
+  output(record);
+}
+
+// 格式化一条记录并输出（日志任务，或没有日志任务时在调用者中）
+void RFLog::output(const uint8_t* record) {
+  char line[RF_LOG_LINE_MAX];
+  size_t length = format(record, line, sizeof(line));
+  _out->write((const uint8_t*)line, length);
+  _written++;
+}
+
+// 按格式字符串逐个取出参数格式化，返回行长度（含换行符）
+size_t RFLog::format(const uint8_t* record, char* line, size_t size) {
+  Header header;
+  memcpy(&header, record, sizeof(header));
+  const uint8_t* arg = record + sizeof(Header);
+  const uint8_t* end = record + header.length;
+  size_t limit = size - 2;  // 留出换行符和结束符
+  
+  int written = snprintf(line, size, "[%s] ", header.tag);
+  size_t n = written < 0 ? 0 : ((size_t)written < limit ? written : limit);
+  
+  const char* p = header.format;
+  while (*p != '\0' && n < limit) {
+    if (*p != '%') {
+      line[n++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      line[n++] = '%';
+      p += 2;
+      continue;
+    }
+  
+    // 转换说明：%[标志][宽度][.精度][长度]转换符
+    const char* start = p++;
+    while (*p != '\0' && strchr("-+ #0", *p) != nullptr) p++;
+    while (isdigit((unsigned char)*p)) p++;
+    if (*p == '.') {
+      p++;
+      while (isdigit((unsigned char)*p)) p++;
+    }
+    uint8_t longs = 0;
+    bool sizeT = false;
+    while (*p == 'h' || *p == 'l' || *p == 'z') {
+      longs += *p == 'l' ? 1 : 0;
+      sizeT = sizeT || *p == 'z';
+      p++;
+    }
+    char conversion = *p;
+    if (conversion == '\0') {
+      break;
+    }
+    p++;
+  
+    char spec[16];
+    size_t specLength = p - start;
+    if (specLength >= sizeof(spec)) {
+      break;
+    }
+    memcpy(spec, start, specLength);
+    spec[specLength] = '\0';
+    char* out = line + n;
+    size_t room = size - 1 - n;
+  
+    size_t left = arg < end ? end - arg : 0;
+    size_t textLength = conversion == 's' ? strnlen((const char*)arg, left) : 0;
+    if (conversion == 's' ? textLength >= left : left < sizeof(int64_t)) {
+      // 参数缺失或被截断：之后的参数也都不可靠，全部显示为"?"
+      written = snprintf(out, room, "?");
+      arg = end;
+    } else if (conversion == 's') {
+      written = snprintf(out, room, spec, (const char*)arg);
+      arg += textLength + 1;
+    } else {
+      int64_t value;
+      double real;
+      memcpy(&value, arg, sizeof(value));
+      memcpy(&real, arg, sizeof(real));
+      arg += sizeof(value);
+      switch (conversion) {
+        case 'd':
+        case 'i':
+        case 'c':
+          written = longs >= 2 ? snprintf(out, room, spec, (long long)value) :
+                    longs == 1 ? snprintf(out, room, spec, (long)value) :
+                    sizeT ? snprintf(out, room, spec, (size_t)value) : snprintf(out, room, spec, (int)value);
+          break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+          written = longs >= 2 ? snprintf(out, room, spec, (unsigned long long)value) :
+                    longs == 1 ? snprintf(out, room, spec, (unsigned long)value) :
+                    sizeT ? snprintf(out, room, spec, (size_t)value) : snprintf(out, room, spec, (unsigned int)value);
+          break;
+        case 'p':
+          written = snprintf(out, room, spec, (void*)(uintptr_t)value);
+          break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+          written = snprintf(out, room, spec, real);
+          break;
+        default:
+          written = snprintf(out, room, "%s", spec);  // 不支持的转换原样输出
+          break;
+      }
+    }
+    if (written > 0) {
+      n += (size_t)written < limit - n ? (size_t)written : limit - n;
+    }
+  }
+  
+  // 格式字符串自带的换行符不重复输出
+  if (n == 0 || line[n - 1] != '\n') {
+    line[n++] = '\n';
+  }
+  line[n] = '\0';
+  return n;
+}
+
+// ========== Drain Task (ESP32 only) ==========
+
+#ifdef ESP32
+bool RFLog::start(UBaseType_t priority, uint32_t stackSize) {
+  if (_task != nullptr) {
+    return true;
+  }
+  _stopRequested = false;
+  if (xTaskCreate(taskEntry, "RFLog", stackSize, this, priority, &_task) != pdPASS) {
+    _task = nullptr;
+    Serial.println("[LOG] 日志任务创建失败");
+    return false;
+  }
+  return true;
+}
+
+void RFLog::stop() {
+  TaskHandle_t task = _task;
+  if (task == nullptr) {
+    return;
+  }
+  // 日志任务输出完缓冲区中的记录后退出，之后的日志在调用者中同步输出
+  _stopRequested = true;
+  xTaskNotifyGive(task);
+  while (_task != nullptr) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+}
+
+void RFLog::taskEntry(void* arg) {
+  static_cast<RFLog*>(arg)->drainLoop();
+}
+
+void RFLog::drainLoop() {
+  uint8_t record[RF_LOG_RECORD_MAX];
+  uint32_t reportedDrops = _dropped.load();
+  uint32_t budget = 0;  // 可输出的字节数（速率限制）
+  uint32_t refilled = millis();
+  
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    while (tail != _head.load(std::memory_order_acquire)) {
+      // 先复制出整条记录并释放空间，格式化和输出不占用缓冲区
+      uint16_t length;
+      uint32_t offset = tail & (RF_LOG_BUFFER_SIZE - 1);
+      for (uint16_t i = 0; i < sizeof(Header); i++) {
+        record[i] = _ring[(offset + i) & (RF_LOG_BUFFER_SIZE - 1)];
+      }
+      memcpy(&length, record + offsetof(Header, length), sizeof(length));
+      for (uint16_t i = sizeof(Header); i < length; i++) {
+        record[i] = _ring[(offset + i) & (RF_LOG_BUFFER_SIZE - 1)];
+      }
+      tail += length;
+      _tail.store(tail, std::memory_order_release);
+  
+      char line[RF_LOG_LINE_MAX];
+      size_t lineLength = format(record, line, sizeof(line));
+  
+      // 按速率输出：额度不够时等待，期间新记录在缓冲区中积累
+      uint32_t rate = _rate;
+      while (rate > 0) {
+        uint32_t now = millis();
+        uint32_t burst = rate / 4 > RF_LOG_LINE_MAX ? rate / 4 : RF_LOG_LINE_MAX;
+        budget += (uint64_t)(now - refilled) * rate / 1000;
+        budget = budget < burst ? budget : burst;
+        refilled = now;
+        if (budget >= lineLength) {
+          budget -= lineLength;
+          break;
+        }
+        vTaskDelay(pdMS_TO_TICKS((lineLength - budget) * 1000 / rate) + 1);
+      }
+      _out->write((const uint8_t*)line, lineLength);
+      _written++;
+    }
+  
+    uint32_t dropped = _dropped.load();
+    if (dropped != reportedDrops) {
+      _out->printf("[LOG] 日志缓冲区已满，丢弃%lu条日志\n", (unsigned long)(dropped - reportedDrops));
+      reportedDrops = dropped;
+    }
+  
+    if (_stopRequested) {
+      break;
+    }
+  }
+  _task = nullptr;
+  vTaskDelete(nullptr);
+}
+#endif
@@ -0,0 +1,188 @@
+/*
+ * RFLog - Deferred, rate-limited logger
+ *
+ * Callers push binary records (level, tag, format string pointer and the
+ * raw argument values, strings copied) into a fixed byte ring and return
+ * immediately. A low-priority task formats the records and writes them
+ * to Serial, at most setRate() bytes per second, so a slow or unread
+ * console (USB CDC without a host) never blocks the receive, transmit or
+ * HTTP paths. When the ring is full records are dropped and counted; the
+ * task reports the count on the console and as rf_log_dropped_total.
+ *
+ * Without the task (before start(), in examples and host benchmarks)
+ * records are formatted and written synchronously in the caller, as
+ * Serial.printf() did.
+ *
+ * Every line is printed as "[tag] message"; each tag can have its own
+ * level (setLevel(tag, level)), other tags use the default level.
+ * Supported conversions: d i u x X o c s p f e g, with flags, width,
+ * precision and the hh h l ll z length modifiers ('*' is not supported).
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_LOG_H
+#define RF_LOG_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+// Record ring (bytes, power of two)
+#define RF_LOG_BUFFER_SIZE 4096
+
+// Largest record (header, arguments and copied strings); longer strings are truncated
+#define RF_LOG_RECORD_MAX 256
+
+// Longest formatted line, truncated beyond
+#define RF_LOG_LINE_MAX 256
+
+// Tags with their own level
+#define RF_LOG_MAX_TAGS 16
+
+// Default drain rate (bytes per second, about a 115200 baud UART), 0 = unlimited
+#define RF_LOG_DEFAULT_RATE 11520
+
+enum RFLogLevel : uint8_t {
+  RF_LOG_NONE,
+  RF_LOG_ERROR,
+  RF_LOG_WARN,
+  RF_LOG_INFO,
+  RF_LOG_DEBUG
+};
+
+// The unevaluated checkFormat() call lets the compiler check the arguments
+// against the format string, as for printf()
+#define RF_LOG_WRITE(level, tag, format, ...) \
+  ((void)sizeof(rfLog.checkFormat(level, tag, format, ##__VA_ARGS__)), rfLog.write(level, tag, format, ##__VA_ARGS__))
+
+#define RF_LOGE(tag, format, ...) RF_LOG_WRITE(RF_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define RF_LOGW(tag, format, ...) RF_LOG_WRITE(RF_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define RF_LOGI(tag, format, ...) RF_LOG_WRITE(RF_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define RF_LOGD(tag, format, ...) RF_LOG_WRITE(RF_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+
+// Per-frame / per-request debug output on the hot paths. Build with
+// -DRF_TRACE_ENABLED=0 to compile it out (arguments are not evaluated then).
+#ifndef RF_TRACE_ENABLED
+#define RF_TRACE_ENABLED 1
+#endif
+
+#if RF_TRACE_ENABLED
+#define RF_TRACE(tag, format, ...) RF_LOGD(tag, format, ##__VA_ARGS__)
+#else
+#define RF_TRACE(tag, format, ...) do {} while (0)
+#endif
+
+// Serializes the arguments of one record
+class RFLogEncoder {
+public:
+  RFLogEncoder(uint8_t* buffer, size_t size) : _buffer(buffer), _size(size), _length(0), _truncated(false) {}
+  
+  void putInt(int64_t value) { put(&value, sizeof(value)); }
+  void putDouble(double value) { put(&value, sizeof(value)); }
+  void putString(const char* text);
+  size_t length() const { return _length; }
+
+private:
+  uint8_t* _buffer;
+  size_t _size;
+  size_t _length;
+  bool _truncated;  // An argument did not fit, it and all later ones are left out
+  
+  void put(const void* data, size_t size);
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+rfLogEncode(RFLogEncoder& encoder, T value) {
+  encoder.putInt((int64_t)value);
+}
+
+inline void rfLogEncode(RFLogEncoder& encoder, double value) { encoder.putDouble(value); }
+inline void rfLogEncode(RFLogEncoder& encoder, const char* text) { encoder.putString(text); }
+inline void rfLogEncode(RFLogEncoder& encoder, const void* pointer) { encoder.putInt((int64_t)(uintptr_t)pointer); }
+
+class RFLog {
+public:
+  RFLog();
+  
+  // Drain task (仅ESP32); stop() writes out pending records first
+  #ifdef ESP32
+  bool start(UBaseType_t priority = 1, uint32_t stackSize = 3072);
+  void stop();
+  bool isRunning() { return _task != nullptr; }
+  #endif
+  
+  // Levels: default for all tags, or for one tag (the string must outlive the logger)
+  void setLevel(RFLogLevel level) { _defaultLevel = level; }
+  bool setLevel(const char* tag, RFLogLevel level);
+  RFLogLevel getLevel(const char* tag);
+  bool isEnabled(RFLogLevel level, const char* tag) { return level <= getLevel(tag); }
+  
+  // Output and drain rate (bytes per second, 0 = unlimited)
+  void setOutput(Print& out) { _out = &out; }
+  void setRate(uint32_t bytesPerSecond) { _rate = bytesPerSecond; }
+  
+  // Statistics
+  uint32_t getDropped() { return _dropped.load(); }
+  uint32_t getWritten() { return _written.load(); }
+  uint32_t getPending() { return _head.load() - _tail.load(); }  // Bytes in the ring
+  
+  // Format and queue one record; format must be a string literal (only its address is stored)
+  template <typename... Args>
+  void write(RFLogLevel level, const char* tag, const char* format, Args... args) {
+    if (!isEnabled(level, tag)) {
+      return;
+    }
+    uint8_t record[RF_LOG_RECORD_MAX];
+    RFLogEncoder encoder(record + sizeof(Header), sizeof(record) - sizeof(Header));
+    int expand[] = {0, (rfLogEncode(encoder, args), 0)...};
+    (void)expand;
+    commit(level, tag, format, record, encoder.length());
+  }
+  
+  // Declaration only, for the format check in RF_LOG_WRITE (never called)
+  int checkFormat(RFLogLevel level, const char* tag, const char* format, ...) __attribute__((format(printf, 4, 5)));
+
+private:
+  struct Header {
+    const char* tag;
+    const char* format;
+    uint16_t length;  // Whole record
+    uint8_t level;
+  };
+  
+  struct TagLevel {
+    const char* tag;
+    volatile uint8_t level;
+  };
+  
+  Print* _out;
+  volatile RFLogLevel _defaultLevel;
+  TagLevel _tags[RF_LOG_MAX_TAGS];
+  std::atomic<uint8_t> _tagCount;
+  uint32_t _rate;
+  
+  // Ring (producers: any task under _lock, consumer: drain task)
+  uint8_t _ring[RF_LOG_BUFFER_SIZE];
+  std::atomic<uint32_t> _head;
+  std::atomic<uint32_t> _tail;
+  std::atomic<uint32_t> _dropped;
+  std::atomic<uint32_t> _written;
+  #ifdef ESP32
+  portMUX_TYPE _lock;
+  TaskHandle_t _task;
+  volatile bool _stopRequested;
+  static void taskEntry(void* arg);
+  void drainLoop();
+  #endif
+  
+  void commit(RFLogLevel level, const char* tag, const char* format, uint8_t* record, size_t argsLength);
+  void output(const uint8_t* record);
+  static size_t format(const uint8_t* record, char* line, size_t size);
+};
+
+extern RFLog rfLog;
+
+#endif // RF_LOG_H
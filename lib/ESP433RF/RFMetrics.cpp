@@ -0,0 +1,121 @@
+/*
+ * RFMetrics - Fixed-memory metrics registry implementation
+ */
+
+#include "RFMetrics.h"
+
+#ifdef ESP32
+#include <esp_heap_caps.h>
+#endif
+
+RFMetric* RFMetric::_first = nullptr;
+RFMetric* RFMetric::_last = nullptr;
+
+// 全局对象构造时登记（启动时单线程执行），之后链表不再变化，导出时无需加锁
+RFMetric::RFMetric(const char* name, const char* help, RFMetricType type)
+  : _name(name), _help(help), _type(type), _next(nullptr) {
+  if (_last != nullptr) {
+    _last->_next = this;
+  } else {
+    _first = this;
+  }
+  _last = this;
+}
+
+void RFGauge::raise(int32_t value) {
+  int32_t current = _value.load(std::memory_order_relaxed);
+  while (value > current && !_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+RFHistogram::RFHistogram(const char* name, const char* help)
+  : RFMetric(name, help, RF_METRIC_HISTOGRAM), _sum(0) {
+  for (uint8_t i = 0; i <= RF_METRICS_HISTOGRAM_BUCKETS; i++) {
+    _buckets[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void RFHistogram::observe(uint32_t us) {
+  // 向上取整到2的幂：us <= 2^bucket
+  uint8_t bucket = us <= 1 ? 0 : 32 - __builtin_clz(us - 1);
+  if (bucket > RF_METRICS_HISTOGRAM_BUCKETS) {
+    bucket = RF_METRICS_HISTOGRAM_BUCKETS;
+  }
+  _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  _sum.fetch_add(us, std::memory_order_relaxed);
+}
+
+// ========== Board metrics ==========
+
+#ifdef ESP32
+static int32_t sampleHeapFree() {
+  return heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+}
+
+static int32_t sampleHeapMinFree() {
+  return heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+}
+
+static int32_t sampleHeapLargestBlock() {
+  return heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+}
+
+static int32_t samplePsramFree() {
+  return heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+}
+
+static RFGauge heapFree("rf_heap_free_bytes", "Free internal heap", sampleHeapFree);
+static RFGauge heapMinFree("rf_heap_min_free_bytes", "Lowest free internal heap since boot (low watermark)", sampleHeapMinFree);
+static RFGauge heapLargestBlock("rf_heap_largest_free_block_bytes", "Largest free internal heap block", sampleHeapLargestBlock);
+static RFGauge psramFree("rf_psram_free_bytes", "Free PSRAM (0 without PSRAM)", samplePsramFree);
+#endif
+
+static int32_t sampleUptime() {
+  return millis() / 1000;
+}
+
+static RFGauge uptime("rf_uptime_seconds", "Time since boot", sampleUptime);
+
+// ========== Prometheus Export ==========
+
+// 微秒按秒输出（精确的十进制，不经过浮点）
+static void printSeconds(Print& out, uint64_t us) {
+  out.printf("%lu.%06lu", (unsigned long)(us / 1000000), (unsigned long)(us % 1000000));
+}
+
+void rfMetricsWritePrometheus(Print& out) {
+  static const char* const TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+  
+  for (RFMetric* metric = RFMetric::first(); metric != nullptr; metric = metric->next()) {
+    const char* name = metric->name();
+    out.printf("# HELP %s %s\n# TYPE %s %s\n", name, metric->help(), name, TYPE_NAMES[metric->type()]);
+  
+    switch (metric->type()) {
+      case RF_METRIC_COUNTER:
+        out.printf("%s %lu\n", name, (unsigned long)static_cast<RFCounter*>(metric)->value());
+        break;
+  
+      case RF_METRIC_GAUGE:
+        out.printf("%s %ld\n", name, (long)static_cast<RFGauge*>(metric)->value());
+        break;
+  
+      case RF_METRIC_HISTOGRAM: {
+        // 桶计数累加输出；_count取+Inf桶的累计值，与各桶一致
+        RFHistogram* histogram = static_cast<RFHistogram*>(metric);
+        uint64_t sum = histogram->sum();
+        uint32_t cumulative = 0;
+        for (uint8_t i = 0; i < RF_METRICS_HISTOGRAM_BUCKETS; i++) {
+          cumulative += histogram->bucket(i);
+          out.printf("%s_bucket{le=\"", name);
+          printSeconds(out, 1ULL << i);
+          out.printf("\"} %lu\n", (unsigned long)cumulative);
+        }
+        cumulative += histogram->bucket(RF_METRICS_HISTOGRAM_BUCKETS);
+        out.printf("%s_bucket{le=\"+Inf\"} %lu\n%s_sum ", name, (unsigned long)cumulative, name);
+        printSeconds(out, sum);
+        out.printf("\n%s_count %lu\n", name, (unsigned long)cumulative);
+        break;
+      }
+    }
+  }
+}
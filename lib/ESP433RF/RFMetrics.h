@@ -0,0 +1,110 @@
+/*
+ * RFMetrics - Fixed-memory metrics registry
+ *
+ * Counters, gauges and latency histograms are plain global objects that
+ * link themselves into one registry when constructed (no heap, no limit on
+ * their number). Updates are single relaxed atomic operations and can be
+ * made from any task (not from interrupts). rfMetricsWritePrometheus()
+ * prints all of them in the Prometheus text exposition format, which
+ * ESP433RFWeb serves on /metrics.
+ *
+ * Histograms record microseconds in power-of-two buckets (1us .. ~4.2s,
+ * plus +Inf) and are exported in seconds, as Prometheus expects.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_METRICS_H
+#define RF_METRICS_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Histogram buckets: le = 2^0 .. 2^(N-1) us, plus +Inf
+#define RF_METRICS_HISTOGRAM_BUCKETS 23
+
+enum RFMetricType : uint8_t {
+  RF_METRIC_COUNTER,
+  RF_METRIC_GAUGE,
+  RF_METRIC_HISTOGRAM
+};
+
+// Gauge value read at export time (free heap, queue depth, ...)
+typedef int32_t (*RFGaugeSampler)();
+
+// Registry entry; name and help must be string literals (or otherwise outlive the metric)
+class RFMetric {
+public:
+  const char* name() const { return _name; }
+  const char* help() const { return _help; }
+  RFMetricType type() const { return _type; }
+  
+  // Registry in construction order
+  static RFMetric* first() { return _first; }
+  RFMetric* next() const { return _next; }
+
+protected:
+  RFMetric(const char* name, const char* help, RFMetricType type);
+
+private:
+  const char* _name;
+  const char* _help;
+  RFMetricType _type;
+  RFMetric* _next;
+  static RFMetric* _first;
+  static RFMetric* _last;
+  
+  RFMetric(const RFMetric&) = delete;
+  RFMetric& operator=(const RFMetric&) = delete;
+};
+
+// Monotonic count (wraps at 2^32, which Prometheus treats as a counter reset)
+class RFCounter : public RFMetric {
+public:
+  RFCounter(const char* name, const char* help) : RFMetric(name, help, RF_METRIC_COUNTER), _value(0) {}
+  
+  void add(uint32_t n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+  uint32_t value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint32_t> _value;
+};
+
+// Current value, set by the owner or sampled at export time
+class RFGauge : public RFMetric {
+public:
+  RFGauge(const char* name, const char* help, RFGaugeSampler sampler = nullptr)
+    : RFMetric(name, help, RF_METRIC_GAUGE), _value(0), _sampler(sampler) {}
+  
+  void set(int32_t value) { _value.store(value, std::memory_order_relaxed); }
+  void add(int32_t delta) { _value.fetch_add(delta, std::memory_order_relaxed); }
+  // Raise to value if higher (high-water marks)
+  void raise(int32_t value);
+  int32_t value() const { return _sampler != nullptr ? _sampler() : _value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int32_t> _value;
+  RFGaugeSampler _sampler;
+};
+
+// Latency distribution in microseconds
+class RFHistogram : public RFMetric {
+public:
+  RFHistogram(const char* name, const char* help);
+  
+  void observe(uint32_t us);
+  
+  // Samples at or below 2^bucket us (bucket RF_METRICS_HISTOGRAM_BUCKETS = +Inf), not cumulative
+  uint32_t bucket(uint8_t bucket) const { return _buckets[bucket].load(std::memory_order_relaxed); }
+  uint64_t sum() const { return _sum.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint32_t> _buckets[RF_METRICS_HISTOGRAM_BUCKETS + 1];
+  std::atomic<uint64_t> _sum;
+};
+
+// All registered metrics in the Prometheus text format (version 0.0.4)
+void rfMetricsWritePrometheus(Print& out);
+
+#endif // RF_METRICS_H
@@ -0,0 +1,190 @@
+/*
+ * RFPersistence - Write-behind flash persistence implementation
+ */
+
+#include "RFPersistence.h"
+#include "RFMetrics.h"
+#include "RFLog.h"
+
+static RFCounter flashWrites("rf_flash_writes_total", "Persistence client flushes (flash writes)");
+static RFCounter flashWriteErrors("rf_flash_write_errors_total", "Persistence client flushes that failed");
+static RFHistogram flashWriteTime("rf_flash_write_seconds", "Flash write time per persistence client flush");
+
+RFPersistence::RFPersistence() {
+  _clientCount = 0;
+  _dirty = 0;
+  _mode = PERSIST_IMMEDIATE;
+  _debounceMs = 500;
+  _maxDelayMs = 5000;
+  _markCount = 0;
+  _flushCount = 0;
+  _failCount = 0;
+  
+  #ifdef ESP32
+  _task = nullptr;
+  _flushMutex = nullptr;
+  #endif
+}
+
+RFPersistence::~RFPersistence() {
+  #ifdef ESP32
+  stop();
+  if (_flushMutex != nullptr) {
+    vSemaphoreDelete(_flushMutex);
+  }
+  #endif
+}
+
+int8_t RFPersistence::registerClient(const char* name, PersistFlushCallback flush, void* context) {
+  if (flush == nullptr || _clientCount >= RF_PERSIST_MAX_CLIENTS) {
+    return -1;
+  }
+  _clients[_clientCount].name = name;
+  _clients[_clientCount].flush = flush;
+  _clients[_clientCount].context = context;
+  return _clientCount++;
+}
+
+void RFPersistence::setMode(PersistMode mode, uint32_t debounceMs, uint32_t maxDelayMs) {
+  _debounceMs = debounceMs;
+  _maxDelayMs = maxDelayMs < debounceMs ? debounceMs : maxDelayMs;
+  _mode = mode;
+  if (mode == PERSIST_IMMEDIATE) {
+    sync();  // 切换到立即模式时写入尚未落盘的状态
+  }
+}
+
+bool RFPersistence::isDeferred() {
+  #ifdef ESP32
+  return _mode == PERSIST_DELAYED && _task != nullptr;
+  #else
+  return false;
+  #endif
+}
+
+void RFPersistence::markDirty(int8_t client) {
+  if (client < 0 || client >= _clientCount) {
+    return;
+  }
+  _markCount++;
+  _dirty.fetch_or(1UL << client);
+  
+  #ifdef ESP32
+  if (isDeferred()) {
+    xTaskNotifyGive(_task);
+    return;
+  }
+  #endif
+  sync();
+}
+
+bool RFPersistence::isDirty(int8_t client) {
+  return client >= 0 && (_dirty.load() & (1UL << client)) != 0;
+}
+
+bool RFPersistence::sync() {
+  #ifdef ESP32
+  if (_flushMutex == nullptr) {
+    _flushMutex = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(_flushMutex, portMAX_DELAY);
+  bool ok = flushDirty();
+  xSemaphoreGive(_flushMutex);
+  return ok;
+  #else
+  return flushDirty();
+  #endif
+}
+
+// Run flush callbacks for all dirty clients (caller holds the flush mutex)
+bool RFPersistence::flushDirty() {
+  uint32_t dirty = _dirty.exchange(0);
+  bool ok = true;
+  for (uint8_t i = 0; i < _clientCount; i++) {
+    if ((dirty & (1UL << i)) == 0) {
+      continue;
+    }
+    _flushCount++;
+    flashWrites.add();
+    uint32_t start = micros();
+    bool written = _clients[i].flush(_clients[i].context);
+    flashWriteTime.observe(micros() - start);
+    if (!written) {
+      // 写入失败：保持脏标记，下次再试
+      _failCount++;
+      flashWriteErrors.add();
+      _dirty.fetch_or(1UL << i);
+      ok = false;
+      RF_LOGE("PERSIST", "%s 写入闪存失败", _clients[i].name);
+    }
+  }
+  return ok;
+}
+
+#ifdef ESP32
+bool RFPersistence::start(UBaseType_t priority, uint32_t stackSize) {
+  if (_task != nullptr) {
+    return true;
+  }
+  if (_flushMutex == nullptr) {
+    _flushMutex = xSemaphoreCreateMutex();
+  }
+  if (xTaskCreate(taskEntry, "RFPersist", stackSize, this, priority, &_task) != pdPASS) {
+    _task = nullptr;
+    RF_LOGE("PERSIST", "持久化任务创建失败");
+    return false;
+  }
+  if (_dirty.load() != 0) {
+    xTaskNotifyGive(_task);
+  }
+  return true;
+}
+
+void RFPersistence::stop() {
+  if (_task == nullptr) {
+    return;
+  }
+  // 持有写入互斥量时任务不可能正在写闪存，可以安全删除
+  xSemaphoreTake(_flushMutex, portMAX_DELAY);
+  TaskHandle_t task = _task;
+  _task = nullptr;  // 之后的标记在调用者中立即写入
+  vTaskDelete(task);
+  xSemaphoreGive(_flushMutex);
+  sync();
+}
+
+void RFPersistence::taskEntry(void* arg) {
+  static_cast<RFPersistence*>(arg)->taskLoop();
+}
+
+void RFPersistence::taskLoop() {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  
+    // 防抖：持续有新标记时推迟写入，但不超过最大延迟
+    TickType_t first = xTaskGetTickCount();
+    TickType_t deadline = first + pdMS_TO_TICKS(_maxDelayMs);
+    while (true) {
+      TickType_t now = xTaskGetTickCount();
+      if ((int32_t)(deadline - now) <= 0) {
+        break;
+      }
+      TickType_t wait = pdMS_TO_TICKS(_debounceMs);
+      if (wait > deadline - now) {
+        wait = deadline - now;
+      }
+      if (ulTaskNotifyTake(pdTRUE, wait) == 0) {
+        break;  // 防抖时间内没有新标记
+      }
+    }
+  
+    xSemaphoreTake(_flushMutex, portMAX_DELAY);
+    bool ok = flushDirty();
+    xSemaphoreGive(_flushMutex);
+    if (!ok) {
+      vTaskDelay(pdMS_TO_TICKS(_maxDelayMs));
+      xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+    }
+  }
+}
+#endif
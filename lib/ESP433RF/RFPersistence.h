@@ -0,0 +1,96 @@
+/*
+ * RFPersistence - Write-behind flash persistence
+ *
+ * Owners of persistent state (SignalManager, ESP433RF capture state, the
+ * application) register a flush callback and call markDirty() when their
+ * state changes. In delayed mode a background task coalesces marks and runs
+ * the dirty flush callbacks once the state has been quiet for the debounce
+ * interval (or at the latest after the max delay), so mutations return
+ * without waiting for flash writes. In immediate mode markDirty() flushes
+ * synchronously in the caller (the previous behaviour).
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_PERSISTENCE_H
+#define RF_PERSISTENCE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Maximum number of registered clients (one dirty bit each)
+#define RF_PERSIST_MAX_CLIENTS 8
+
+// Durability mode
+enum PersistMode : uint8_t {
+  PERSIST_IMMEDIATE,  // 立即写入（调用者等待闪存写完）
+  PERSIST_DELAYED     // 延迟写入（后台任务合并写入）
+};
+
+// Flush callback, runs in the persistence task (or in sync()/markDirty() caller)
+// Returns false to keep the client dirty and retry on the next flush
+typedef bool (*PersistFlushCallback)(void* context);
+
+class RFPersistence {
+public:
+  RFPersistence();
+  ~RFPersistence();
+  
+  // Register a client, returns its id (-1 when full)
+  int8_t registerClient(const char* name, PersistFlushCallback flush, void* context);
+  
+  // Durability: debounce = quiet time before flushing, maxDelay = upper bound after the first mark
+  void setMode(PersistMode mode, uint32_t debounceMs = 500, uint32_t maxDelayMs = 5000);
+  PersistMode getMode() { return _mode; }
+  // True when markDirty() will not flush in the caller (clients holding locks check this)
+  bool isDeferred();
+  
+  // Flag a client's state as changed
+  void markDirty(int8_t client);
+  bool isDirty(int8_t client);
+  
+  // Flush all dirty clients now in the calling task (explicit sync / before shutdown)
+  bool sync();
+  
+  // Background task (仅ESP32)
+  #ifdef ESP32
+  bool start(UBaseType_t priority = 1, uint32_t stackSize = 4096);
+  void stop();  // Flushes pending state before returning
+  bool isRunning() { return _task != nullptr; }
+  #endif
+  
+  // Statistics
+  uint32_t getMarkCount() { return _markCount; }
+  uint32_t getFlushCount() { return _flushCount; }
+  uint32_t getFailCount() { return _failCount; }
+
+private:
+  struct Client {
+    const char* name;
+    PersistFlushCallback flush;
+    void* context;
+  };
+  
+  Client _clients[RF_PERSIST_MAX_CLIENTS];
+  uint8_t _clientCount;
+  std::atomic<uint32_t> _dirty;  // One bit per client
+  PersistMode _mode;
+  uint32_t _debounceMs;
+  uint32_t _maxDelayMs;
+  
+  volatile uint32_t _markCount;
+  volatile uint32_t _flushCount;   // Client flushes actually executed
+  volatile uint32_t _failCount;
+  
+  #ifdef ESP32
+  TaskHandle_t _task;
+  SemaphoreHandle_t _flushMutex;  // Serializes task flushes with sync()
+  static void taskEntry(void* arg);
+  void taskLoop();
+  #endif
+  
+  bool flushDirty();
+};
+
+#endif // RF_PERSISTENCE_H
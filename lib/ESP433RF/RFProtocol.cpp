@@ -0,0 +1,191 @@
+/*
+ * RFProtocol - 433MHz pulse protocol table and waveform encoder implementation
+ */
+
+#include "RFProtocol.h"
+#include "RFRawTrace.h"
+#include <stdlib.h>
+#include <new>
+
+// Same values and order as RCSwitch's built-in protocol table
+static const RFProtocol PROTOCOLS[RF_PROTOCOL_COUNT] = {
+  { 350, {  1, 31 }, {  1,  3 }, {  3,  1 }, false },  // 1 (EV1527/PT2262)
+  { 650, {  1, 10 }, {  1,  2 }, {  2,  1 }, false },  // 2
+  { 100, { 30, 71 }, {  4, 11 }, {  9,  6 }, false },  // 3
+  { 380, {  1,  6 }, {  1,  3 }, {  3,  1 }, false },  // 4
+  { 500, {  6, 14 }, {  1,  2 }, {  2,  1 }, false },  // 5
+  { 450, { 23,  1 }, {  1,  2 }, {  2,  1 }, true },   // 6 (HT6P20B)
+  { 150, {  2, 62 }, {  1,  6 }, {  6,  1 }, false },  // 7 (HS2303-PT)
+  { 200, {  3, 130 }, {  7, 16 }, {  3, 16 }, false }, // 8 (Conrad RS-200 RX)
+  { 200, { 130, 7 }, { 16,  7 }, { 16,  3 }, true },   // 9 (Conrad RS-200 TX)
+  { 365, { 18,  1 }, {  3,  1 }, {  1,  3 }, true },   // 10 (1ByOne Doorbell)
+  { 270, { 36,  1 }, {  1,  2 }, {  2,  1 }, true },   // 11 (HT12E)
+  { 320, { 36,  1 }, {  1,  2 }, {  2,  1 }, true }    // 12 (SM5212)
+};
+
+const RFProtocol* rfGetProtocol(uint8_t number) {
+  if (number < 1 || number > RF_PROTOCOL_COUNT) {
+    return nullptr;
+  }
+  return &PROTOCOLS[number - 1];
+}
+
+// Packs (level, duration) halves into RFPulse items
+struct PulseWriter {
+  RFPulse* items;
+  uint16_t maxItems;
+  uint16_t count;
+  bool half;       // Next half goes into duration1/level1
+  bool overflow;
+  
+  void append(uint8_t level, uint32_t duration) {
+    // 超过15位的时长拆成多个同电平的半周期
+    while (duration > 0 && !overflow) {
+      uint32_t part = duration > RF_PULSE_MAX_DURATION ? RF_PULSE_MAX_DURATION : duration;
+      duration -= part;
+      if (!half) {
+        if (count >= maxItems) {
+          overflow = true;
+          return;
+        }
+        if (items != nullptr) {
+          items[count].duration0 = part;
+          items[count].level0 = level;
+          items[count].duration1 = 0;
+          items[count].level1 = 0;
+        }
+        half = true;
+      } else {
+        if (items != nullptr) {
+          items[count].duration1 = part;
+          items[count].level1 = level;
+        }
+        count++;
+        half = false;
+      }
+    }
+  }
+  
+  void appendPair(const RFPulsePair& pair, uint16_t pulseLength, bool inverted) {
+    append(inverted ? 0 : 1, (uint32_t)pair.high * pulseLength);
+    append(inverted ? 1 : 0, (uint32_t)pair.low * pulseLength);
+  }
+};
+
+uint16_t rfEncodeWaveform(const RFProtocol& protocol, uint16_t pulseLength,
+                          uint64_t code, uint8_t bitLength, uint8_t repeats,
+                          RFPulse* items, uint16_t maxItems) {
+  if (bitLength == 0 || bitLength > 64 || repeats == 0) {
+    return 0;
+  }
+  
+  PulseWriter writer = { items, maxItems, 0, false, false };
+  for (uint8_t r = 0; r < repeats && !writer.overflow; r++) {
+    for (int8_t bit = bitLength - 1; bit >= 0; bit--) {
+      const RFPulsePair& pair = (code >> bit) & 1 ? protocol.one : protocol.zero;
+      writer.appendPair(pair, pulseLength, protocol.inverted);
+    }
+    writer.appendPair(protocol.sync, pulseLength, protocol.inverted);
+  }
+  
+  if (writer.overflow) {
+    return 0;
+  }
+  if (writer.half) {
+    writer.count++;  // 最后半个item的duration1为0，即结束标记
+  }
+  return writer.count;
+}
+
+RFWaveform* RFWaveform::create(const RFProtocol& protocol, uint16_t pulseLength,
+                               uint64_t data, uint8_t bitLength, uint8_t repeats, uint16_t maxItems) {
+  // 先计数再按实际大小分配
+  uint8_t burstRepeats = repeats;
+  uint16_t count = rfEncodeWaveform(protocol, pulseLength, data, bitLength, burstRepeats, nullptr, maxItems);
+  if (count == 0) {
+    burstRepeats = 1;
+    count = rfEncodeWaveform(protocol, pulseLength, data, bitLength, burstRepeats, nullptr, maxItems);
+  }
+  if (count == 0) {
+    return nullptr;
+  }
+  
+  RFWaveform* waveform = allocate(count);
+  if (waveform == nullptr) {
+    return nullptr;
+  }
+  waveform->code = data;
+  waveform->bitLength = bitLength;
+  waveform->protocol = 0;
+  waveform->pulseLength = pulseLength;
+  waveform->repeats = repeats;
+  waveform->burstRepeats = burstRepeats;
+  waveform->itemCount = rfEncodeWaveform(protocol, pulseLength, data, bitLength, burstRepeats, waveform->items, count);
+  return waveform;
+}
+
+// 把一个周期的脉冲写入items，repeats次重复连续写入
+static uint16_t writeRawTrace(const RFRawTraceView& view, uint8_t repeats, RFPulse* items, uint16_t maxItems) {
+  PulseWriter writer = { items, maxItems, 0, false, false };
+  for (uint8_t r = 0; r < repeats && !writer.overflow; r++) {
+    for (uint16_t i = 0; i < view.symbolCount(); i++) {
+      uint16_t pulse = view.pulse(i);
+      writer.append((pulse & RF_RAW_LEVEL_HIGH) ? 1 : 0, pulse & RF_RAW_DURATION_MASK);
+    }
+  }
+  if (writer.overflow) {
+    return 0;
+  }
+  if (writer.half) {
+    writer.count++;
+  }
+  return writer.count;
+}
+
+RFWaveform* RFWaveform::createRaw(const uint8_t* trace, uint16_t length, uint16_t maxItems) {
+  RFRawTraceView view;
+  if (!view.parse(trace, length)) {
+    return nullptr;
+  }
+  uint8_t burstRepeats = view.repeats();
+  uint16_t count = writeRawTrace(view, burstRepeats, nullptr, maxItems);
+  if (count == 0) {
+    burstRepeats = 1;
+    count = writeRawTrace(view, burstRepeats, nullptr, maxItems);
+  }
+  if (count == 0) {
+    return nullptr;
+  }
+  
+  RFWaveform* waveform = allocate(count);
+  if (waveform == nullptr) {
+    return nullptr;
+  }
+  waveform->code = rfRawTraceHash(trace, view.size());
+  waveform->bitLength = 0;
+  waveform->protocol = RF_PROTOCOL_RAW;
+  waveform->pulseLength = 0;
+  waveform->repeats = view.repeats();
+  waveform->burstRepeats = burstRepeats;
+  waveform->itemCount = writeRawTrace(view, burstRepeats, waveform->items, count);
+  return waveform;
+}
+
+// 结构体和脉冲序列放在同一块内存中，调用者持有一个引用
+RFWaveform* RFWaveform::allocate(uint16_t itemCount) {
+  void* memory = malloc(sizeof(RFWaveform) + sizeof(RFPulse) * itemCount);
+  if (memory == nullptr) {
+    return nullptr;
+  }
+  RFWaveform* waveform = new (memory) RFWaveform();
+  waveform->items = reinterpret_cast<RFPulse*>(waveform + 1);
+  waveform->_refs.store(1, std::memory_order_relaxed);
+  return waveform;
+}
+
+void RFWaveform::release() {
+  if (_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    this->~RFWaveform();
+    free(this);
+  }
+}
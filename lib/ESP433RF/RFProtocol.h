@@ -0,0 +1,99 @@
+/*
+ * RFProtocol - 433MHz pulse protocol table and waveform encoder
+ *
+ * The protocol table mirrors the one built into RCSwitch, so a signal
+ * encoded here is identical on air to RCSwitch::send(). Encoded waveforms
+ * are sequences of RFPulse items whose layout matches the ESP32 RMT
+ * peripheral's rmt_item32_t, so they can be handed to the RMT driver
+ * without conversion. RFWaveform holds such a sequence precomputed for one
+ * signal so that repeated sends replay it without re-encoding.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_PROTOCOL_H
+#define RF_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Number of built-in protocols (numbered 1..RF_PROTOCOL_COUNT like RCSwitch)
+#define RF_PROTOCOL_COUNT 12
+
+// Protocol number of a recorded raw trace (RFSignal::protocol, RFWaveform::protocol)
+#define RF_PROTOCOL_RAW 0xFF
+
+// Longest duration of one pulse half in microseconds (15-bit RMT field)
+#define RF_PULSE_MAX_DURATION 32767
+
+// High/low pulse pair in multiples of the pulse length
+struct RFPulsePair {
+  uint8_t high;
+  uint8_t low;
+};
+
+struct RFProtocol {
+  uint16_t pulseLength;  // Default pulse length in us
+  RFPulsePair sync;      // Sent after the data bits of every repeat
+  RFPulsePair zero;
+  RFPulsePair one;
+  bool inverted;         // Low phase first instead of high phase first
+};
+
+// One waveform item: two (level, duration) halves, same bit layout as rmt_item32_t
+// A half with duration 0 ends the waveform
+struct RFPulse {
+  uint32_t duration0 : 15;
+  uint32_t level0 : 1;
+  uint32_t duration1 : 15;
+  uint32_t level1 : 1;
+};
+
+// Protocol by number (1-based), nullptr when out of range
+const RFProtocol* rfGetProtocol(uint8_t number);
+
+// Items needed for one repeat of a code (without splitting of over-long pulses)
+inline uint16_t rfPulsesPerRepeat(uint8_t bitLength) { return bitLength + 1; }
+
+// Encode `repeats` repeats of the lowest `bitLength` bits of `code` (MSB first),
+// each followed by the sync pair. Returns the number of items written,
+// 0 if the waveform does not fit into maxItems. With items == nullptr only
+// counts the items needed.
+uint16_t rfEncodeWaveform(const RFProtocol& protocol, uint16_t pulseLength,
+                          uint64_t code, uint8_t bitLength, uint8_t repeats,
+                          RFPulse* items, uint16_t maxItems);
+
+// Precomputed, reference-counted waveform of one signal
+// Shared between its owner (e.g. a SignalManager entry) and queued send requests,
+// so the owner can drop or rebuild it while a send is still pending.
+struct RFWaveform {
+  // Cache key: the signal settings the waveform was built with
+  uint64_t code;          // RFSignal::code
+  uint8_t bitLength;      // Bits per repeat (0 for raw traces)
+  uint8_t protocol;       // Resolved protocol number
+  uint16_t pulseLength;   // Resolved pulse length in us
+  uint8_t repeats;        // Total repeats to send
+  
+  uint8_t burstRepeats;   // Repeats contained in items (items are sent repeats / burstRepeats times)
+  uint16_t itemCount;
+  RFPulse* items;         // Stored right behind the struct
+  
+  // Encode a new waveform with one reference held by the caller (nullptr on failure)
+  // Encodes all repeats into one burst when it fits into maxItems, otherwise a single repeat
+  static RFWaveform* create(const RFProtocol& protocol, uint16_t pulseLength,
+                            uint64_t data, uint8_t bitLength, uint8_t repeats, uint16_t maxItems);
+  // Waveform of an encoded raw trace (see RFRawTrace.h): protocol RF_PROTOCOL_RAW,
+  // code = content hash, repeats taken from the trace
+  static RFWaveform* createRaw(const uint8_t* trace, uint16_t length, uint16_t maxItems);
+  void retain() { _refs.fetch_add(1, std::memory_order_relaxed); }
+  void release();  // Frees the waveform with the last reference
+  
+private:
+  std::atomic<uint16_t> _refs;
+  
+  static RFWaveform* allocate(uint16_t itemCount);
+};
+
+#endif // RF_PROTOCOL_H
@@ -0,0 +1,294 @@
+/*
+ * RFRawTrace - Compact encoding of recorded raw pulse traces implementation
+ */
+
+#include "RFRawTrace.h"
+#include <string.h>
+
+// Duration cluster while encoding
+struct TraceBucket {
+  uint32_t sum;
+  uint64_t sumSquares;
+  uint16_t count;
+  uint32_t members;  // Bit i set: first-pass cluster i was merged into this bucket
+  
+  uint32_t mean() const { return sum / count; }
+  uint32_t spread() const;  // Standard deviation
+};
+
+static uint32_t squareRoot(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+uint32_t TraceBucket::spread() const {
+  uint64_t m = mean();
+  uint64_t meanSquares = sumSquares / count;
+  return meanSquares > m * m ? squareRoot(meanSquares - m * m) : 0;
+}
+
+// 原地合并相邻的同电平脉冲（中断丢失跳变时出现），保证电平严格交替
+static uint16_t mergePulses(uint16_t* pulses, uint16_t count) {
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    if (n > 0 && ((pulses[n - 1] ^ pulses[i]) & RF_RAW_LEVEL_HIGH) == 0) {
+      uint32_t duration = (pulses[n - 1] & RF_RAW_DURATION_MASK) + (pulses[i] & RF_RAW_DURATION_MASK);
+      if (duration > RF_PULSE_MAX_DURATION) {
+        duration = RF_PULSE_MAX_DURATION;
+      }
+      pulses[n - 1] = (pulses[i] & RF_RAW_LEVEL_HIGH) | duration;
+    } else {
+      pulses[n++] = pulses[i];
+    }
+  }
+  return n;
+}
+
+static uint32_t distance(uint32_t a, uint32_t b) {
+  return a > b ? a - b : b - a;
+}
+
+// Bucket with the closest mean, -1 when there is none
+static int8_t nearestBucket(uint32_t duration, const TraceBucket* buckets, uint8_t bucketCount) {
+  int8_t best = -1;
+  uint32_t bestDistance = UINT32_MAX;
+  for (uint8_t b = 0; b < bucketCount; b++) {
+    uint32_t d = distance(duration, buckets[b].mean());
+    if (d < bestDistance) {
+      best = b;
+      bestDistance = d;
+    }
+  }
+  return best;
+}
+
+// Merge bucket b + 1 into bucket b
+static void mergeBuckets(TraceBucket* buckets, uint8_t& bucketCount, uint8_t b) {
+  buckets[b].sum += buckets[b + 1].sum;
+  buckets[b].sumSquares += buckets[b + 1].sumSquares;
+  buckets[b].count += buckets[b + 1].count;
+  buckets[b].members |= buckets[b + 1].members;
+  bucketCount--;
+  memmove(&buckets[b + 1], &buckets[b + 2], sizeof(TraceBucket) * (bucketCount - b - 1));
+}
+
+// 同一类时长的抖动范围：约为时长的1/8，短脉冲另加40us
+static uint32_t clusterTolerance(uint32_t duration) {
+  return duration / 8 + 40;
+}
+
+// 聚类（不排序脉冲，只用常数大小的栈），完成后pulses[i]的时长部分换成所属的类：
+// 1. 逐个脉冲归入中心最近且在抖动范围内的类，否则新建一类（最多32类，超出时归入最近的类）；
+//    录制从信号开始，信号脉冲先建类，末尾的噪声不会把信号脉冲吸走
+// 2. 按中心排序，合并同一时长被分开的相邻类（抖动大时第一步会把同一时长分成几类）：
+//    中心相差不超过抖动范围，或不超过两类标准差之和的两倍
+// 3. 仍超过16类时反复合并中心比值最接近的相邻两类
+// 不按区间合并：个别异常脉冲（如噪声与信号粘连）会把相邻的两类连成一片
+static uint8_t clusterDurations(uint16_t* pulses, uint16_t count, TraceBucket* buckets) {
+  uint8_t bucketCount = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    uint32_t duration = pulses[i] & RF_RAW_DURATION_MASK;
+    int8_t best = nearestBucket(duration, buckets, bucketCount);
+    bool fits = best >= 0 && distance(duration, buckets[best].mean()) <= clusterTolerance(buckets[best].mean());
+    if (!fits && bucketCount < RF_RAW_TRACE_MAX_BUCKETS * 2) {
+      buckets[bucketCount].sum = 0;
+      buckets[bucketCount].sumSquares = 0;
+      buckets[bucketCount].count = 0;
+      buckets[bucketCount].members = 1UL << bucketCount;
+      best = bucketCount++;
+    }
+    buckets[best].sum += duration;
+    buckets[best].sumSquares += (uint64_t)duration * duration;
+    buckets[best].count++;
+    pulses[i] = (pulses[i] & RF_RAW_LEVEL_HIGH) | best;
+  }
+  
+  // 按中心排序（最多32类，插入排序）
+  for (uint8_t i = 1; i < bucketCount; i++) {
+    TraceBucket bucket = buckets[i];
+    int8_t j = i - 1;
+    while (j >= 0 && buckets[j].mean() > bucket.mean()) {
+      buckets[j + 1] = buckets[j];
+      j--;
+    }
+    buckets[j + 1] = bucket;
+  }
+  
+  uint8_t b = 0;
+  while (b + 1 < bucketCount) {
+    uint32_t gap = buckets[b + 1].mean() - buckets[b].mean();
+    if (gap <= clusterTolerance(buckets[b].mean()) ||
+        gap <= 2 * (buckets[b].spread() + buckets[b + 1].spread()) + 40) {
+      mergeBuckets(buckets, bucketCount, b);
+    } else {
+      b++;
+    }
+  }
+  
+  while (bucketCount > RF_RAW_TRACE_MAX_BUCKETS) {
+    uint8_t closest = 0;
+    uint32_t bestRatio = UINT32_MAX;
+    for (b = 0; b + 1 < bucketCount; b++) {
+      uint32_t ratio = buckets[b + 1].mean() * 1000 / (buckets[b].mean() + 1);
+      if (ratio < bestRatio) {
+        closest = b;
+        bestRatio = ratio;
+      }
+    }
+    mergeBuckets(buckets, bucketCount, closest);
+  }
+  
+  uint8_t remap[RF_RAW_TRACE_MAX_BUCKETS * 2];
+  for (b = 0; b < bucketCount; b++) {
+    for (uint8_t i = 0; i < RF_RAW_TRACE_MAX_BUCKETS * 2; i++) {
+      if (buckets[b].members & (1UL << i)) {
+        remap[i] = b;
+      }
+    }
+  }
+  for (uint16_t i = 0; i < count; i++) {
+    pulses[i] = (pulses[i] & RF_RAW_LEVEL_HIGH) | remap[pulses[i] & RF_RAW_DURATION_MASK];
+  }
+  return bucketCount;
+}
+
+static uint8_t symbolAt(const uint8_t* symbols, uint16_t i) {
+  return (symbols[i >> 1] >> ((i & 1) * 4)) & 0x0F;
+}
+
+static bool sameSymbols(const uint8_t* symbols, uint16_t a, uint16_t b, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    if (symbolAt(symbols, a + i) != symbolAt(symbols, b + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint16_t rfRawTraceEncode(uint16_t* pulses, uint16_t count, uint8_t* out, uint16_t maxBytes) {
+  if (count > RF_RAW_TRACE_MAX_PULSES) {
+    count = RF_RAW_TRACE_MAX_PULSES;
+  }
+  uint16_t n = mergePulses(pulses, count);
+  if (n < RF_RAW_TRACE_MIN_PULSES) {
+    return 0;
+  }
+  
+  // 合并前最多32类；之后pulses中是电平 | 类别
+  TraceBucket buckets[RF_RAW_TRACE_MAX_BUCKETS * 2];
+  uint8_t bucketCount = clusterDurations(pulses, n, buckets);
+  uint16_t symbolOffset = sizeof(RFRawTraceHeader) + bucketCount * 2;
+  if (symbolOffset + (n + 1) / 2 > maxBytes) {
+    return 0;
+  }
+  
+  // 先写出全部符号，选定周期后只保留第一个周期
+  uint8_t* symbols = out + symbolOffset;
+  memset(symbols, 0, (n + 1) / 2);
+  for (uint16_t i = 0; i < n; i++) {
+    symbols[i >> 1] |= (pulses[i] & RF_RAW_DURATION_MASK) << ((i & 1) * 4);
+  }
+  
+  // 周期候选：每个分隔符（长低电平）之后的位置，取覆盖脉冲最多的连续重复（至少两次）
+  // 数据位中也可能有长低电平（如协议8），按覆盖范围而不是最短周期选择，避免选中码内的巧合重复
+  // 录制开始于分隔符之后，末尾可能截断在一帧中间或混入噪声，只保留完整一致的重复
+  uint16_t period = 0;
+  uint16_t repeats = 1;
+  uint16_t lastSeparator = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    bool separator = (pulses[i] & RF_RAW_LEVEL_HIGH) == 0 &&
+                     buckets[pulses[i] & RF_RAW_DURATION_MASK].mean() >= RF_DECODER_MIN_GAP_US;
+    if (!separator) {
+      continue;
+    }
+    lastSeparator = i + 1;
+    uint16_t p = i + 1;
+    if (p < RF_RAW_TRACE_MIN_PULSES || (p & 1) != 0 || p * 2 > n) {
+      continue;
+    }
+    uint16_t k = 1;
+    while ((k + 1) * p <= n && k < 255 && sameSymbols(symbols, 0, k * p, p)) {
+      k++;
+    }
+    if (k >= 2 && (uint32_t)k * p > (uint32_t)repeats * period) {
+      period = p;
+      repeats = k;
+    }
+  }
+  if (period == 0) {
+    // 不是重复帧（或重复间有差异）：原样保留到最后一个分隔符
+    period = lastSeparator >= RF_RAW_TRACE_MIN_PULSES ? lastSeparator : n;
+  }
+  
+  RFRawTraceHeader header;
+  header.format = RF_RAW_TRACE_FORMAT;
+  header.firstLevel = (pulses[0] & RF_RAW_LEVEL_HIGH) ? 1 : 0;
+  header.bucketCount = bucketCount;
+  header.repeats = repeats;
+  header.symbolCount = period;
+  header.reserved = 0;
+  memcpy(out, &header, sizeof(header));
+  for (uint8_t b = 0; b < bucketCount; b++) {
+    uint16_t duration = buckets[b].mean();  // 回放时每类用平均时长
+    out[sizeof(header) + b * 2] = duration & 0xFF;
+    out[sizeof(header) + b * 2 + 1] = duration >> 8;
+  }
+  if (period & 1) {
+    symbols[period >> 1] &= 0x0F;  // 奇数个符号时清除多余的高半字节，保证内容哈希一致
+  }
+  return symbolOffset + (period + 1) / 2;
+}
+
+bool RFRawTraceView::parse(const uint8_t* trace, uint16_t length) {
+  if (trace == nullptr || length < sizeof(RFRawTraceHeader)) {
+    return false;
+  }
+  memcpy(&_header, trace, sizeof(_header));
+  if (_header.format != RF_RAW_TRACE_FORMAT ||
+      _header.bucketCount == 0 || _header.bucketCount > RF_RAW_TRACE_MAX_BUCKETS ||
+      _header.repeats == 0 ||
+      _header.symbolCount == 0 || _header.symbolCount > RF_RAW_TRACE_MAX_PULSES) {
+    return false;
+  }
+  _buckets = trace + sizeof(RFRawTraceHeader);
+  _symbols = _buckets + _header.bucketCount * 2;
+  _size = sizeof(RFRawTraceHeader) + _header.bucketCount * 2 + (_header.symbolCount + 1) / 2;
+  if (_size > length) {
+    return false;
+  }
+  for (uint16_t i = 0; i < _header.symbolCount; i++) {
+    if (symbolAt(_symbols, i) >= _header.bucketCount) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint16_t RFRawTraceView::pulse(uint16_t i) const {
+  uint8_t symbol = symbolAt(_symbols, i);
+  uint16_t duration = _buckets[symbol * 2] | (_buckets[symbol * 2 + 1] << 8);
+  bool high = (_header.firstLevel ^ (i & 1)) != 0;
+  return (high ? RF_RAW_LEVEL_HIGH : 0) | (duration & RF_RAW_DURATION_MASK);
+}
+
+uint32_t rfRawTraceHash(const uint8_t* trace, uint16_t length) {
+  uint32_t hash = 2166136261u;
+  for (uint16_t i = 0; i < length; i++) {
+    hash ^= trace[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
@@ -0,0 +1,90 @@
+/*
+ * RFRawTrace - Compact encoding of recorded raw pulse traces
+ *
+ * Signals the decoder cannot interpret (rolling codes, unknown fixed-code
+ * protocols) are kept as the pulse sequence itself and replayed verbatim.
+ * A raw capture is a few hundred (level, duration) pulses, but on-off keyed
+ * remotes only use a handful of distinct durations and send the same frame
+ * several times, so the trace is stored as:
+ *
+ *   - a duration table: pulses are clustered into at most 16 buckets,
+ *     each pulse becomes a 4-bit bucket index (levels simply alternate);
+ *   - one period plus a repeat count: when the capture consists of
+ *     identical repeats (each ending with a long low separator), only the
+ *     first repeat is stored.
+ *
+ * A 24-bit EV1527 capture of 10 repeats (500 pulses) encodes to about
+ * 40 bytes. The encoded trace is a self-contained byte blob (little endian)
+ * that can be stored in flash as is.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_RAW_TRACE_H
+#define RF_RAW_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "RFDecoder.h"
+
+// Longest capture (pulses) and shortest capture worth keeping
+#define RF_RAW_TRACE_MAX_PULSES 512
+#define RF_RAW_TRACE_MIN_PULSES 16
+
+// Distinct durations per trace (4-bit symbols)
+#define RF_RAW_TRACE_MAX_BUCKETS 16
+
+#define RF_RAW_TRACE_FORMAT 1
+
+// Trace header, followed by bucketCount uint16_t durations (us) and
+// (symbolCount + 1) / 2 bytes of symbols (first symbol in the low nibble)
+struct RFRawTraceHeader {
+  uint8_t format;
+  uint8_t firstLevel;    // Level of the first pulse (1 = high)
+  uint8_t bucketCount;
+  uint8_t repeats;       // The symbols (one period) are sent this many times
+  uint16_t symbolCount;  // Pulses per period
+  uint16_t reserved;
+};
+
+// Largest encoded trace in bytes
+#define RF_RAW_TRACE_MAX_BYTES (sizeof(RFRawTraceHeader) + RF_RAW_TRACE_MAX_BUCKETS * 2 + RF_RAW_TRACE_MAX_PULSES / 2)
+
+// Encode `count` pulses (level | duration, see RFDecoder.h), the first one
+// following a separator. Returns the encoded size, 0 when the trace is too
+// short or does not fit into maxBytes. `pulses` is used as scratch space
+// and overwritten.
+uint16_t rfRawTraceEncode(uint16_t* pulses, uint16_t count, uint8_t* out, uint16_t maxBytes);
+
+// Read access to an encoded trace
+class RFRawTraceView {
+public:
+  // Returns false when the blob is not a valid trace
+  bool parse(const uint8_t* trace, uint16_t length);
+  
+  uint16_t size() const { return _size; }  // Encoded bytes
+  uint16_t symbolCount() const { return _header.symbolCount; }
+  uint8_t repeats() const { return _header.repeats; }
+  uint8_t bucketCount() const { return _header.bucketCount; }
+  
+  // Pulse i of one period (level | duration)
+  uint16_t pulse(uint16_t i) const;
+
+private:
+  RFRawTraceHeader _header;
+  const uint8_t* _buckets;
+  const uint8_t* _symbols;
+  uint16_t _size;
+};
+
+// Size of an encoded trace from its header, 0 when invalid
+inline uint16_t rfRawTraceSize(const uint8_t* trace, uint16_t length) {
+  RFRawTraceView view;
+  return view.parse(trace, length) ? view.size() : 0;
+}
+
+// Content hash, used as the code of a raw signal (FNV-1a)
+uint32_t rfRawTraceHash(const uint8_t* trace, uint16_t length);
+
+#endif // RF_RAW_TRACE_H
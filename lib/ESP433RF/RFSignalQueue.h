@@ -0,0 +1,78 @@
+/*
+ * RFSignalQueue - Bounded lock-free single-producer/single-consumer ring
+ *
+ * Used by ESP433RF to hand decoded frames from the receive task to the
+ * dispatcher task. Exactly one task may push and exactly one task may pop;
+ * no locks are taken and push never blocks (a full queue drops the item and
+ * counts it).
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_SIGNAL_QUEUE_H
+#define RF_SIGNAL_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint32_t Capacity>
+class RFSignalQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+  RFSignalQueue() : _head(0), _tail(0), _dropped(0), _highWater(0) {}
+  
+  // Producer side: returns false (and counts a drop) when the queue is full
+  bool push(const T& item) {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    uint32_t tail = _tail.load(std::memory_order_acquire);
+    uint32_t depth = head - tail;
+    if (depth >= Capacity) {
+      _dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    _items[head & (Capacity - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);
+    if (depth + 1 > _highWater.load(std::memory_order_relaxed)) {
+      _highWater.store(depth + 1, std::memory_order_relaxed);
+    }
+    return true;
+  }
+  
+  // Consumer side: returns false when the queue is empty
+  bool pop(T& item) {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t head = _head.load(std::memory_order_acquire);
+    if (head == tail) {
+      return false;
+    }
+    item = _items[tail & (Capacity - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+  
+  // Consumer side: drop everything currently queued
+  void clear() {
+    _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+  }
+  
+  // Statistics (safe to read from any task)
+  uint32_t size() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+  uint32_t capacity() const { return Capacity; }
+  uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+  uint32_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+  void resetStats() {
+    _dropped.store(0, std::memory_order_relaxed);
+    _highWater.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  T _items[Capacity];
+  std::atomic<uint32_t> _head;       // Written by producer only
+  std::atomic<uint32_t> _tail;       // Written by consumer only
+  std::atomic<uint32_t> _dropped;    // Written by producer only
+  std::atomic<uint32_t> _highWater;  // Written by producer only
+};
+
+#endif // RF_SIGNAL_QUEUE_H
@@ -4,6 +4,50 @@
 
 #include "ESP433RFWeb.h"
 
+#ifdef ESP32
+static RFCounter httpRequests("rf_http_requests_total", "HTTP requests handled");
+static RFHistogram httpHandlerTime("rf_http_handler_seconds", "HTTP handler time (request parsed to response sent)");
+
+// 分块响应：攒满缓冲区后作为一个HTTP块发送，输出再长内存占用也固定
+class WebChunkPrint : public Print {
+public:
+  WebChunkPrint(WebServer& server) : _server(server), _length(0) {}
+  
+  size_t write(uint8_t c) override {
+    if (_length == sizeof(_buffer)) {
+      flush();
+    }
+    _buffer[_length++] = c;
+    return 1;
+  }
+  
+  size_t write(const uint8_t* data, size_t size) override {
+    for (size_t written = 0; written < size; ) {
+      if (_length == sizeof(_buffer)) {
+        flush();
+      }
+      size_t n = size - written < sizeof(_buffer) - _length ? size - written : sizeof(_buffer) - _length;
+      memcpy(_buffer + _length, data + written, n);
+      _length += n;
+      written += n;
+    }
+    return size;
+  }
+  
+  void flush() override {
+    if (_length > 0) {
+      _server.sendContent((const char*)_buffer, _length);
+      _length = 0;
+    }
+  }
+
+private:
+  WebServer& _server;
+  char _buffer[512];
+  size_t _length;
+};
+#endif
+
 ESP433RFWeb::ESP433RFWeb(ESP433RF& rf, SignalManager& signalMgr) 
   : _rf(rf), _signalMgr(signalMgr) {
   #ifdef ESP32
@@ -26,10 +70,10 @@ ESP433RFWeb::ESP433RFWeb(ESP433RF& rf, SignalManager& signalMgr)
    WiFi.softAP(_apSSID.c_str(), _apPassword.c_str());
    _apStarted = true;
    
-   Serial.printf("[WiFi] AP模式已启动\n");
-   Serial.printf("[WiFi] SSID: %s\n", _apSSID.c_str());
-   Serial.printf("[WiFi] 密码: %s\n", _apPassword.c_str());
-   Serial.printf("[WiFi] IP地址: %s\n", WiFi.softAPIP().toString().c_str());
+   RF_LOGI("WiFi", "AP模式已启动");
+   RF_LOGI("WiFi", "SSID: %s", _apSSID.c_str());
+   RF_LOGI("WiFi", "密码: %s", _apPassword.c_str());
+   RF_LOGI("WiFi", "IP地址: %s", WiFi.softAPIP().toString().c_str());
    
    // 创建Web服务器
    if (_server == nullptr) {
@@ -37,13 +81,14 @@ ESP433RFWeb::ESP433RFWeb(ESP433RF& rf, SignalManager& signalMgr)
    }
    
    // 注册路由
-   _server->on("/", HTTP_GET, [this]() { this->handleRoot(); });
-   _server->on("/api", HTTP_GET, [this]() { this->handleAPI(); });
-   _server->on("/api", HTTP_POST, [this]() { this->handleAPI(); });
-   _server->onNotFound([this]() { this->handleNotFound(); });
+   _server->on("/", HTTP_GET, [this]() { this->runHandler(&ESP433RFWeb::handleRoot); });
+   _server->on("/api", HTTP_GET, [this]() { this->runHandler(&ESP433RFWeb::handleAPI); });
+   _server->on("/api", HTTP_POST, [this]() { this->runHandler(&ESP433RFWeb::handleAPI); });
+   _server->on("/metrics", HTTP_GET, [this]() { this->runHandler(&ESP433RFWeb::handleMetrics); });
+   _server->onNotFound([this]() { this->runHandler(&ESP433RFWeb::handleNotFound); });
    
    _server->begin();
-   Serial.println("[Web] Web服务器已启动");
+   RF_LOGI("Web", "Web服务器已启动");
    #endif
  }
  
@@ -100,6 +145,14 @@ ESP433RFWeb::ESP433RFWeb(ESP433RF& rf, SignalManager& signalMgr)
  }
  
 #ifdef ESP32
+// 统计请求数和处理时间
+void ESP433RFWeb::runHandler(void (ESP433RFWeb::*handler)()) {
+  uint32_t start = micros();
+  (this->*handler)();
+  httpRequests.add();
+  httpHandlerTime.observe(micros() - start);
+}
+
 void ESP433RFWeb::handleRoot() {
   String html = R"HTML(
 <!DOCTYPE html>
@@ -294,7 +347,10 @@ void ESP433RFWeb::handleRoot() {
             <h2>快捷操作</h2>
             <div class="btn-group">
                 <button class="btn btn-warning" onclick="startCapture()">捕获信号</button>
+                <button class="btn btn-warning" onclick="startRawCapture()">录制原始波形</button>
+                <button class="btn btn-success" onclick="saveRawCapture()">保存原始波形</button>
                 <button class="btn btn-success" onclick="refreshList()">刷新列表</button>
+                <button class="btn btn-success" onclick="sendAll()">全部发送</button>
             </div>
         </div>
         
@@ -309,6 +365,10 @@ void ESP433RFWeb::handleRoot() {
     
     <script>
         var bootBoundIndex = -1;
+        var signalTotal = 0;
+        var batchMax = )HTML";
+  html += String(RF_TX_BATCH_MAX);
+  html += R"HTML(;  // 每次send_batch请求的最多项数
         
         function showToast(message) {
             var toast = document.getElementById('toast');
@@ -340,6 +400,7 @@ void ESP433RFWeb::handleRoot() {
             var list = document.getElementById('signalList');
             var count = document.getElementById('signalCount');
             count.textContent = signals.length;
+            signalTotal = signals.length;
             
             if (signals.length === 0) {
                 list.innerHTML = '<div class="empty">暂无信号<br>点击"捕获信号"开始</div>';
@@ -365,7 +426,7 @@ void ESP433RFWeb::handleRoot() {
                     html += '<div class="signal-badge">#' + (originalIdx + 1) + '</div>';
                 }
                 html += '</div>';
-                html += '<div class="signal-code">' + sig.address + sig.key + '</div>';
+                html += '<div class="signal-code">' + (sig.raw ? '原始波形' : sig.code + ' (' + sig.bits + '位)') + '</div>';
                 html += '<div class="signal-actions">';
                 html += '<button class="btn btn-success btn-small" onclick="sendSignal(' + originalIdx + ')">发送</button>';
                 if (isBound) {
@@ -388,6 +449,36 @@ void ESP433RFWeb::handleRoot() {
                 });
         }
         
+        // 按列表顺序发送所有信号，每batchMax个一批依次请求，格式：items=索引[:重复次数[:间隔ms]],...
+        function sendAll() {
+            if (signalTotal === 0) {
+                showToast('暂无信号');
+                return;
+            }
+            var total = signalTotal;
+            function sendChunk(start) {
+                var items = [];
+                for (var i = start; i < total && items.length < batchMax; i++) {
+                    items.push(i);
+                }
+                fetch('/api?action=send_batch&items=' + items.join(','), {method: 'POST'})
+                    .then(function(r) { return r.json(); })
+                    .then(function(data) {
+                        if (data.code !== 200) {
+                            showToast(start > 0 ? '已发送' + start + '个，' + data.message : data.message);
+                        } else if (start + items.length < total) {
+                            sendChunk(start + items.length);
+                        } else {
+                            showToast(total + '个信号已加入发送队列');
+                        }
+                    })
+                    .catch(function(error) {
+                        showToast('发送失败');
+                    });
+            }
+            sendChunk(0);
+        }
+        
         function deleteSignal(index) {
             fetch('/api?action=delete&index=' + index, {method: 'POST'})
                 .then(function(r) { return r.json(); })
@@ -444,6 +535,23 @@ void ESP433RFWeb::handleRoot() {
                 });
         }
         
+        function startRawCapture() {
+            fetch('/api?action=capture_raw', {method: 'POST'})
+                .then(function(r) { return r.json(); })
+                .then(function(data) { showToast(data.message); });
+        }
+        
+        function saveRawCapture() {
+            var name = prompt('原始波形名称');
+            if (!name) return;
+            fetch('/api?action=save_raw&name=' + encodeURIComponent(name), {method: 'POST'})
+                .then(function(r) { return r.json(); })
+                .then(function(data) {
+                    showToast(data.message);
+                    refreshList();
+                });
+        }
+        
         window.onload = function() {
             refreshList();
             fetch('/api?action=get_boot_binding')
@@ -472,9 +580,8 @@ void ESP433RFWeb::handleRoot() {
    String action = _server->arg("action");
    
    if (action == "list") {
-     // 获取信号列表
-     String json = getSignalListJSON();
-     sendJSONResponse(200, "成功", json);
+     // 获取信号列表（分块发送）
+     sendSignalList();
    }
    else if (action == "send") {
      // 发送信号
@@ -483,11 +590,43 @@ void ESP433RFWeb::handleRoot() {
        return;
      }
      
-     uint8_t index = _server->arg("index").toInt();
+     uint16_t index = _server->arg("index").toInt();
      if (_signalMgr.sendSignal(index, _rf)) {
-       sendJSONResponse(200, "信号已发送");
+       sendJSONResponse(200, "信号已加入发送队列");
      } else {
-       sendJSONResponse(400, "发送失败：索引无效");
+       sendJSONResponse(400, "发送失败：索引无效或发送队列已满");
+     }
+   }
+   else if (action == "send_batch") {
+     // 批量发送（场景）：items=索引[:重复次数[:间隔ms]],...，gap为未指定间隔的项的默认间隔
+     if (!_server->hasArg("items")) {
+       sendJSONResponse(400, "缺少items参数");
+       return;
+     }
+     
+     long defaultGap = _server->hasArg("gap") ? _server->arg("gap").toInt() : 0;
+     if (defaultGap < 0 || defaultGap > 0xFFFF) {
+       sendJSONResponse(400, "发送失败：gap超出范围");
+       return;
+     }
+     SignalBatchItem items[RF_TX_BATCH_MAX];
+     uint8_t count = parseBatchItems(_server->arg("items"), defaultGap, items, RF_TX_BATCH_MAX);
+     if (count == 0) {
+       sendJSONResponse(400, "发送失败：items格式无效、数值超出范围或超过" + String(RF_TX_BATCH_MAX) + "项");
+       return;
+     }
+     uint16_t signalCount = _signalMgr.getCount();
+     for (uint8_t i = 0; i < count; i++) {
+       if (items[i].index >= signalCount) {
+         sendJSONResponse(400, "发送失败：索引" + String(items[i].index) + "无效");
+         return;
+       }
+     }
+     
+     if (_signalMgr.sendBatch(items, count, _rf)) {
+       sendJSONResponse(200, String(count) + "个信号已加入发送队列");
+     } else {
+       sendJSONResponse(400, "发送失败：索引无效或发送队列已满");
      }
    }
    else if (action == "delete") {
@@ -497,7 +636,7 @@ void ESP433RFWeb::handleRoot() {
        return;
      }
      
-     uint8_t index = _server->arg("index").toInt();
+     uint16_t index = _server->arg("index").toInt();
      if (_signalMgr.removeSignal(index)) {
        sendJSONResponse(200, "信号已删除");
      } else {
@@ -505,19 +644,26 @@ void ESP433RFWeb::handleRoot() {
      }
    }
    else if (action == "add") {
-     // 添加信号
-     if (!_server->hasArg("name") || !_server->hasArg("address") || !_server->hasArg("key")) {
+     // 添加信号：完整信号码code（十六进制，可选位数bits）或地址码address + 按键值key
+     bool hasCode = _server->hasArg("code");
+     if (!_server->hasArg("name") || (!hasCode && (!_server->hasArg("address") || !_server->hasArg("key")))) {
        sendJSONResponse(400, "缺少必要参数");
        return;
      }
      
      String name = _server->arg("name");
-     String address = _server->arg("address");
-     String key = _server->arg("key");
-     
      RFSignal signal;
-     signal.address = address;
-     signal.key = key;
+     bool valid;
+     if (hasCode) {
+       valid = RFSignal::fromHex(_server->arg("code").c_str(), signal) &&
+               (!_server->hasArg("bits") || signal.setBitLength(_server->arg("bits").toInt()));
+     } else {
+       valid = RFSignal::fromHex(_server->arg("address").c_str(), _server->arg("key").c_str(), signal);
+     }
+     if (!valid) {
+       sendJSONResponse(400, "添加失败：信号格式无效");
+       return;
+     }
      
      if (_signalMgr.addSignal(name, signal)) {
        sendJSONResponse(200, "信号已添加");
@@ -533,6 +679,35 @@ void ESP433RFWeb::handleRoot() {
     _rf.enableCaptureMode();
     sendJSONResponse(200, "已进入捕获模式，请按下遥控器按键");
   }
+  else if (action == "capture_raw") {
+    // 录制原始波形（无法解码的遥控器），需要原始脉冲接收模式
+    if (_rf.enableRawCapture()) {
+      sendJSONResponse(200, "已开始录制，请按住遥控器按键");
+    } else {
+      sendJSONResponse(400, "录制失败：未启用原始脉冲接收");
+    }
+  }
+  else if (action == "save_raw") {
+    // 保存最近一次录制的原始波形
+    if (!_server->hasArg("name")) {
+      sendJSONResponse(400, "缺少name参数");
+      return;
+    }
+    
+    uint8_t trace[RF_RAW_TRACE_MAX_BYTES];
+    uint16_t length = _rf.getCapturedTrace(trace, sizeof(trace));
+    if (length == 0) {
+      sendJSONResponse(400, "保存失败：没有录制到波形");
+    } else if (length > sizeof(trace) || rfRawTraceSize(trace, length) != length) {
+      // 按编码头计算的长度必须与取出的字节数一致且不超过缓冲区
+      sendJSONResponse(400, "保存失败：录制数据无效");
+    } else if (_signalMgr.addRawSignal(_server->arg("name"), trace, length)) {
+      _rf.clearCapturedTrace();
+      sendJSONResponse(200, "原始波形已保存");
+    } else {
+      sendJSONResponse(400, "保存失败：可能已达到最大数量");
+    }
+  }
   else if (action == "bind_boot") {
     // 绑定Boot按钮
     if (!_server->hasArg("index")) {
@@ -540,10 +715,10 @@ void ESP433RFWeb::handleRoot() {
       return;
     }
     
-    uint8_t index = _server->arg("index").toInt();
+    uint16_t index = _server->arg("index").toInt();
     if (index < _signalMgr.getCount()) {
       _bootBoundIndex = index;
-      Serial.printf("[WEB] Boot按钮已绑定到信号 #%d\n", index);
+      RF_LOGI("WEB", "Boot按钮已绑定到信号 #%u", index);
       sendJSONResponse(200, "Boot按钮已绑定");
     } else {
       sendJSONResponse(400, "绑定失败：索引无效");
@@ -552,7 +727,7 @@ void ESP433RFWeb::handleRoot() {
   else if (action == "unbind_boot") {
     // 解绑Boot按钮
     _bootBoundIndex = -1;
-    Serial.println("[WEB] Boot按钮已解绑");
+    RF_LOGI("WEB", "Boot按钮已解绑");
     sendJSONResponse(200, "Boot按钮已解绑");
   }
   else if (action == "get_boot_binding") {
@@ -561,13 +736,10 @@ void ESP433RFWeb::handleRoot() {
     sendJSONResponse(200, "成功", data);
   }
   else if (action == "clear_all") {
-    // 一键清空所有信号
-    uint8_t count = _signalMgr.getCount();
-    for (int i = count - 1; i >= 0; i--) {
-      _signalMgr.removeSignal(i);
-    }
+    // 一键清空所有信号（一次写锁内完成，不与其他任务交错）
+    _signalMgr.clear();
     _bootBoundIndex = -1;  // 清空绑定
-    Serial.println("[WEB] 所有信号已清空");
+    RF_LOGI("WEB", "所有信号已清空");
     sendJSONResponse(200, "所有信号已清空");
   }
   else {
@@ -578,6 +750,16 @@ void ESP433RFWeb::handleRoot() {
  void ESP433RFWeb::handleNotFound() {
    sendJSONResponse(404, "页面未找到");
  }
+
+// Prometheus文本格式，分块发送
+void ESP433RFWeb::handleMetrics() {
+  _server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _server->send(200, "text/plain; version=0.0.4", "");
+  WebChunkPrint out(*_server);
+  rfMetricsWritePrometheus(out);
+  out.flush();
+  _server->sendContent("");  // 结束块
+}
  
 void ESP433RFWeb::sendJSONResponse(int code, const String& message, const String& data) {
   String json = "{\"code\":" + String(code) + ",\"message\":\"" + message + "\"";
@@ -588,41 +770,153 @@ void ESP433RFWeb::sendJSONResponse(int code, const String& message, const String
   json += "}";
   
   // 添加调试输出
-  Serial.printf("[API] Response: %s\n", json.c_str());
+  RF_TRACE("API", "Response: %s", json.c_str());
   
   _server->send(code, "application/json", json);
 }
 
-String ESP433RFWeb::getSignalListJSON() {
-  uint8_t count = _signalMgr.getCount();
-  Serial.printf("[API] getSignalListJSON: count=%d\n", count);
-  
-  if (count == 0) {
-    return "[]";
+// 解析一个不超过max的十进制数，end指向其后的字符
+static bool parseNumber(const char* p, char** end, unsigned long max, unsigned long& value) {
+  if (!isdigit((unsigned char)*p)) {
+    return false;
   }
-  
-  SignalItem* items = new SignalItem[count];
-  if (!_signalMgr.getAllSignals(items, count)) {
-    Serial.println("[API] getAllSignals failed");
-    delete[] items;
-    return "[]";
+  value = strtoul(p, end, 10);  // 溢出时为ULONG_MAX，同样超出范围
+  return value <= max;
+}
+
+// 解析批量发送参数"0,3:2,5:1:100"，格式错误、数值超出字段范围或项数超过maxCount时返回0
+uint8_t ESP433RFWeb::parseBatchItems(const String& text, uint16_t defaultGap, SignalBatchItem* items, uint8_t maxCount) {
+  const char* p = text.c_str();
+  uint8_t count = 0;
+  while (*p != '\0') {
+    char* end;
+    unsigned long index;
+    unsigned long repeats = 0;
+    unsigned long gap = defaultGap;
+    if (count >= maxCount || !parseNumber(p, &end, 0xFFFF, index)) {
+      return 0;
+    }
+    if (*end == ':') {
+      if (!parseNumber(end + 1, &end, 0xFF, repeats)) {
+        return 0;
+      }
+      if (*end == ':' && !parseNumber(end + 1, &end, 0xFFFF, gap)) {
+        return 0;
+      }
+    }
+    SignalBatchItem& item = items[count++];
+    item.index = index;
+    item.repeats = repeats;
+    item.gapMs = gap;
+    if (*end == ',') {
+      end++;
+    } else if (*end != '\0') {
+      return 0;
+    }
+    p = end;
   }
+  return count;
+}
+
+// 每批在SignalManager读锁内复制的信号数，发送时不持有锁（网络慢时不阻塞添加/删除）
+#define SIGNAL_LIST_BATCH 8
+
+struct SignalListBatch {
+  SignalItem items[SIGNAL_LIST_BATCH];
+  uint8_t count;
+};
+
+static bool copySignal(uint16_t, const SignalItem& item, void* context) {
+  SignalListBatch& batch = *static_cast<SignalListBatch*>(context);
+  batch.items[batch.count++] = item;
+  return batch.count < SIGNAL_LIST_BATCH;
+}
+
+// JSON字符串（转义引号、反斜杠和控制字符）
+static void writeJSONString(Print& out, const char* text) {
+  out.write('"');
+  for (const char* p = text; *p != '\0'; p++) {
+    char c = *p;
+    if (c == '"' || c == '\\') {
+      out.write('\\');
+      out.write(c);
+    } else if ((uint8_t)c < 0x20) {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out.print(escaped);
+    } else {
+      out.write(c);
+    }
+  }
+  out.write('"');
+}
+
+static void writeSignalJSON(Print& out, uint16_t index, const SignalItem& item) {
+  char code[RF_SIGNAL_HEX_LEN + 1];
+  char address[7];
+  char key[3];
+  item.signal.toHex(code);
+  snprintf(address, sizeof(address), "%06lX", (unsigned long)(item.signal.address() & 0xFFFFFF));
+  snprintf(key, sizeof(key), "%02X", item.signal.key());
+  out.print("{\"index\":");
+  out.print(index);
+  out.print(",\"name\":");
+  writeJSONString(out, item.name);
+  out.print(",\"code\":\"");
+  out.print(code);
+  out.print("\",\"bits\":");
+  out.print(item.signal.bits());
+  out.print(",\"address\":\"");
+  out.print(address);
+  out.print("\",\"key\":\"");
+  out.print(key);
+  out.print("\"");
+  if (item.signal.protocol == RF_PROTOCOL_RAW) {
+    out.print(",\"raw\":true");
+  }
+  out.print("}");
+  RF_TRACE("API", "Signal %d: %s (%s, %u位)", index, item.name, code, item.signal.bits());
+}
+
+// 信号列表：分块发送，内存占用与信号数量无关
+// 可选参数offset（起始索引）和limit（最多返回的数量），省略时返回全部
+void ESP433RFWeb::sendSignalList() {
+  uint16_t total = _signalMgr.getCount();
+  long offsetArg = _server->hasArg("offset") ? _server->arg("offset").toInt() : 0;
+  long limitArg = _server->hasArg("limit") ? _server->arg("limit").toInt() : total;
+  uint16_t offset = offsetArg < 0 ? 0 : (offsetArg > total ? total : offsetArg);
+  uint16_t limit = limitArg < 0 ? 0 : (limitArg > total - offset ? total - offset : limitArg);
+  RF_TRACE("API", "signal list: total=%u, offset=%u, limit=%u", total, offset, limit);
+  
+  _server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _server->send(200, "application/json", "");
+  WebChunkPrint out(*_server);
+  out.print("{\"code\":200,\"message\":\"成功\",\"total\":");
+  out.print(total);
+  out.print(",\"offset\":");
+  out.print(offset);
+  out.print(",\"data\":[");
   
-  String json = "[";
-  for (uint8_t i = 0; i < count; i++) {
-    if (i > 0) json += ",";
-    json += "{";
-    json += "\"name\":\"" + items[i].name + "\",";
-    json += "\"address\":\"" + items[i].signal.address + "\",";
-    json += "\"key\":\"" + items[i].signal.key + "\"";
-    json += "}";
-    Serial.printf("[API] Signal %d: %s (%s%s)\n", i, items[i].name.c_str(), 
-                 items[i].signal.address.c_str(), items[i].signal.key.c_str());
+  SignalListBatch batch;
+  uint16_t index = offset;
+  uint16_t end = offset + limit;
+  while (index < end) {
+    uint16_t wanted = end - index < SIGNAL_LIST_BATCH ? end - index : SIGNAL_LIST_BATCH;
+    batch.count = 0;
+    _signalMgr.forEachSignal(copySignal, &batch, index, wanted);
+    for (uint8_t i = 0; i < batch.count; i++) {
+      if (index > offset) {
+        out.print(",");
+      }
+      writeSignalJSON(out, index++, batch.items[i]);
+    }
+    if (batch.count < wanted) {
+      break;  // 发送期间信号被删除，列表变短
+    }
   }
-  json += "]";
   
-  delete[] items;
-  Serial.printf("[API] JSON: %s\n", json.c_str());
-  return json;
+  out.print("]}");
+  out.flush();
+  _server->sendContent("");  // 结束块
 }
-#endif
\ No newline at end of file
+#endif
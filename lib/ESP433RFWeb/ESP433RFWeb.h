@@ -1,7 +1,9 @@
 /*
  * ESP433RFWeb - 433MHz信号Web管理界面库
  * 
- * 提供WiFi AP模式和Web管理界面，支持信号列表查看、添加、删除、发送
+ * 提供WiFi AP模式和Web管理界面，支持信号列表查看、添加、删除、发送、批量发送
+ * 信号列表（/api?action=list）分块发送，支持offset/limit分页
+ * /metrics以Prometheus文本格式输出运行指标（见RFMetrics.h）
  * 
  * Author: Zhoushoujian
  * License: MIT
@@ -40,7 +42,7 @@ public:
   void setCaptureModeCallback(CaptureModeCallback callback);
   
   // Boot按钮绑定
-  int8_t getBootBoundIndex() { return _bootBoundIndex; }
+  int32_t getBootBoundIndex() { return _bootBoundIndex; }
   
 private:
   ESP433RF& _rf;
@@ -52,14 +54,17 @@ private:
   String _apPassword;
   bool _apStarted;
   CaptureModeCallback _captureCallback;
-  int8_t _bootBoundIndex;  // Boot按钮绑定的信号索引（-1表示未绑定）
+  int32_t _bootBoundIndex;  // Boot按钮绑定的信号索引（-1表示未绑定）
   
   // Web路由处理函数
   void handleRoot();
   void handleAPI();
   void handleNotFound();
+  void handleMetrics();
+  void runHandler(void (ESP433RFWeb::*handler)());
   void sendJSONResponse(int code, const String& message, const String& data = "");
-  String getSignalListJSON();
+  void sendSignalList();
+  static uint8_t parseBatchItems(const String& text, uint16_t defaultGap, SignalBatchItem* items, uint8_t maxCount);
   #endif
 };
 
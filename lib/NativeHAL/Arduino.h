@@ -0,0 +1,112 @@
+/*
+ * Arduino.h - Host implementation of the Arduino-ESP32 core subset
+ *
+ * Part of NativeHAL, the hardware fakes of the `native` PlatformIO
+ * environment (see NativeHAL.h). Time is the host's steady clock, GPIO
+ * levels and edge interrupts are simulated in memory, delay() blocks the
+ * calling task and delayMicroseconds() busy-waits like on the device.
+ *
+ * Interrupt handlers run synchronously in the thread that changes the pin
+ * level (the task writing an output, or the host driving an input), one
+ * handler at a time.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "WString.h"
+#include "Print.h"
+#include "HardwareSerial.h"
+
+using std::abs;
+using std::max;
+using std::min;
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+// 宿主上没有IRAM/DRAM之分
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define memcpy_P memcpy
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+#define LOW 0x0
+#define HIGH 0x1
+
+// Pin modes (ESP32 values)
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+#define OPEN_DRAIN 0x10
+#define OUTPUT_OPEN_DRAIN 0x12
+
+// Interrupt modes
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define ONLOW 0x04
+#define ONHIGH 0x05
+
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) (p)
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+
+// Time
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// GPIO
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+// Random numbers
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+// Memory
+bool psramFound();
+
+// Sketch entry points
+void setup();
+void loop();
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,159 @@
+/*
+ * HardwareSerial - UART ports and the console
+ */
+
+#include "NativeInternal.h"
+#include "NativeHAL.h"
+
+// Arduino-ESP32默认的接收缓冲区大小
+#define NATIVE_UART_DEFAULT_RX_BUFFER 256
+
+static FILE* consoleOut = stdout;
+static std::mutex consoleMutex;
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+NativeUartPort* nativeUart(int port) {
+  static NativeUartPort ports[NATIVE_UART_COUNT];
+  static std::once_flag initialized;
+  std::call_once(initialized, []() {
+    for (NativeUartPort& p : ports) {
+      p.mode = NATIVE_UART_CLOSED;
+      p.rxCapacity = NATIVE_UART_DEFAULT_RX_BUFFER;
+      p.arduinoRxCapacity = NATIVE_UART_DEFAULT_RX_BUFFER;
+      p.rxRead = 0;
+      p.rxWritten = 0;
+      p.dropped = 0;
+      p.events = nullptr;
+      p.patternEnabled = false;
+      p.pattern = 0;
+      p.patternQueueLength = 0;
+    }
+  });
+  if (port < 0 || port >= NATIVE_UART_COUNT) {
+    return nullptr;
+  }
+  return &ports[port];
+}
+
+void nativeConsoleWrite(const uint8_t* data, size_t length) {
+  std::lock_guard<std::mutex> lock(consoleMutex);
+  if (consoleOut == nullptr) {
+    return;
+  }
+  fwrite(data, 1, length, consoleOut);
+  if (memchr(data, '\n', length) != nullptr) {
+    fflush(consoleOut);
+  }
+}
+
+void nativeSetConsole(FILE* out) {
+  std::lock_guard<std::mutex> lock(consoleMutex);
+  if (consoleOut != nullptr) {
+    fflush(consoleOut);
+  }
+  consoleOut = out;
+}
+
+HardwareSerial::HardwareSerial(int uartNum) {
+  _uartNum = uartNum;
+  _baud = 0;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin,
+                           bool invert, unsigned long timeoutMs, uint8_t rxfifoFullThreshold) {
+  (void)config;
+  (void)rxPin;
+  (void)txPin;
+  (void)invert;
+  (void)timeoutMs;
+  (void)rxfifoFullThreshold;
+  NativeUartPort* port = nativeUart(_uartNum);
+  std::lock_guard<std::mutex> lock(port->mutex);
+  _baud = baud;
+  // 已安装的IDF驱动由HardwareSerial接管（与Arduino-ESP32一致）
+  if (port->mode == NATIVE_UART_DRIVER && port->events != nullptr) {
+    vQueueDelete(port->events);
+    port->events = nullptr;
+  }
+  port->mode = NATIVE_UART_ARDUINO;
+  port->rxCapacity = port->arduinoRxCapacity;
+  port->patternEnabled = false;
+  port->patternPositions.clear();
+  port->rx.reset(port->rxCapacity);
+}
+
+void HardwareSerial::end(bool fullyTerminate) {
+  (void)fullyTerminate;
+  NativeUartPort* port = nativeUart(_uartNum);
+  std::lock_guard<std::mutex> lock(port->mutex);
+  if (port->mode != NATIVE_UART_ARDUINO) {
+    return;
+  }
+  port->mode = NATIVE_UART_CLOSED;
+  port->rx.clear();
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t size) {
+  NativeUartPort* port = nativeUart(_uartNum);
+  std::lock_guard<std::mutex> lock(port->mutex);
+  if (port->mode == NATIVE_UART_ARDUINO) {
+    return 0;  // 与设备一致：只能在begin()之前设置
+  }
+  port->arduinoRxCapacity = size;
+  return size;
+}
+
+int HardwareSerial::available() {
+  NativeUartPort* port = nativeUart(_uartNum);
+  std::lock_guard<std::mutex> lock(port->mutex);
+  return port->mode == NATIVE_UART_ARDUINO ? (int)port->rx.size() : 0;
+}
+
+int HardwareSerial::peek() {
+  NativeUartPort* port = nativeUart(_uartNum);
+  std::lock_guard<std::mutex> lock(port->mutex);
+  if (port->mode != NATIVE_UART_ARDUINO || port->rx.empty()) {
+    return -1;
+  }
+  return port->rx.front();
+}
+
+int HardwareSerial::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t HardwareSerial::read(uint8_t* buffer, size_t size) {
+  NativeUartPort* port = nativeUart(_uartNum);
+  std::lock_guard<std::mutex> lock(port->mutex);
+  if (port->mode != NATIVE_UART_ARDUINO) {
+    return 0;
+  }
+  size_t n = 0;
+  while (n < size && !port->rx.empty()) {
+    buffer[n++] = port->rx.front();
+    port->rx.pop_front();
+  }
+  port->rxRead += n;
+  return n;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  // 只有控制台有意义；其他UART的发送数据丢弃（接收模块不接收命令）
+  if (_uartNum == 0) {
+    nativeConsoleWrite(buffer, size);
+  }
+  return size;
+}
+
+void HardwareSerial::flush() {
+  if (_uartNum == 0) {
+    std::lock_guard<std::mutex> lock(consoleMutex);
+    if (consoleOut != nullptr) {
+      fflush(consoleOut);
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/*
+ * HardwareSerial.h - Host implementation of the ESP32 HardwareSerial
+ *
+ * Serial (UART0) writes to the console (stdout unless redirected with
+ * nativeSetConsole()); its input and that of the other UARTs come from
+ * nativeUartInject(). The receive buffer is shared with the IDF UART
+ * driver (driver/uart.h) of the same port.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include "Print.h"
+
+#define SERIAL_8N1 0x800001c
+#define SERIAL_8E1 0x800001e
+#define SERIAL_8O1 0x800001f
+
+class HardwareSerial : public Stream {
+public:
+  HardwareSerial(int uartNum);
+  
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1,
+             bool invert = false, unsigned long timeoutMs = 20000UL, uint8_t rxfifoFullThreshold = 112);
+  void end(bool fullyTerminate = true);
+  size_t setRxBufferSize(size_t size);
+  uint32_t baudRate() { return _baud; }
+  operator bool() const { return true; }
+  
+  int available() override;
+  int availableForWrite() { return 128; }
+  int peek() override;
+  int read() override;
+  size_t read(uint8_t* buffer, size_t size);
+  size_t read(char* buffer, size_t size) { return read((uint8_t*)buffer, size); }
+  
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+
+private:
+  int _uartNum;
+  uint32_t _baud;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // NATIVE_HARDWARE_SERIAL_H
@@ -0,0 +1,329 @@
+/*
+ * NativeArduino - Time, GPIO, random numbers and memory of the simulated board
+ */
+
+#include "NativeInternal.h"
+#include "NativeHAL.h"
+#include <esp_heap_caps.h>
+#include <driver/gpio.h>
+#include <atomic>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <random>
+#include <thread>
+
+// ========== Time ==========
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+uint64_t nativeMicros64() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void nativeSleepUntil(uint64_t timeUs) {
+  // 先睡眠到目标前约1ms，剩下的忙等（线程唤醒延迟不影响脉宽）
+  while (true) {
+    uint64_t now = nativeMicros64();
+    if (now >= timeUs) {
+      return;
+    }
+    if (timeUs - now > 1500) {
+      std::this_thread::sleep_for(std::chrono::microseconds(timeUs - now - 1000));
+    }
+  }
+}
+
+unsigned long millis() {
+  return (unsigned long)(nativeMicros64() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)nativeMicros64();
+}
+
+void delay(uint32_t ms) {
+  vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  nativeSleepUntil(nativeMicros64() + us);
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+// ========== GPIO ==========
+
+struct NativePin {
+  std::atomic<uint8_t> level;
+  uint8_t mode;
+  uint8_t link;  // 连接的输入引脚（255 = 无）
+  int interruptMode;
+  void (*handler)(void);
+  void (*handlerArg)(void*);
+  void* arg;
+};
+
+static NativePin pins[NATIVE_GPIO_COUNT];
+static std::once_flag pinsInitialized;
+
+// 中断锁：串行化所有中断处理函数（单个中断控制器），detachInterrupt等待正在执行的处理函数
+static std::recursive_mutex interruptMutex;
+static NativePinListener pinListener = nullptr;
+static void* pinListenerContext = nullptr;
+
+static NativePin* pinAt(uint8_t pin) {
+  std::call_once(pinsInitialized, []() {
+    for (NativePin& p : pins) {
+      p.level = LOW;
+      p.mode = INPUT;
+      p.link = 255;
+      p.interruptMode = 0;
+      p.handler = nullptr;
+      p.handlerArg = nullptr;
+      p.arg = nullptr;
+    }
+  });
+  return pin < NATIVE_GPIO_COUNT ? &pins[pin] : nullptr;
+}
+
+// 调用者持有interruptMutex
+static void setLevelLocked(uint8_t pin, uint8_t level, uint32_t timeUs) {
+  NativePin* p = pinAt(pin);
+  level = level ? HIGH : LOW;
+  if (p == nullptr || p->level.load() == level) {
+    return;
+  }
+  p->level = level;
+  if (pinListener != nullptr) {
+    pinListener(pin, level, timeUs, pinListenerContext);
+  }
+  bool fire = false;
+  switch (p->interruptMode) {
+    case RISING:  fire = level == HIGH; break;
+    case FALLING: fire = level == LOW; break;
+    case CHANGE:  fire = true; break;
+    case ONHIGH:  fire = level == HIGH; break;
+    case ONLOW:   fire = level == LOW; break;
+  }
+  if (fire) {
+    if (p->handlerArg != nullptr) {
+      p->handlerArg(p->arg);
+    } else if (p->handler != nullptr) {
+      p->handler();
+    }
+  }
+  if (p->link != 255) {
+    setLevelLocked(p->link, level, timeUs);
+  }
+}
+
+void nativeWritePin(uint8_t pin, uint8_t level, uint32_t timeUs) {
+  std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+  setLevelLocked(pin, level, timeUs);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  NativePin* p = pinAt(pin);
+  if (p == nullptr) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+  p->mode = mode;
+  // 上拉/下拉决定悬空输入的电平（如按键未按下时为高）
+  if (mode == INPUT_PULLUP) {
+    setLevelLocked(pin, HIGH, micros());
+  } else if (mode == INPUT_PULLDOWN) {
+    setLevelLocked(pin, LOW, micros());
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  nativeWritePin(pin, val, micros());
+}
+
+int digitalRead(uint8_t pin) {
+  NativePin* p = pinAt(pin);
+  return p != nullptr ? p->level.load() : LOW;
+}
+
+uint16_t analogRead(uint8_t pin) {
+  (void)pin;
+  return (uint16_t)(esp_random() & 0x0FFF);  // 悬空引脚的噪声
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+  NativePin* p = pinAt(pin);
+  if (p == nullptr) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+  p->handler = handler;
+  p->handlerArg = nullptr;
+  p->arg = nullptr;
+  p->interruptMode = mode;
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+  NativePin* p = pinAt(pin);
+  if (p == nullptr) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+  p->handler = nullptr;
+  p->handlerArg = handler;
+  p->arg = arg;
+  p->interruptMode = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+  NativePin* p = pinAt(pin);
+  if (p == nullptr) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+  p->handler = nullptr;
+  p->handlerArg = nullptr;
+  p->arg = nullptr;
+  p->interruptMode = 0;
+}
+
+void nativeSetPinListener(NativePinListener listener, void* context) {
+  std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+  pinListener = listener;
+  pinListenerContext = context;
+}
+
+void nativeSetPin(uint8_t pin, uint8_t level) {
+  nativeWritePin(pin, level, micros());
+}
+
+void nativePlayPulses(uint8_t pin, const uint16_t* pulses, size_t count) {
+  uint64_t edge = nativeMicros64();
+  for (size_t i = 0; i < count; i++) {
+    nativeSleepUntil(edge);
+    nativeWritePin(pin, (pulses[i] & 0x8000) ? HIGH : LOW, (uint32_t)edge);
+    edge += pulses[i] & 0x7FFF;
+  }
+  // 最后一段电平在下一次跳变时才被测量
+  nativeSleepUntil(edge);
+  nativeWritePin(pin, LOW, (uint32_t)edge);
+}
+
+void nativeLinkPins(uint8_t output, uint8_t input) {
+  NativePin* p = pinAt(output);
+  if (p == nullptr) {
+    return;
+  }
+  std::lock_guard<std::recursive_mutex> lock(interruptMutex);
+  p->link = input < NATIVE_GPIO_COUNT ? input : 255;
+  if (p->link != 255) {
+    setLevelLocked(p->link, p->level.load(), micros());
+  }
+}
+
+// ========== Random numbers ==========
+
+static std::mutex randomMutex;
+static std::mt19937 randomEngine(std::random_device{}());
+
+uint32_t esp_random() {
+  std::lock_guard<std::mutex> lock(randomMutex);
+  return randomEngine();
+}
+
+long random(long max) {
+  return max <= 0 ? 0 : (long)(esp_random() % (uint32_t)max);
+}
+
+long random(long min, long max) {
+  return min >= max ? min : min + random(max - min);
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    std::lock_guard<std::mutex> lock(randomMutex);
+    randomEngine.seed(seed);
+  }
+}
+
+// ========== Memory ==========
+
+static std::atomic<bool> psramAvailable(false);
+
+bool psramFound() {
+  return psramAvailable.load();
+}
+
+void nativeSetPSRAM(bool available) {
+  psramAvailable = available;
+}
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+  if ((caps & MALLOC_CAP_SPIRAM) && !psramAvailable.load()) {
+    return nullptr;
+  }
+  return malloc(size);
+}
+
+void* heap_caps_calloc(size_t count, size_t size, uint32_t caps) {
+  if ((caps & MALLOC_CAP_SPIRAM) && !psramAvailable.load()) {
+    return nullptr;
+  }
+  return calloc(count, size);
+}
+
+void heap_caps_free(void* ptr) {
+  free(ptr);
+}
+
+static std::atomic<size_t> heapMinFree(NATIVE_HEAP_SIZE);
+
+size_t heap_caps_get_total_size(uint32_t caps) {
+  if (caps & MALLOC_CAP_SPIRAM) {
+    return psramAvailable.load() ? NATIVE_PSRAM_SIZE : 0;
+  }
+  return NATIVE_HEAP_SIZE;
+}
+
+// 进程用malloc分配的字节数计入内部堆（PSRAM只报告总大小，不区分分配来源）
+size_t heap_caps_get_free_size(uint32_t caps) {
+  if (caps & MALLOC_CAP_SPIRAM) {
+    return heap_caps_get_total_size(caps);
+  }
+  size_t used = 0;
+  #if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  used = mallinfo2().uordblks;
+  #endif
+  size_t available = used < NATIVE_HEAP_SIZE ? NATIVE_HEAP_SIZE - used : 0;
+  size_t low = heapMinFree.load();
+  while (available < low && !heapMinFree.compare_exchange_weak(low, available)) {
+  }
+  return available;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+  if (caps & MALLOC_CAP_SPIRAM) {
+    return heap_caps_get_total_size(caps);
+  }
+  heap_caps_get_free_size(caps);
+  return heapMinFree.load();
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  return heap_caps_get_free_size(caps);
+}
+
+// ========== Run control ==========
+
+static std::atomic<bool> stopRequested(false);
+
+void nativeRequestStop() {
+  stopRequested = true;
+}
+
+bool nativeStopRequested() {
+  return stopRequested.load();
+}
@@ -0,0 +1,311 @@
+/*
+ * NativeFreeRTOS - FreeRTOS API on std::thread
+ */
+
+#include "NativeInternal.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct NativeTask {
+  std::string name;
+  std::mutex mutex;
+  std::condition_variable cond;  // 通知和任务结束
+  uint32_t notifyValue;
+  std::atomic<bool> deleted;
+  bool finished;
+  bool hasThread;  // false：loop()所在的主线程
+};
+
+struct NativeQueue {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::vector<uint8_t> storage;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+  UBaseType_t head;
+  UBaseType_t count;
+};
+
+struct NativeSemaphore {
+  std::mutex mutex;
+  std::condition_variable cond;
+  UBaseType_t count;
+  UBaseType_t maxCount;
+};
+
+// 任务控制块不释放：vTaskDelete之后中断里的通知仍可能指向它
+static thread_local NativeTask* currentTask = nullptr;
+static std::recursive_mutex criticalMutex;
+
+static NativeTask* newTask(const char* name, bool hasThread) {
+  NativeTask* task = new NativeTask();
+  task->name = name != nullptr ? name : "";
+  task->notifyValue = 0;
+  task->deleted = false;
+  task->finished = false;
+  task->hasThread = hasThread;
+  return task;
+}
+
+static NativeTask* selfTask() {
+  if (currentTask == nullptr) {
+    currentTask = newTask("loopTask", false);
+  }
+  return currentTask;
+}
+
+void nativeCheckDeleted() {
+  if (currentTask != nullptr && currentTask->deleted.load()) {
+    throw NativeTaskExit();
+  }
+}
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+  criticalMutex.lock();
+  mux->count++;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+  mux->count--;
+  criticalMutex.unlock();
+}
+
+// ========== Tasks ==========
+
+static void taskThread(NativeTask* task, TaskFunction_t function, void* parameters) {
+  currentTask = task;
+  try {
+    function(parameters);
+    // 与设备一致：任务函数不能返回，必须vTaskDelete(nullptr)
+    fprintf(stderr, "[NativeHAL] 任务%s返回而没有删除自身\n", task->name.c_str());
+    abort();
+  } catch (const NativeTaskExit&) {
+  }
+  std::lock_guard<std::mutex> lock(task->mutex);
+  task->finished = true;
+  task->cond.notify_all();
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* created) {
+  (void)stackDepth;
+  (void)priority;
+  NativeTask* task = newTask(name, true);
+  if (created != nullptr) {
+    *created = task;
+  }
+  std::thread(taskThread, task, function, parameters).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* created, BaseType_t core) {
+  (void)core;
+  return xTaskCreate(function, name, stackDepth, parameters, priority, created);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  NativeTask* self = selfTask();
+  if (task == nullptr || task == self) {
+    self->deleted = true;
+    throw NativeTaskExit();
+  }
+  task->deleted = true;
+  if (!task->hasThread) {
+    return;  // loop()在下一次阻塞调用时结束
+  }
+  // 等待任务在下一次阻塞调用处退出
+  std::unique_lock<std::mutex> lock(task->mutex);
+  task->cond.notify_all();
+  task->cond.wait(lock, [task]() { return task->finished; });
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::unique_lock<std::mutex> lock(mutex);
+  nativeWait(lock, cond, ticks, []() { return false; });
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)(nativeMicros64() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return selfTask();
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+  return (task != nullptr ? task : selfTask())->name.c_str();
+}
+
+// ========== Notifications ==========
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  std::lock_guard<std::mutex> lock(task->mutex);
+  task->notifyValue++;
+  task->cond.notify_all();
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+  xTaskNotifyGive(task);
+  if (higherPriorityTaskWoken != nullptr) {
+    *higherPriorityTaskWoken = pdTRUE;
+  }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticks) {
+  NativeTask* self = selfTask();
+  std::unique_lock<std::mutex> lock(self->mutex);
+  if (!nativeWait(lock, self->cond, ticks, [self]() { return self->notifyValue > 0; })) {
+    return 0;
+  }
+  uint32_t value = self->notifyValue;
+  self->notifyValue = clearCountOnExit ? 0 : value - 1;
+  return value;
+}
+
+// ========== Queues ==========
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  if (length == 0) {
+    return nullptr;
+  }
+  NativeQueue* queue = new NativeQueue();
+  queue->storage.resize((size_t)length * itemSize);
+  queue->length = length;
+  queue->itemSize = itemSize;
+  queue->head = 0;
+  queue->count = 0;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+  delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!nativeWait(lock, queue->cond, ticks, [queue]() { return queue->count < queue->length; })) {
+    return errQUEUE_FULL;
+  }
+  UBaseType_t slot = (queue->head + queue->count) % queue->length;
+  memcpy(&queue->storage[(size_t)slot * queue->itemSize], item, queue->itemSize);
+  queue->count++;
+  queue->cond.notify_all();
+  return pdPASS;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks) {
+  return xQueueSend(queue, item, ticks);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* higherPriorityTaskWoken) {
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  if (queue->count >= queue->length) {
+    return errQUEUE_FULL;
+  }
+  UBaseType_t slot = (queue->head + queue->count) % queue->length;
+  memcpy(&queue->storage[(size_t)slot * queue->itemSize], item, queue->itemSize);
+  queue->count++;
+  queue->cond.notify_all();
+  if (higherPriorityTaskWoken != nullptr) {
+    *higherPriorityTaskWoken = pdTRUE;
+  }
+  return pdPASS;
+}
+
+static BaseType_t queueTake(QueueHandle_t queue, void* item, TickType_t ticks, bool remove) {
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!nativeWait(lock, queue->cond, ticks, [queue]() { return queue->count > 0; })) {
+    return errQUEUE_EMPTY;
+  }
+  memcpy(item, &queue->storage[(size_t)queue->head * queue->itemSize], queue->itemSize);
+  if (remove) {
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    queue->cond.notify_all();
+  }
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+  return queueTake(queue, item, ticks, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticks) {
+  return queueTake(queue, item, ticks, false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  queue->head = 0;
+  queue->count = 0;
+  queue->cond.notify_all();
+  return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  return queue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  return queue->length - queue->count;
+}
+
+// ========== Semaphores ==========
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+  NativeSemaphore* semaphore = new NativeSemaphore();
+  semaphore->count = initialCount;
+  semaphore->maxCount = maxCount;
+  return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+  return xSemaphoreCreateCounting(1, 0);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+  delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(semaphore->mutex);
+  if (!nativeWait(lock, semaphore->cond, ticks, [semaphore]() { return semaphore->count > 0; })) {
+    return pdFALSE;
+  }
+  semaphore->count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  std::lock_guard<std::mutex> lock(semaphore->mutex);
+  if (semaphore->count >= semaphore->maxCount) {
+    return pdFALSE;
+  }
+  semaphore->count++;
+  semaphore->cond.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higherPriorityTaskWoken) {
+  if (higherPriorityTaskWoken != nullptr) {
+    *higherPriorityTaskWoken = pdFALSE;
+  }
+  return xSemaphoreGive(semaphore);
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t semaphore) {
+  std::lock_guard<std::mutex> lock(semaphore->mutex);
+  return semaphore->count;
+}
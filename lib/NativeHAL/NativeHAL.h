@@ -0,0 +1,117 @@
+/*
+ * NativeHAL - Host-side control of the simulated hardware
+ *
+ * The `native` PlatformIO environment builds the firmware and the libraries
+ * for the host against in-memory fakes of the Arduino-ESP32 core and the
+ * IDF drivers they use, so the receive parser, SignalManager and the
+ * persistence logic run without a board:
+ *
+ *   - FreeRTOS tasks, queues, semaphores and notifications on std::thread
+ *   - GPIO levels with edge interrupts; an output can be wired to an input
+ *     (simulated radio: the transmitter pin feeds the raw receiver pin)
+ *   - UARTs: HardwareSerial and the IDF event driver, fed by the host
+ *     (simulated receiver module lines such as "LC:62E7E831")
+ *   - RMT transmit played out on the GPIO in real time
+ *   - NVS (Preferences) in memory, with the namespace/key limits and the
+ *     entry capacity of the device, loadable from and savable to a file
+ *   - WiFi soft AP and WebServer driven by injected HTTP requests
+ *
+ * The functions below are the host's side of that hardware: what the
+ * device would get from the radio, the serial lines, the flash and the
+ * network. They can be called from any thread.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <Arduino.h>
+
+// ========== GPIO ==========
+
+// Called on every level change of any pin, under the interrupt lock.
+// timeUs is micros() at the edge (the ideal edge time for RMT output).
+typedef void (*NativePinListener)(uint8_t pin, uint8_t level, uint32_t timeUs, void* context);
+
+void nativeSetPinListener(NativePinListener listener, void* context);
+
+// Drive an input pin from outside (button, receiver data line)
+void nativeSetPin(uint8_t pin, uint8_t level);
+
+// Drive an input pin with a pulse sequence in real time. Each pulse is
+// level (bit 15) | duration in us (bits 0-14), the format of RFDecoder.h.
+// The pin is left low afterwards. Blocks for the total duration.
+void nativePlayPulses(uint8_t pin, const uint16_t* pulses, size_t count);
+
+// Wire an output pin to an input pin: every level written to `output` is
+// also driven on `input` (255 removes the link)
+void nativeLinkPins(uint8_t output, uint8_t input);
+
+// ========== UART ==========
+
+// Bytes arriving on a UART's RX line. Returns the bytes accepted into the
+// receive buffer (0 when the port is not open); the rest are dropped.
+size_t nativeUartInject(uint8_t port, const uint8_t* data, size_t length);
+size_t nativeUartInject(uint8_t port, const char* text);
+
+// Bytes dropped on a port (not open or receive buffer full)
+uint32_t nativeUartDropped(uint8_t port);
+
+// Where Serial (UART0) output goes; nullptr discards it. Default stdout.
+void nativeSetConsole(FILE* out);
+
+// ========== Flash (NVS) ==========
+
+struct NativeFlashStats {
+  uint32_t writes;        // put*() calls that changed flash
+  uint32_t bytesWritten;  // Value bytes written
+  uint32_t erases;        // remove() and clear() calls
+  uint32_t reads;         // get*() calls
+  uint32_t usedEntries;   // 32-byte NVS entries in use
+  uint32_t totalEntries;
+};
+
+NativeFlashStats nativeFlashStats();
+void nativeResetFlashStats();
+
+// NVS capacity in 32-byte entries (default: the 20KB "nvs" partition)
+void nativeSetFlashEntries(uint32_t entries);
+
+// Erase all namespaces
+void nativeEraseFlash();
+
+// Load/save the whole NVS content (a private binary format)
+bool nativeLoadFlash(const char* path);
+bool nativeSaveFlash(const char* path);
+
+// ========== Memory ==========
+
+// Whether psramFound() reports PSRAM and MALLOC_CAP_SPIRAM allocations succeed
+void nativeSetPSRAM(bool available);
+
+// ========== Network ==========
+
+struct NativeHttpResponse {
+  int code;
+  String contentType;
+  String body;
+  uint32_t chunks;  // sendContent() calls (chunked responses)
+};
+
+// Send a request (method "GET"/"POST"/..., uri with query string, optional
+// form body) to the WebServer listening on `port` and wait for its
+// response. The request is handled in the thread calling handleClient(),
+// so this must not be called from that thread. Returns false when no
+// server is listening or it did not respond in time.
+bool nativeHttpRequest(const char* method, const char* uri, const char* body,
+                       NativeHttpResponse& response, uint16_t port = 80, uint32_t timeoutMs = 2000);
+
+// ========== Run control ==========
+
+// Ask the native main loop to return after the current loop()
+void nativeRequestStop();
+bool nativeStopRequested();
+
+#endif // NATIVE_HAL_H
@@ -0,0 +1,144 @@
+/*
+ * NativeInternal - Shared internals of the NativeHAL implementation files
+ *
+ * Not part of the simulated API: only included by NativeHAL sources.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_INTERNAL_H
+#define NATIVE_INTERNAL_H
+
+#include <Arduino.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Thrown in a task deleted by vTaskDelete() when it reaches a blocking call;
+// caught by the task's thread entry
+struct NativeTaskExit {};
+
+// Throws NativeTaskExit when the calling task has been deleted
+void nativeCheckDeleted();
+
+// Longest uninterrupted wait: a deleted task notices within one slice
+#define NATIVE_WAIT_SLICE_MS 5
+
+// Wait until ready() or `ticks` (ms, portMAX_DELAY = forever) elapse.
+// Every blocking FreeRTOS/driver call goes through here.
+template <class Predicate>
+bool nativeWait(std::unique_lock<std::mutex>& lock, std::condition_variable& cond, TickType_t ticks, Predicate ready) {
+  nativeCheckDeleted();
+  if (ready()) {
+    return true;
+  }
+  if (ticks == 0) {
+    return false;
+  }
+  auto start = std::chrono::steady_clock::now();
+  auto deadline = start + std::chrono::milliseconds(ticks);
+  while (true) {
+    auto slice = std::chrono::steady_clock::now() + std::chrono::milliseconds(NATIVE_WAIT_SLICE_MS);
+    if (ticks != portMAX_DELAY && deadline < slice) {
+      slice = deadline;
+    }
+    cond.wait_until(lock, slice);
+    nativeCheckDeleted();
+    if (ready()) {
+      return true;
+    }
+    if (ticks != portMAX_DELAY && std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+  }
+}
+
+// Microseconds since start (not truncated like micros() on the device)
+uint64_t nativeMicros64();
+
+// Sleep, then spin, until the given nativeMicros64() time (pulse-accurate pacing)
+void nativeSleepUntil(uint64_t timeUs);
+
+// Set a pin level and run edge interrupts, links and the pin listener;
+// timeUs is the reported edge time (RMT playback passes the ideal time)
+void nativeWritePin(uint8_t pin, uint8_t level, uint32_t timeUs);
+
+// Fixed-capacity FIFO, allocated by reset() when a port is opened; pushing
+// and popping never allocate, so simulated input does not show up in the
+// allocation counts of benchmarks (like the driver's preallocated ring)
+template <typename T>
+class NativeRing {
+public:
+  NativeRing() : _items(nullptr), _capacity(0), _head(0), _count(0) {}
+  ~NativeRing() { delete[] _items; }
+  
+  void reset(size_t capacity) {
+    if (capacity != _capacity) {
+      delete[] _items;
+      _items = capacity > 0 ? new T[capacity] : nullptr;
+      _capacity = capacity;
+    }
+    clear();
+  }
+  void clear() { _head = 0; _count = 0; }
+  size_t size() const { return _count; }
+  bool empty() const { return _count == 0; }
+  T front() const { return _items[_head]; }
+  bool push_back(T value) {
+    if (_count >= _capacity) {
+      return false;
+    }
+    _items[(_head + _count) % _capacity] = value;
+    _count++;
+    return true;
+  }
+  void pop_front() {
+    _head = (_head + 1) % _capacity;
+    _count--;
+  }
+
+private:
+  T* _items;
+  size_t _capacity;
+  size_t _head;
+  size_t _count;
+  
+  NativeRing(const NativeRing&) = delete;
+  NativeRing& operator=(const NativeRing&) = delete;
+};
+
+// UART port shared by HardwareSerial and the IDF driver (driver/uart.h)
+enum NativeUartMode : uint8_t {
+  NATIVE_UART_CLOSED,    // 未打开：到达的数据丢弃
+  NATIVE_UART_ARDUINO,   // HardwareSerial
+  NATIVE_UART_DRIVER     // uart_driver_install（事件队列 + 模式检测）
+};
+
+struct NativeUartPort {
+  std::mutex mutex;
+  std::condition_variable cond;
+  NativeUartMode mode;
+  NativeRing<uint8_t> rx;    // rxCapacity字节
+  size_t rxCapacity;
+  size_t arduinoRxCapacity;  // setRxBufferSize()
+  uint64_t rxRead;           // 已读出的字节总数（模式位置换算）
+  uint64_t rxWritten;        // 已写入缓冲区的字节总数
+  uint32_t dropped;
+  
+  // IDF驱动
+  QueueHandle_t events;
+  bool patternEnabled;
+  char pattern;
+  NativeRing<uint64_t> patternPositions;  // 模式字符的绝对位置（patternQueueLength个）
+  size_t patternQueueLength;
+};
+
+#define NATIVE_UART_COUNT 3
+
+NativeUartPort* nativeUart(int port);
+
+// Write bytes to the console (UART0 TX)
+void nativeConsoleWrite(const uint8_t* data, size_t length);
+
+#endif // NATIVE_INTERNAL_H
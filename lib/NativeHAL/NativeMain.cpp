@@ -0,0 +1,141 @@
+/*
+ * NativeMain - Entry point of the native (host) build
+ *
+ * Runs setup() once and then loop() until stopped, like the Arduino
+ * loopTask. Kept in its own file so that a host program with its own
+ * main() (benchmarks) can link the rest of NativeHAL.
+ *
+ * Options:
+ *   --run-ms N       stop after N ms (default: until Ctrl+C)
+ *   --link OUT:IN    wire output pin OUT to input pin IN (radio loopback)
+ *   --nvs FILE       load the flash from FILE at start, save it on exit
+ *   --module-uart N  UART of the receiver module for "rx" commands (default 1)
+ *   --psram          report PSRAM as present
+ *
+ * Console commands on stdin (one per line):
+ *   rx <text>               <text>\r\n arrives from the receiver module
+ *   get <uri>               HTTP GET to the web server, response printed
+ *   post <uri> [body]       HTTP POST with a form body
+ *   pin <n> <0|1>           drive an input pin (e.g. the replay button)
+ *   anything else           typed into Serial
+ */
+
+#include "NativeHAL.h"
+#include "NativeInternal.h"
+#include <signal.h>
+#include <iostream>
+#include <string>
+#include <thread>
+
+static const char* flashPath = nullptr;
+static uint8_t moduleUart = 1;
+
+static void onSignal(int) {
+  nativeRequestStop();
+}
+
+static void printResponse(bool ok, const NativeHttpResponse& response) {
+  if (!ok) {
+    fprintf(stderr, "[NativeHAL] HTTP请求失败（服务器未启动或未响应）\n");
+    return;
+  }
+  fprintf(stderr, "[NativeHAL] HTTP %d %s\n%s\n", response.code, response.contentType.c_str(), response.body.c_str());
+}
+
+static void handleCommand(const std::string& line) {
+  if (line.compare(0, 3, "rx ") == 0) {
+    std::string text = line.substr(3) + "\r\n";
+    nativeUartInject(moduleUart, text.c_str());
+  } else if (line.compare(0, 4, "get ") == 0) {
+    NativeHttpResponse response;
+    printResponse(nativeHttpRequest("GET", line.substr(4).c_str(), nullptr, response), response);
+  } else if (line.compare(0, 5, "post ") == 0) {
+    std::string rest = line.substr(5);
+    size_t space = rest.find(' ');
+    std::string uri = rest.substr(0, space);
+    std::string body = space != std::string::npos ? rest.substr(space + 1) : "";
+    NativeHttpResponse response;
+    printResponse(nativeHttpRequest("POST", uri.c_str(), body.c_str(), response), response);
+  } else if (line.compare(0, 4, "pin ") == 0) {
+    unsigned pin = 0;
+    unsigned level = 0;
+    if (sscanf(line.c_str() + 4, "%u %u", &pin, &level) == 2) {
+      nativeSetPin(pin, level);
+    }
+  } else {
+    std::string text = line + "\n";
+    nativeUartInject(0, text.c_str());
+  }
+}
+
+// 控制台输入在单独的线程中读取（loop()所在的主线程处理HTTP请求）
+static void consoleThread() {
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (!line.empty()) {
+      handleCommand(line);
+    }
+  }
+}
+
+static int usage(const char* program) {
+  fprintf(stderr, "用法: %s [--run-ms N] [--link OUT:IN] [--nvs FILE] [--module-uart N] [--psram]\n", program);
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  long runMs = -1;
+  for (int i = 1; i < argc; i++) {
+    std::string option = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (option == "--run-ms" && hasValue) {
+      runMs = atol(argv[++i]);
+    } else if (option == "--link" && hasValue) {
+      unsigned output = 0;
+      unsigned input = 0;
+      if (sscanf(argv[++i], "%u:%u", &output, &input) != 2) {
+        return usage(argv[0]);
+      }
+      nativeLinkPins(output, input);
+    } else if (option == "--nvs" && hasValue) {
+      flashPath = argv[++i];
+    } else if (option == "--module-uart" && hasValue) {
+      moduleUart = atoi(argv[++i]);
+    } else if (option == "--psram") {
+      nativeSetPSRAM(true);
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  
+  // 闪存文件不存在时从空白闪存开始
+  if (flashPath != nullptr && !nativeLoadFlash(flashPath)) {
+    fprintf(stderr, "[NativeHAL] 从空白闪存启动（%s）\n", flashPath);
+  }
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  std::thread(consoleThread).detach();
+  
+  unsigned long start = millis();
+  try {
+    setup();
+    while (!nativeStopRequested() && (runMs < 0 || (long)(millis() - start) < runMs)) {
+      loop();
+    }
+  } catch (const NativeTaskExit&) {
+    // loopTask删除了自身：其他任务继续运行到结束
+    while (!nativeStopRequested() && (runMs < 0 || (long)(millis() - start) < runMs)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  
+  if (flashPath != nullptr && !nativeSaveFlash(flashPath)) {
+    fprintf(stderr, "[NativeHAL] 闪存保存失败（%s）\n", flashPath);
+  }
+  // 任务线程仍在运行：不执行全局析构
+  fflush(nullptr);
+  _Exit(0);
+}
@@ -0,0 +1,105 @@
+/*
+ * NativeRMT - RMT transmit played out on the simulated GPIO
+ */
+
+#include "NativeInternal.h"
+#include <driver/rmt.h>
+
+struct NativeRmtChannel {
+  rmt_config_t config;
+  bool configured;
+  bool installed;
+};
+
+static NativeRmtChannel channels[RMT_CHANNEL_MAX];
+static std::mutex rmtMutex;
+
+esp_err_t rmt_config(const rmt_config_t* rmt_param) {
+  if (rmt_param == nullptr || rmt_param->channel >= RMT_CHANNEL_MAX ||
+      rmt_param->gpio_num < 0 || rmt_param->gpio_num >= GPIO_NUM_MAX || rmt_param->clk_div == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(rmtMutex);
+  NativeRmtChannel& channel = channels[rmt_param->channel];
+  channel.config = *rmt_param;
+  channel.configured = true;
+  if (rmt_param->rmt_mode == RMT_MODE_TX && rmt_param->tx_config.idle_output_en) {
+    nativeWritePin(rmt_param->gpio_num, rmt_param->tx_config.idle_level == RMT_IDLE_LEVEL_HIGH ? HIGH : LOW, micros());
+  }
+  return ESP_OK;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rx_buf_size, int intr_alloc_flags) {
+  (void)rx_buf_size;
+  (void)intr_alloc_flags;
+  if (channel >= RMT_CHANNEL_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(rmtMutex);
+  if (channels[channel].installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  channels[channel].installed = true;
+  return ESP_OK;
+}
+
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel) {
+  if (channel >= RMT_CHANNEL_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(rmtMutex);
+  if (!channels[channel].installed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  channels[channel].installed = false;
+  return ESP_OK;
+}
+
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t* rmt_item, int item_num, bool wait_tx_done) {
+  (void)wait_tx_done;
+  if (channel >= RMT_CHANNEL_MAX || rmt_item == nullptr || item_num <= 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  rmt_config_t config;
+  {
+    std::lock_guard<std::mutex> lock(rmtMutex);
+    if (!channels[channel].installed || !channels[channel].configured) {
+      return ESP_ERR_INVALID_STATE;
+    }
+    config = channels[channel].config;
+  }
+  uint8_t pin = (uint8_t)config.gpio_num;
+  double tickUs = config.clk_div / 80.0;  // APB 80MHz
+  
+  // 时长为0的半个item表示结束（与硬件一致）
+  uint64_t start = nativeMicros64();
+  double elapsed = 0;
+  for (int i = 0; i < item_num; i++) {
+    const rmt_item32_t& item = rmt_item[i];
+    if (item.duration0 == 0) {
+      break;
+    }
+    uint64_t edge = start + (uint64_t)(elapsed + 0.5);
+    nativeSleepUntil(edge);
+    nativeWritePin(pin, item.level0, (uint32_t)edge);
+    elapsed += item.duration0 * tickUs;
+    if (item.duration1 == 0) {
+      break;
+    }
+    edge = start + (uint64_t)(elapsed + 0.5);
+    nativeSleepUntil(edge);
+    nativeWritePin(pin, item.level1, (uint32_t)edge);
+    elapsed += item.duration1 * tickUs;
+  }
+  uint64_t end = start + (uint64_t)(elapsed + 0.5);
+  nativeSleepUntil(end);
+  if (config.tx_config.idle_output_en) {
+    nativeWritePin(pin, config.tx_config.idle_level == RMT_IDLE_LEVEL_HIGH ? HIGH : LOW, (uint32_t)end);
+  }
+  return ESP_OK;
+}
+
+esp_err_t rmt_wait_tx_done(rmt_channel_t channel, TickType_t wait_time) {
+  (void)wait_time;
+  return channel < RMT_CHANNEL_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
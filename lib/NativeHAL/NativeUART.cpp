@@ -0,0 +1,276 @@
+/*
+ * NativeUART - IDF UART driver and received data injection
+ */
+
+#include "NativeInternal.h"
+#include "NativeHAL.h"
+#include <driver/uart.h>
+
+static void postEvent(NativeUartPort* port, uart_event_type_t type, size_t size) {
+  if (port->events == nullptr) {
+    return;
+  }
+  uart_event_t event = {};
+  event.type = type;
+  event.size = size;
+  xQueueSendFromISR(port->events, &event, nullptr);
+}
+
+size_t nativeUartInject(uint8_t portNum, const uint8_t* data, size_t length) {
+  NativeUartPort* port = nativeUart(portNum);
+  if (port == nullptr) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  if (port->mode == NATIVE_UART_CLOSED) {
+    port->dropped += length;
+    return 0;
+  }
+  
+  size_t space = port->rx.size() < port->rxCapacity ? port->rxCapacity - port->rx.size() : 0;
+  size_t accepted = length < space ? length : space;
+  uint32_t patterns = 0;
+  for (size_t i = 0; i < accepted; i++) {
+    if (port->patternEnabled && (char)data[i] == port->pattern) {
+      // 位置队列满时丢失位置，事件照常产生（与驱动一致）
+      if (port->patternPositions.size() < port->patternQueueLength) {
+        port->patternPositions.push_back(port->rxWritten);
+      }
+      patterns++;
+    }
+    port->rx.push_back(data[i]);
+    port->rxWritten++;
+  }
+  port->dropped += length - accepted;
+  
+  if (port->mode == NATIVE_UART_DRIVER) {
+    if (accepted < length) {
+      postEvent(port, UART_BUFFER_FULL, accepted);
+    } else if (patterns > 0) {
+      for (uint32_t i = 0; i < patterns; i++) {
+        postEvent(port, UART_PATTERN_DET, 0);
+      }
+    } else if (accepted > 0) {
+      postEvent(port, UART_DATA, accepted);
+    }
+  }
+  port->cond.notify_all();
+  return accepted;
+}
+
+size_t nativeUartInject(uint8_t port, const char* text) {
+  return nativeUartInject(port, (const uint8_t*)text, strlen(text));
+}
+
+uint32_t nativeUartDropped(uint8_t portNum) {
+  NativeUartPort* port = nativeUart(portNum);
+  if (port == nullptr) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  return port->dropped;
+}
+
+// ========== IDF driver ==========
+
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, QueueHandle_t* uart_queue, int intr_alloc_flags) {
+  (void)tx_buffer_size;
+  (void)intr_alloc_flags;
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr || rx_buffer_size <= UART_FIFO_LEN) {
+    return ESP_FAIL;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  if (port->mode != NATIVE_UART_CLOSED) {
+    return ESP_FAIL;  // 已被HardwareSerial或驱动占用
+  }
+  port->mode = NATIVE_UART_DRIVER;
+  port->rxCapacity = rx_buffer_size;
+  port->rx.reset(port->rxCapacity);
+  port->patternEnabled = false;
+  port->patternPositions.reset(0);
+  port->patternQueueLength = 0;
+  port->events = nullptr;
+  if (queue_size > 0 && uart_queue != nullptr) {
+    port->events = xQueueCreate(queue_size, sizeof(uart_event_t));
+    *uart_queue = port->events;
+  }
+  return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t uart_num) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr) {
+    return ESP_FAIL;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  if (port->mode != NATIVE_UART_DRIVER) {
+    return ESP_OK;
+  }
+  if (port->events != nullptr) {
+    vQueueDelete(port->events);
+    port->events = nullptr;
+  }
+  port->mode = NATIVE_UART_CLOSED;
+  port->rx.clear();
+  port->patternEnabled = false;
+  port->patternPositions.clear();
+  return ESP_OK;
+}
+
+bool uart_is_driver_installed(uart_port_t uart_num) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  return port->mode == NATIVE_UART_DRIVER;
+}
+
+esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t* uart_config) {
+  return nativeUart(uart_num) != nullptr && uart_config != nullptr ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t uart_set_pin(uart_port_t uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num) {
+  (void)tx_io_num;
+  (void)rx_io_num;
+  (void)rts_io_num;
+  (void)cts_io_num;
+  return nativeUart(uart_num) != nullptr ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t uart_num, char pattern_chr, uint8_t chr_num,
+                                            int chr_tout, int post_idle, int pre_idle) {
+  (void)chr_tout;
+  (void)post_idle;
+  (void)pre_idle;
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr || chr_num != 1) {
+    return ESP_ERR_INVALID_ARG;  // 只模拟单字符模式
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  port->patternEnabled = true;
+  port->pattern = pattern_chr;
+  return ESP_OK;
+}
+
+esp_err_t uart_disable_pattern_det_intr(uart_port_t uart_num) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  port->patternEnabled = false;
+  return ESP_OK;
+}
+
+esp_err_t uart_pattern_queue_reset(uart_port_t uart_num, int queue_length) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  if (port->mode != NATIVE_UART_DRIVER) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  port->patternPositions.reset(queue_length > 0 ? queue_length : 0);
+  port->patternQueueLength = queue_length;
+  return ESP_OK;
+}
+
+// 位置相对于当前读指针；已被读走的位置丢弃
+static int patternPosition(NativeUartPort* port, bool pop) {
+  while (!port->patternPositions.empty() && port->patternPositions.front() < port->rxRead) {
+    port->patternPositions.pop_front();
+  }
+  if (port->patternPositions.empty()) {
+    return -1;
+  }
+  int pos = (int)(port->patternPositions.front() - port->rxRead);
+  if (pop) {
+    port->patternPositions.pop_front();
+  }
+  return pos;
+}
+
+int uart_pattern_pop_pos(uart_port_t uart_num) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  return patternPosition(port, true);
+}
+
+int uart_pattern_get_pos(uart_port_t uart_num) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  return patternPosition(port, false);
+}
+
+int uart_read_bytes(uart_port_t uart_num, void* buf, uint32_t length, TickType_t ticks_to_wait) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr || buf == nullptr) {
+    return -1;
+  }
+  std::unique_lock<std::mutex> lock(port->mutex);
+  if (port->mode != NATIVE_UART_DRIVER) {
+    return -1;
+  }
+  // 与驱动一致：等到凑够length字节或超时，返回实际读到的字节数
+  nativeWait(lock, port->cond, ticks_to_wait, [port, length]() {
+    return port->mode != NATIVE_UART_DRIVER || port->rx.size() >= length;
+  });
+  if (port->mode != NATIVE_UART_DRIVER) {
+    return -1;
+  }
+  uint8_t* out = (uint8_t*)buf;
+  uint32_t n = 0;
+  while (n < length && !port->rx.empty()) {
+    out[n++] = port->rx.front();
+    port->rx.pop_front();
+  }
+  port->rxRead += n;
+  return (int)n;
+}
+
+int uart_write_bytes(uart_port_t uart_num, const void* src, size_t size) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr) {
+    return -1;
+  }
+  if (uart_num == UART_NUM_0) {
+    nativeConsoleWrite((const uint8_t*)src, size);
+  }
+  return (int)size;
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t uart_num, size_t* size) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr || size == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  *size = port->rx.size();
+  return ESP_OK;
+}
+
+esp_err_t uart_flush_input(uart_port_t uart_num) {
+  NativeUartPort* port = nativeUart(uart_num);
+  if (port == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  port->rxRead += port->rx.size();
+  port->rx.clear();
+  port->patternPositions.clear();
+  return ESP_OK;
+}
+
+esp_err_t uart_flush(uart_port_t uart_num) {
+  return nativeUart(uart_num) != nullptr ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
@@ -0,0 +1,398 @@
+/*
+ * Preferences - In-memory NVS with the device's limits
+ */
+
+#include "Preferences.h"
+#include "NativeHAL.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+// NVS名称限制（含结尾'\0'为16字节）
+#define NVS_NAME_MAX 15
+
+// 每个条目32字节；默认"nvs"分区20KB = 5页 x 126条目，其中一页保留用于垃圾回收
+#define NVS_ENTRY_SIZE 32
+#define NVS_DEFAULT_ENTRIES 504
+
+// 字符串只能放在一页内
+#define NVS_STRING_MAX 4000
+
+struct NvsValue {
+  PreferenceType type;
+  std::vector<uint8_t> data;
+};
+
+typedef std::map<std::string, NvsValue> NvsNamespace;
+
+static std::mutex nvsMutex;
+static std::map<std::string, NvsNamespace> nvs;
+static NativeFlashStats stats = {0, 0, 0, 0, 0, NVS_DEFAULT_ENTRIES};
+
+// 基本类型占一个条目，字符串和blob另加数据所占的条目
+static uint32_t entriesFor(const NvsValue& value) {
+  if (value.type != PT_STR && value.type != PT_BLOB) {
+    return 1;
+  }
+  return 1 + (value.data.size() + NVS_ENTRY_SIZE - 1) / NVS_ENTRY_SIZE;
+}
+
+static bool validName(const char* name) {
+  return name != nullptr && name[0] != '\0' && strlen(name) <= NVS_NAME_MAX;
+}
+
+static void recountEntries() {
+  uint32_t used = 0;
+  for (const auto& ns : nvs) {
+    used++;  // 命名空间本身占一个条目
+    for (const auto& item : ns.second) {
+      used += entriesFor(item.second);
+    }
+  }
+  stats.usedEntries = used;
+}
+
+Preferences::Preferences() {
+  _started = false;
+  _readOnly = false;
+}
+
+Preferences::~Preferences() {
+  end();
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+  (void)partitionLabel;
+  if (_started || !validName(name)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  if (nvs.find(name) == nvs.end()) {
+    // 只读打开不存在的命名空间失败（与nvs_open一致），读写打开时创建
+    if (readOnly || stats.usedEntries + 1 > stats.totalEntries) {
+      return false;
+    }
+    nvs[name];
+    recountEntries();
+  }
+  _namespace = name;
+  _readOnly = readOnly;
+  _started = true;
+  return true;
+}
+
+void Preferences::end() {
+  _started = false;
+}
+
+bool Preferences::clear() {
+  if (!_started || _readOnly) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  nvs[_namespace].clear();
+  stats.erases++;
+  recountEntries();
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!_started || _readOnly || !validName(key)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  NvsNamespace& ns = nvs[_namespace];
+  auto it = ns.find(key);
+  if (it == ns.end()) {
+    return false;
+  }
+  ns.erase(it);
+  stats.erases++;
+  recountEntries();
+  return true;
+}
+
+size_t Preferences::put(const char* key, PreferenceType type, const void* value, size_t length) {
+  if (!_started || _readOnly || !validName(key) || value == nullptr) {
+    return 0;
+  }
+  if (type == PT_STR && length + 1 > NVS_STRING_MAX) {
+    return 0;
+  }
+  NvsValue item;
+  item.type = type;
+  item.data.assign((const uint8_t*)value, (const uint8_t*)value + length);
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  NvsNamespace& ns = nvs[_namespace];
+  auto it = ns.find(key);
+  if (it != ns.end() && it->second.type == type && it->second.data == item.data) {
+    return length;  // 内容相同时NVS不写闪存
+  }
+  // NVS先写入新值再擦除旧值，覆盖时需要新旧两份的空间
+  if (stats.usedEntries + entriesFor(item) > stats.totalEntries) {
+    return 0;  // ESP_ERR_NVS_NOT_ENOUGH_SPACE
+  }
+  ns[key] = item;
+  stats.writes++;
+  stats.bytesWritten += length;
+  recountEntries();
+  return length;
+}
+
+bool Preferences::get(const char* key, PreferenceType type, void* value, size_t length) {
+  if (!_started || !validName(key)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  stats.reads++;
+  NvsNamespace& ns = nvs[_namespace];
+  auto it = ns.find(key);
+  if (it == ns.end() || it->second.type != type || it->second.data.size() != length) {
+    return false;
+  }
+  memcpy(value, it->second.data.data(), length);
+  return true;
+}
+
+size_t Preferences::putChar(const char* key, int8_t value) { return put(key, PT_I8, &value, sizeof(value)); }
+size_t Preferences::putUChar(const char* key, uint8_t value) { return put(key, PT_U8, &value, sizeof(value)); }
+size_t Preferences::putShort(const char* key, int16_t value) { return put(key, PT_I16, &value, sizeof(value)); }
+size_t Preferences::putUShort(const char* key, uint16_t value) { return put(key, PT_U16, &value, sizeof(value)); }
+size_t Preferences::putInt(const char* key, int32_t value) { return put(key, PT_I32, &value, sizeof(value)); }
+size_t Preferences::putUInt(const char* key, uint32_t value) { return put(key, PT_U32, &value, sizeof(value)); }
+size_t Preferences::putLong(const char* key, int32_t value) { return put(key, PT_I32, &value, sizeof(value)); }
+size_t Preferences::putULong(const char* key, uint32_t value) { return put(key, PT_U32, &value, sizeof(value)); }
+size_t Preferences::putLong64(const char* key, int64_t value) { return put(key, PT_I64, &value, sizeof(value)); }
+size_t Preferences::putULong64(const char* key, uint64_t value) { return put(key, PT_U64, &value, sizeof(value)); }
+size_t Preferences::putFloat(const char* key, float value) { return put(key, PT_BLOB, &value, sizeof(value)); }
+size_t Preferences::putDouble(const char* key, double value) { return put(key, PT_BLOB, &value, sizeof(value)); }
+size_t Preferences::putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+
+size_t Preferences::putString(const char* key, const char* value) {
+  if (value == nullptr) {
+    return 0;
+  }
+  // 与NVS一致，字符串连同结尾'\0'保存，返回值不含'\0'
+  size_t length = strlen(value);
+  return put(key, PT_STR, value, length + 1) > 0 ? length : 0;
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+  return putString(key, value.c_str());
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+  if (length == 0) {
+    return 0;
+  }
+  return put(key, PT_BLOB, value, length);
+}
+
+bool Preferences::isKey(const char* key) {
+  return getType(key) != PT_INVALID;
+}
+
+PreferenceType Preferences::getType(const char* key) {
+  if (!_started || !validName(key)) {
+    return PT_INVALID;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  NvsNamespace& ns = nvs[_namespace];
+  auto it = ns.find(key);
+  return it != ns.end() ? it->second.type : PT_INVALID;
+}
+
+#define GETTER(method, ctype, ptype)                                  \
+  ctype Preferences::method(const char* key, ctype defaultValue) {    \
+    ctype value;                                                      \
+    return get(key, ptype, &value, sizeof(value)) ? value : defaultValue; \
+  }
+
+GETTER(getChar, int8_t, PT_I8)
+GETTER(getUChar, uint8_t, PT_U8)
+GETTER(getShort, int16_t, PT_I16)
+GETTER(getUShort, uint16_t, PT_U16)
+GETTER(getInt, int32_t, PT_I32)
+GETTER(getUInt, uint32_t, PT_U32)
+GETTER(getLong, int32_t, PT_I32)
+GETTER(getULong, uint32_t, PT_U32)
+GETTER(getLong64, int64_t, PT_I64)
+GETTER(getULong64, uint64_t, PT_U64)
+GETTER(getFloat, float, PT_BLOB)
+GETTER(getDouble, double, PT_BLOB)
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+  return getUChar(key, defaultValue ? 1 : 0) != 0;
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLength) {
+  if (!_started || !validName(key) || value == nullptr || maxLength == 0) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  stats.reads++;
+  NvsNamespace& ns = nvs[_namespace];
+  auto it = ns.find(key);
+  // 缓冲区放不下时失败（不截断），返回长度含结尾'\0'
+  if (it == ns.end() || it->second.type != PT_STR || it->second.data.size() > maxLength) {
+    return 0;
+  }
+  memcpy(value, it->second.data.data(), it->second.data.size());
+  return it->second.data.size();
+}
+
+String Preferences::getString(const char* key, String defaultValue) {
+  if (!_started || !validName(key)) {
+    return defaultValue;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  stats.reads++;
+  NvsNamespace& ns = nvs[_namespace];
+  auto it = ns.find(key);
+  if (it == ns.end() || it->second.type != PT_STR) {
+    return defaultValue;
+  }
+  return String((const char*)it->second.data.data());
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!_started || !validName(key)) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  NvsNamespace& ns = nvs[_namespace];
+  auto it = ns.find(key);
+  return it != ns.end() && it->second.type == PT_BLOB ? it->second.data.size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+  if (!_started || !validName(key) || buffer == nullptr) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  stats.reads++;
+  NvsNamespace& ns = nvs[_namespace];
+  auto it = ns.find(key);
+  // 缓冲区放不下时失败（不截断）
+  if (it == ns.end() || it->second.type != PT_BLOB || it->second.data.size() > maxLength) {
+    return 0;
+  }
+  memcpy(buffer, it->second.data.data(), it->second.data.size());
+  return it->second.data.size();
+}
+
+size_t Preferences::freeEntries() {
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  return stats.totalEntries - stats.usedEntries;
+}
+
+// ========== Host control ==========
+
+NativeFlashStats nativeFlashStats() {
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  return stats;
+}
+
+void nativeResetFlashStats() {
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  stats.writes = 0;
+  stats.bytesWritten = 0;
+  stats.erases = 0;
+  stats.reads = 0;
+}
+
+void nativeSetFlashEntries(uint32_t entries) {
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  stats.totalEntries = entries;
+}
+
+void nativeEraseFlash() {
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  nvs.clear();
+  recountEntries();
+}
+
+// 文件格式："NVS1"，然后每个命名空间：名称、条目数、各条目（键名、类型、长度、数据）
+static const char FLASH_FILE_MAGIC[4] = {'N', 'V', 'S', '1'};
+
+static void writeName(FILE* file, const std::string& name) {
+  uint8_t length = name.size();
+  fwrite(&length, 1, 1, file);
+  fwrite(name.data(), 1, length, file);
+}
+
+static bool readName(FILE* file, std::string& name) {
+  uint8_t length;
+  char buffer[256];
+  if (fread(&length, 1, 1, file) != 1 || fread(buffer, 1, length, file) != length) {
+    return false;
+  }
+  name.assign(buffer, length);
+  return true;
+}
+
+bool nativeSaveFlash(const char* path) {
+  FILE* file = fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  fwrite(FLASH_FILE_MAGIC, 1, sizeof(FLASH_FILE_MAGIC), file);
+  uint32_t count = nvs.size();
+  fwrite(&count, sizeof(count), 1, file);
+  for (const auto& ns : nvs) {
+    writeName(file, ns.first);
+    count = ns.second.size();
+    fwrite(&count, sizeof(count), 1, file);
+    for (const auto& item : ns.second) {
+      writeName(file, item.first);
+      uint8_t type = item.second.type;
+      uint32_t length = item.second.data.size();
+      fwrite(&type, 1, 1, file);
+      fwrite(&length, sizeof(length), 1, file);
+      fwrite(item.second.data.data(), 1, length, file);
+    }
+  }
+  bool ok = ferror(file) == 0;
+  return fclose(file) == 0 && ok;
+}
+
+bool nativeLoadFlash(const char* path) {
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  std::map<std::string, NvsNamespace> loaded;
+  char magic[sizeof(FLASH_FILE_MAGIC)];
+  uint32_t namespaces = 0;
+  bool ok = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+            memcmp(magic, FLASH_FILE_MAGIC, sizeof(magic)) == 0 &&
+            fread(&namespaces, sizeof(namespaces), 1, file) == 1;
+  for (uint32_t n = 0; ok && n < namespaces; n++) {
+    std::string name;
+    uint32_t count = 0;
+    ok = readName(file, name) && fread(&count, sizeof(count), 1, file) == 1;
+    NvsNamespace& ns = loaded[name];
+    for (uint32_t i = 0; ok && i < count; i++) {
+      std::string key;
+      uint8_t type;
+      uint32_t length;
+      ok = readName(file, key) && fread(&type, 1, 1, file) == 1 &&
+           fread(&length, sizeof(length), 1, file) == 1 && type < PT_INVALID;
+      if (ok) {
+        NvsValue& item = ns[key];
+        item.type = (PreferenceType)type;
+        item.data.resize(length);
+        ok = fread(item.data.data(), 1, length, file) == length;
+      }
+    }
+  }
+  fclose(file);
+  if (!ok) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  nvs.swap(loaded);
+  recountEntries();
+  return true;
+}
@@ -0,0 +1,83 @@
+/*
+ * Preferences.h - Host implementation of the ESP32 Preferences (NVS) library
+ *
+ * All Preferences instances share one in-memory NVS. The device's rules
+ * are kept so that flash handling bugs show up on the host as well:
+ * namespace and key names are at most 15 characters, a read-only begin()
+ * fails for a namespace that was never opened for writing, getters fail on
+ * a type mismatch or when the value does not fit into the buffer, and
+ * writes fail when the partition's entries are used up.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_PREFERENCES_H
+#define NATIVE_PREFERENCES_H
+
+#include <Arduino.h>
+#include <string>
+
+typedef enum {
+  PT_I8, PT_U8, PT_I16, PT_U16, PT_I32, PT_U32, PT_I64, PT_U64, PT_STR, PT_BLOB, PT_INVALID
+} PreferenceType;
+
+class Preferences {
+public:
+  Preferences();
+  ~Preferences();
+  
+  bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+  void end();
+  
+  bool clear();
+  bool remove(const char* key);
+  
+  size_t putChar(const char* key, int8_t value);
+  size_t putUChar(const char* key, uint8_t value);
+  size_t putShort(const char* key, int16_t value);
+  size_t putUShort(const char* key, uint16_t value);
+  size_t putInt(const char* key, int32_t value);
+  size_t putUInt(const char* key, uint32_t value);
+  size_t putLong(const char* key, int32_t value);
+  size_t putULong(const char* key, uint32_t value);
+  size_t putLong64(const char* key, int64_t value);
+  size_t putULong64(const char* key, uint64_t value);
+  size_t putFloat(const char* key, float value);
+  size_t putDouble(const char* key, double value);
+  size_t putBool(const char* key, bool value);
+  size_t putString(const char* key, const char* value);
+  size_t putString(const char* key, const String& value);
+  size_t putBytes(const char* key, const void* value, size_t length);
+  
+  bool isKey(const char* key);
+  PreferenceType getType(const char* key);
+  int8_t getChar(const char* key, int8_t defaultValue = 0);
+  uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+  int16_t getShort(const char* key, int16_t defaultValue = 0);
+  uint16_t getUShort(const char* key, uint16_t defaultValue = 0);
+  int32_t getInt(const char* key, int32_t defaultValue = 0);
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+  int32_t getLong(const char* key, int32_t defaultValue = 0);
+  uint32_t getULong(const char* key, uint32_t defaultValue = 0);
+  int64_t getLong64(const char* key, int64_t defaultValue = 0);
+  uint64_t getULong64(const char* key, uint64_t defaultValue = 0);
+  float getFloat(const char* key, float defaultValue = NAN);
+  double getDouble(const char* key, double defaultValue = NAN);
+  bool getBool(const char* key, bool defaultValue = false);
+  size_t getString(const char* key, char* value, size_t maxLength);
+  String getString(const char* key, String defaultValue = String());
+  size_t getBytesLength(const char* key);
+  size_t getBytes(const char* key, void* buffer, size_t maxLength);
+  size_t freeEntries();
+
+private:
+  bool _started;
+  bool _readOnly;
+  std::string _namespace;
+  
+  size_t put(const char* key, PreferenceType type, const void* value, size_t length);
+  bool get(const char* key, PreferenceType type, void* value, size_t length);
+};
+
+#endif // NATIVE_PREFERENCES_H
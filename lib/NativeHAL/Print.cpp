@@ -0,0 +1,87 @@
+/*
+ * Print - Arduino Print and Stream
+ */
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size-- > 0) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::write(const char* str) {
+  if (str == nullptr) {
+    return 0;
+  }
+  return write((const uint8_t*)str, strlen(str));
+}
+
+size_t Print::printf(const char* format, ...) {
+  char stackBuffer[64];  // 与Arduino-ESP32相同：更长的输出分配堆内存
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+  va_end(args);
+  if (length < 0) {
+    return 0;
+  }
+  if ((size_t)length < sizeof(stackBuffer)) {
+    return write((const uint8_t*)stackBuffer, length);
+  }
+  char* buffer = (char*)malloc(length + 1);
+  if (buffer == nullptr) {
+    return 0;
+  }
+  va_start(args, format);
+  vsnprintf(buffer, length + 1, format, args);
+  va_end(args);
+  size_t n = write((const uint8_t*)buffer, length);
+  free(buffer);
+  return n;
+}
+
+int Stream::timedRead() {
+  unsigned long start = millis();
+  do {
+    int c = read();
+    if (c >= 0) {
+      return c;
+    }
+    delay(1);
+  } while (millis() - start < _timeout);
+  return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+  size_t count = 0;
+  while (count < length) {
+    int c = timedRead();
+    if (c < 0) {
+      break;
+    }
+    buffer[count++] = (char)c;
+  }
+  return count;
+}
+
+String Stream::readStringUntil(char terminator) {
+  String result;
+  int c;
+  while ((c = timedRead()) >= 0 && c != terminator) {
+    result += (char)c;
+  }
+  return result;
+}
+
+String Stream::readString() {
+  String result;
+  int c;
+  while ((c = timedRead()) >= 0) {
+    result += (char)c;
+  }
+  return result;
+}
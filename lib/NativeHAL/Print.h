@@ -0,0 +1,70 @@
+/*
+ * Print.h - Host implementation of the Arduino Print and Stream classes
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+public:
+  virtual ~Print() {}
+  
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str);
+  size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+  virtual void flush() {}
+  
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+  
+  size_t print(const String& value) { return write(value.c_str(), value.length()); }
+  size_t print(const char* value) { return write(value); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char value, int base = DEC) { return print(String(value, base)); }
+  size_t print(int value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned int value, int base = DEC) { return print(String(value, base)); }
+  size_t print(long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(long long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned long long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(double value, int decimals = 2) { return print(String(value, decimals)); }
+  
+  size_t println() { return write("\r\n"); }
+  template <class T>
+  size_t println(const T& value) { size_t n = print(value); return n + println(); }
+  template <class T>
+  size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  
+  void setTimeout(unsigned long timeoutMs) { _timeout = timeoutMs; }
+  unsigned long getTimeout() { return _timeout; }
+  size_t readBytes(char* buffer, size_t length);
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+  String readStringUntil(char terminator);
+  String readString();
+
+protected:
+  unsigned long _timeout = 1000;
+  
+  int timedRead();
+};
+
+#endif // NATIVE_PRINT_H
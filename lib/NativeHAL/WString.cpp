@@ -0,0 +1,220 @@
+/*
+ * WString - Arduino String on std::string
+ */
+
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static std::string formatInteger(unsigned long long magnitude, bool negative, unsigned char base) {
+  if (base < 2 || base > 36) {
+    base = 10;
+  }
+  char buffer[72];
+  char* p = buffer + sizeof(buffer);
+  *--p = '\0';
+  do {
+    unsigned digit = magnitude % base;
+    *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    magnitude /= base;
+  } while (magnitude != 0);
+  if (negative) {
+    *--p = '-';
+  }
+  return p;
+}
+
+// 与Arduino一致：十进制按有符号显示，其他进制按无符号显示（负数为补码）
+#define SIGNED_STRING(value, base, type) \
+  ((base) == 10 && (value) < 0 ? formatInteger(-(unsigned long long)(value), true, base) \
+                               : formatInteger((unsigned type)(value), false, base))
+
+String::String(unsigned char value, unsigned char base) : _value(formatInteger(value, false, base)) {}
+String::String(int value, unsigned char base) : _value(SIGNED_STRING(value, base, int)) {}
+String::String(unsigned int value, unsigned char base) : _value(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base) : _value(SIGNED_STRING(value, base, long)) {}
+String::String(unsigned long value, unsigned char base) : _value(formatInteger(value, false, base)) {}
+String::String(long long value, unsigned char base) : _value(SIGNED_STRING(value, base, long long)) {}
+String::String(unsigned long long value, unsigned char base) : _value(formatInteger(value, false, base)) {}
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+  _value = buffer;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+  if (_value.size() != other._value.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < _value.size(); i++) {
+    if (tolower((unsigned char)_value[i]) != tolower((unsigned char)other._value[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+  return offset <= _value.size() && _value.compare(offset, prefix._value.size(), prefix._value) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+  return _value.size() >= suffix._value.size() &&
+         _value.compare(_value.size() - suffix._value.size(), suffix._value.size(), suffix._value) == 0;
+}
+
+char& String::operator[](unsigned int index) {
+  static char dummy;
+  if (index >= _value.size()) {
+    dummy = 0;
+    return dummy;
+  }
+  return _value[index];
+}
+
+void String::getBytes(unsigned char* buffer, unsigned int size, unsigned int index) const {
+  if (size == 0 || buffer == nullptr) {
+    return;
+  }
+  if (index >= _value.size()) {
+    buffer[0] = 0;
+    return;
+  }
+  size_t n = _value.size() - index;
+  if (n > size - 1) {
+    n = size - 1;
+  }
+  memcpy(buffer, _value.data() + index, n);
+  buffer[n] = 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  size_t pos = _value.find(c, from);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& value, unsigned int from) const {
+  size_t pos = _value.find(value._value, from);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+  size_t pos = _value.rfind(c);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String& value) const {
+  size_t pos = _value.rfind(value._value);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) {
+    unsigned int t = from;
+    from = to;
+    to = t;
+  }
+  if (from >= _value.size()) {
+    return String();
+  }
+  if (to > _value.size()) {
+    to = _value.size();
+  }
+  return String(_value.data() + from, to - from);
+}
+
+void String::replace(char find, char replacement) {
+  for (char& c : _value) {
+    if (c == find) {
+      c = replacement;
+    }
+  }
+}
+
+void String::replace(const String& find, const String& replacement) {
+  if (find._value.empty()) {
+    return;
+  }
+  size_t pos = 0;
+  while ((pos = _value.find(find._value, pos)) != std::string::npos) {
+    _value.replace(pos, find._value.size(), replacement._value);
+    pos += replacement._value.size();
+  }
+}
+
+void String::remove(unsigned int index) {
+  if (index < _value.size()) {
+    _value.erase(index);
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index < _value.size()) {
+    _value.erase(index, count);
+  }
+}
+
+void String::toLowerCase() {
+  for (char& c : _value) {
+    c = tolower((unsigned char)c);
+  }
+}
+
+void String::toUpperCase() {
+  for (char& c : _value) {
+    c = toupper((unsigned char)c);
+  }
+}
+
+void String::trim() {
+  size_t begin = 0;
+  while (begin < _value.size() && isspace((unsigned char)_value[begin])) {
+    begin++;
+  }
+  size_t end = _value.size();
+  while (end > begin && isspace((unsigned char)_value[end - 1])) {
+    end--;
+  }
+  _value = _value.substr(begin, end - begin);
+}
+
+long String::toInt() const {
+  return atol(_value.c_str());
+}
+
+float String::toFloat() const {
+  return (float)atof(_value.c_str());
+}
+
+double String::toDouble() const {
+  return atof(_value.c_str());
+}
+
+String operator+(const String& lhs, const String& rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, char rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
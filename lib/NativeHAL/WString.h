@@ -0,0 +1,127 @@
+/*
+ * WString.h - Host implementation of the Arduino String class
+ *
+ * Same interface as the Arduino-ESP32 core's String (the subset that
+ * applications use), backed by std::string.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+class String {
+public:
+  String() {}
+  String(const char* value) : _value(value != nullptr ? value : "") {}
+  String(const char* value, size_t length) : _value(value, length) {}
+  String(const String& other) = default;
+  String(String&& other) = default;
+  explicit String(char c) : _value(1, c) {}
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimals = 2);
+  explicit String(double value, unsigned int decimals = 2);
+  
+  String& operator=(const String& other) = default;
+  String& operator=(String&& other) = default;
+  String& operator=(const char* value) { _value = value != nullptr ? value : ""; return *this; }
+  
+  // Memory
+  bool reserve(unsigned int size) { _value.reserve(size); return true; }
+  unsigned int length() const { return _value.size(); }
+  bool isEmpty() const { return _value.empty(); }
+  const char* c_str() const { return _value.c_str(); }
+  
+  // Concatenation
+  bool concat(const String& other) { _value += other._value; return true; }
+  bool concat(const char* value) { if (value == nullptr) return false; _value += value; return true; }
+  bool concat(const char* value, unsigned int length) { _value.append(value, length); return true; }
+  bool concat(char c) { _value += c; return true; }
+  bool concat(unsigned char value) { return concat(String(value)); }
+  bool concat(int value) { return concat(String(value)); }
+  bool concat(unsigned int value) { return concat(String(value)); }
+  bool concat(long value) { return concat(String(value)); }
+  bool concat(unsigned long value) { return concat(String(value)); }
+  bool concat(long long value) { return concat(String(value)); }
+  bool concat(unsigned long long value) { return concat(String(value)); }
+  bool concat(float value) { return concat(String(value)); }
+  bool concat(double value) { return concat(String(value)); }
+  
+  template <class T>
+  String& operator+=(const T& value) { concat(value); return *this; }
+  
+  // Comparison
+  int compareTo(const String& other) const { return _value.compare(other._value); }
+  bool equals(const String& other) const { return _value == other._value; }
+  bool equals(const char* value) const { return _value == (value != nullptr ? value : ""); }
+  bool equalsIgnoreCase(const String& other) const;
+  bool operator==(const String& other) const { return equals(other); }
+  bool operator==(const char* value) const { return equals(value); }
+  bool operator!=(const String& other) const { return !equals(other); }
+  bool operator!=(const char* value) const { return !equals(value); }
+  bool operator<(const String& other) const { return compareTo(other) < 0; }
+  bool operator>(const String& other) const { return compareTo(other) > 0; }
+  bool startsWith(const String& prefix) const { return _value.compare(0, prefix._value.size(), prefix._value) == 0; }
+  bool startsWith(const String& prefix, unsigned int offset) const;
+  bool endsWith(const String& suffix) const;
+  
+  // Characters
+  char charAt(unsigned int index) const { return index < _value.size() ? _value[index] : 0; }
+  void setCharAt(unsigned int index, char c) { if (index < _value.size()) _value[index] = c; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  char& operator[](unsigned int index);
+  void getBytes(unsigned char* buffer, unsigned int size, unsigned int index = 0) const;
+  void toCharArray(char* buffer, unsigned int size, unsigned int index = 0) const {
+    getBytes((unsigned char*)buffer, size, index);
+  }
+  
+  // Search
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const String& value, unsigned int from = 0) const;
+  int lastIndexOf(char c) const;
+  int lastIndexOf(const String& value) const;
+  String substring(unsigned int from) const { return substring(from, length()); }
+  String substring(unsigned int from, unsigned int to) const;
+  
+  // Modification
+  void replace(char find, char replacement);
+  void replace(const String& find, const String& replacement);
+  void remove(unsigned int index);
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+  
+  // Parsing
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+
+private:
+  std::string _value;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+
+template <class T>
+String operator+(const String& lhs, T rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+#endif // NATIVE_WSTRING_H
@@ -0,0 +1,267 @@
+/*
+ * WebServer - HTTP handling for injected requests
+ */
+
+#include "WebServer.h"
+#include "NativeInternal.h"
+#include "NativeHAL.h"
+#include <algorithm>
+#include <deque>
+
+struct NativeHttpRequest {
+  uint16_t port;
+  HTTPMethod method;
+  String uri;
+  String body;
+  NativeHttpResponse response;
+  bool done;
+  bool abandoned;  // 请求方已超时返回，处理完成后由服务器释放
+};
+
+static std::mutex serverMutex;
+static std::condition_variable serverCond;
+static std::vector<WebServer*> listening;
+static std::deque<NativeHttpRequest*> pending;
+
+WebServer::WebServer(int port) {
+  _port = port;
+  _listening = false;
+  _method = HTTP_ANY;
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+  _current = nullptr;
+}
+
+WebServer::~WebServer() {
+  stop();
+}
+
+void WebServer::begin() {
+  std::lock_guard<std::mutex> lock(serverMutex);
+  if (!_listening) {
+    listening.push_back(this);
+    _listening = true;
+  }
+}
+
+void WebServer::stop() {
+  std::lock_guard<std::mutex> lock(serverMutex);
+  if (!_listening) {
+    return;
+  }
+  listening.erase(std::find(listening.begin(), listening.end(), this));
+  _listening = false;
+}
+
+void WebServer::on(const String& uri, HTTPMethod method, THandlerFunction handler) {
+  Route route;
+  route.uri = uri;
+  route.method = method;
+  route.handler = handler;
+  _routes.push_back(route);
+}
+
+static String urlDecode(const char* text, size_t length) {
+  String result;
+  for (size_t i = 0; i < length; i++) {
+    char c = text[i];
+    if (c == '+') {
+      c = ' ';
+    } else if (c == '%' && i + 2 < length && isxdigit((unsigned char)text[i + 1]) && isxdigit((unsigned char)text[i + 2])) {
+      char hex[3] = {text[i + 1], text[i + 2], '\0'};
+      c = (char)strtol(hex, nullptr, 16);
+      i += 2;
+    }
+    result += c;
+  }
+  return result;
+}
+
+void WebServer::parseArgs(const char* query) {
+  while (*query != '\0') {
+    const char* end = strchr(query, '&');
+    size_t length = end != nullptr ? (size_t)(end - query) : strlen(query);
+    const char* equals = (const char*)memchr(query, '=', length);
+    if (length > 0) {
+      Arg arg;
+      if (equals != nullptr) {
+        arg.name = urlDecode(query, equals - query);
+        arg.value = urlDecode(equals + 1, length - (equals + 1 - query));
+      } else {
+        arg.name = urlDecode(query, length);
+      }
+      _args.push_back(arg);
+    }
+    query += length;
+    if (*query == '&') {
+      query++;
+    }
+  }
+}
+
+void WebServer::handleClient() {
+  NativeHttpRequest* request = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(serverMutex);
+    if (!_listening) {
+      return;
+    }
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+      if ((*it)->port == _port) {
+        request = *it;
+        pending.erase(it);
+        break;
+      }
+    }
+  }
+  if (request == nullptr) {
+    return;
+  }
+  
+  // 路径和查询参数；表单请求体的参数同样放入arg()，原始请求体为"plain"
+  _current = request;
+  _method = request->method;
+  _args.clear();
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+  int query = request->uri.indexOf('?');
+  _uri = query >= 0 ? request->uri.substring(0, query) : request->uri;
+  if (query >= 0) {
+    parseArgs(request->uri.c_str() + query + 1);
+  }
+  if (!request->body.isEmpty()) {
+    parseArgs(request->body.c_str());
+    Arg plain;
+    plain.name = "plain";
+    plain.value = request->body;
+    _args.push_back(plain);
+  }
+  
+  THandlerFunction handler = _notFoundHandler;
+  for (const Route& route : _routes) {
+    if (route.uri == _uri && (route.method == HTTP_ANY || route.method == _method)) {
+      handler = route.handler;
+      break;
+    }
+  }
+  if (handler) {
+    handler();
+  } else {
+    send(404, "text/plain", String("Not found: ") + _uri);
+  }
+  
+  _current = nullptr;
+  std::lock_guard<std::mutex> lock(serverMutex);
+  if (request->abandoned) {
+    delete request;
+  } else {
+    request->done = true;
+    serverCond.notify_all();
+  }
+}
+
+String WebServer::arg(const String& name) {
+  for (const Arg& a : _args) {
+    if (a.name == name) {
+      return a.value;
+    }
+  }
+  return String();
+}
+
+String WebServer::arg(int i) {
+  return i >= 0 && i < (int)_args.size() ? _args[i].value : String();
+}
+
+String WebServer::argName(int i) {
+  return i >= 0 && i < (int)_args.size() ? _args[i].name : String();
+}
+
+bool WebServer::hasArg(const String& name) {
+  for (const Arg& a : _args) {
+    if (a.name == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+  if (_current == nullptr) {
+    return;
+  }
+  NativeHttpResponse& response = _current->response;
+  response.code = code;
+  response.contentType = contentType != nullptr ? contentType : "text/html";
+  response.body = content;
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+  (void)name;
+  (void)value;
+  (void)first;
+}
+
+void WebServer::sendContent(const char* content, size_t length) {
+  if (_current == nullptr || length == 0) {
+    return;  // 分块传输中空内容是结束块
+  }
+  _current->response.body.concat(content, length);
+  _current->response.chunks++;
+}
+
+bool WebServer::enqueue(NativeHttpRequest* request) {
+  if (!_listening) {
+    return false;
+  }
+  pending.push_back(request);
+  return true;
+}
+
+static HTTPMethod parseMethod(const char* method) {
+  static const char* const names[] = {"ANY", "GET", "HEAD", "POST", "PUT", "PATCH", "DELETE", "OPTIONS"};
+  for (size_t i = 1; i < sizeof(names) / sizeof(names[0]); i++) {
+    if (strcasecmp(method, names[i]) == 0) {
+      return (HTTPMethod)i;
+    }
+  }
+  return HTTP_GET;
+}
+
+bool nativeHttpRequest(const char* method, const char* uri, const char* body,
+                       NativeHttpResponse& response, uint16_t port, uint32_t timeoutMs) {
+  NativeHttpRequest* request = new NativeHttpRequest();
+  request->port = port;
+  request->method = parseMethod(method);
+  request->uri = uri;
+  request->body = body != nullptr ? body : "";
+  request->response.code = 0;
+  request->response.chunks = 0;
+  request->done = false;
+  request->abandoned = false;
+  
+  std::unique_lock<std::mutex> lock(serverMutex);
+  WebServer* server = nullptr;
+  for (WebServer* s : listening) {
+    if (s->port() == port) {
+      server = s;
+      break;
+    }
+  }
+  if (server == nullptr || !server->enqueue(request)) {
+    delete request;
+    return false;
+  }
+  if (!serverCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [request]() { return request->done; })) {
+    auto it = std::find(pending.begin(), pending.end(), request);
+    if (it != pending.end()) {
+      pending.erase(it);
+      delete request;
+    } else {
+      request->abandoned = true;  // 正在处理
+    }
+    return false;
+  }
+  response = request->response;
+  delete request;
+  return true;
+}
@@ -0,0 +1,100 @@
+/*
+ * WebServer.h - Host implementation of the ESP32 WebServer
+ *
+ * No sockets: requests come from nativeHttpRequest() and are handled, one
+ * per handleClient() call, in the thread calling handleClient(), as on the
+ * device. Handlers see the same arg()/hasArg() view of the query string and
+ * form body, and their send()/sendContent() output is returned to the
+ * requester.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_WEBSERVER_H
+#define NATIVE_WEBSERVER_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+struct NativeHttpResponse;
+struct NativeHttpRequest;
+
+enum HTTPMethod {
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_HEAD,
+  HTTP_POST,
+  HTTP_PUT,
+  HTTP_PATCH,
+  HTTP_DELETE,
+  HTTP_OPTIONS
+};
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+class WebServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+  
+  WebServer(int port = 80);
+  ~WebServer();
+  
+  void begin();
+  void stop();
+  void close() { stop(); }
+  void handleClient();
+  
+  void on(const String& uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+  void on(const String& uri, HTTPMethod method, THandlerFunction handler);
+  void onNotFound(THandlerFunction handler) { _notFoundHandler = handler; }
+  
+  // Current request
+  String uri() { return _uri; }
+  HTTPMethod method() { return _method; }
+  String arg(const String& name);
+  String arg(int i);
+  String argName(int i);
+  int args() { return (int)_args.size(); }
+  bool hasArg(const String& name);
+  
+  // Response
+  void send(int code, const char* contentType = nullptr, const String& content = String(""));
+  void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+  void sendHeader(const String& name, const String& value, bool first = false);
+  void setContentLength(size_t length) { _contentLength = length; }
+  void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+  void sendContent(const char* content, size_t length);
+  
+  // Host side (nativeHttpRequest)
+  int port() { return _port; }
+  bool enqueue(NativeHttpRequest* request);
+
+private:
+  struct Route {
+    String uri;
+    HTTPMethod method;
+    THandlerFunction handler;
+  };
+  struct Arg {
+    String name;
+    String value;
+  };
+  
+  int _port;
+  bool _listening;
+  std::vector<Route> _routes;
+  THandlerFunction _notFoundHandler;
+  
+  String _uri;
+  HTTPMethod _method;
+  std::vector<Arg> _args;
+  size_t _contentLength;
+  NativeHttpRequest* _current;
+  
+  void parseArgs(const char* query);
+};
+
+#endif // NATIVE_WEBSERVER_H
@@ -0,0 +1,60 @@
+/*
+ * WiFi - Soft AP without a radio
+ */
+
+#include "WiFi.h"
+
+WiFiClass WiFi;
+
+String IPAddress::toString() const {
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+  return String(buffer);
+}
+
+WiFiClass::WiFiClass() {
+  _mode = WIFI_MODE_NULL;
+  _apStarted = false;
+}
+
+bool WiFiClass::mode(wifi_mode_t mode) {
+  _mode = mode;
+  if (mode != WIFI_MODE_AP && mode != WIFI_MODE_APSTA) {
+    _apStarted = false;
+  }
+  return true;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* passphrase, int channel,
+                       int ssidHidden, int maxConnection, bool ftmResponder) {
+  (void)ssidHidden;
+  (void)ftmResponder;
+  // 与设备一致的参数检查：WPA2密码至少8个字符
+  if (ssid == nullptr || ssid[0] == '\0' || strlen(ssid) > 32) {
+    return false;
+  }
+  if (passphrase != nullptr && passphrase[0] != '\0' && (strlen(passphrase) < 8 || strlen(passphrase) > 63)) {
+    return false;
+  }
+  if (channel < 1 || channel > 13 || maxConnection < 1 || maxConnection > 10) {
+    return false;
+  }
+  if (_mode != WIFI_MODE_AP && _mode != WIFI_MODE_APSTA) {
+    _mode = _mode == WIFI_MODE_STA ? WIFI_MODE_APSTA : WIFI_MODE_AP;
+  }
+  _ssid = ssid;
+  _apStarted = true;
+  return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool wifiOff) {
+  _apStarted = false;
+  if (wifiOff) {
+    _mode = WIFI_MODE_NULL;
+  }
+  return true;
+}
+
+IPAddress WiFiClass::softAPIP() {
+  return _apStarted ? IPAddress(192, 168, 4, 1) : IPAddress();
+}
@@ -0,0 +1,70 @@
+/*
+ * WiFi.h - Host implementation of the ESP32 WiFi soft AP subset
+ *
+ * No radio: the soft AP only validates its credentials like the device
+ * (passwords shorter than 8 characters are rejected) and reports the
+ * default AP address. Clients reach the WebServer through
+ * nativeHttpRequest().
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+  WIFI_MODE_NULL = 0,
+  WIFI_MODE_STA,
+  WIFI_MODE_AP,
+  WIFI_MODE_APSTA,
+  WIFI_MODE_MAX
+} wifi_mode_t;
+
+#define WIFI_OFF WIFI_MODE_NULL
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_AP WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+class IPAddress {
+public:
+  IPAddress() : IPAddress(0, 0, 0, 0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    _octets[0] = a;
+    _octets[1] = b;
+    _octets[2] = c;
+    _octets[3] = d;
+  }
+  
+  uint8_t operator[](int index) const { return _octets[index]; }
+  String toString() const;
+
+private:
+  uint8_t _octets[4];
+};
+
+class WiFiClass {
+public:
+  WiFiClass();
+  
+  bool mode(wifi_mode_t mode);
+  wifi_mode_t getMode() { return _mode; }
+  
+  bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1,
+              int ssidHidden = 0, int maxConnection = 4, bool ftmResponder = false);
+  bool softAPdisconnect(bool wifiOff = false);
+  IPAddress softAPIP();
+  String softAPSSID() { return _ssid; }
+  uint8_t softAPgetStationNum() { return 0; }
+
+private:
+  wifi_mode_t _mode;
+  bool _apStarted;
+  String _ssid;
+};
+
+extern WiFiClass WiFi;
+
+#endif // NATIVE_WIFI_H
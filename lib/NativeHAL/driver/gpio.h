@@ -0,0 +1,22 @@
+/*
+ * driver/gpio.h - ESP-IDF GPIO numbers (host build)
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_DRIVER_GPIO_H
+#define NATIVE_DRIVER_GPIO_H
+
+#include "esp_err.h"
+
+// Simulated GPIO count (ESP32-S3 has 49, the extra pins are unused)
+#define NATIVE_GPIO_COUNT 64
+
+typedef enum {
+  GPIO_NUM_NC = -1,
+  GPIO_NUM_0 = 0,
+  GPIO_NUM_MAX = NATIVE_GPIO_COUNT
+} gpio_num_t;
+
+#endif // NATIVE_DRIVER_GPIO_H
@@ -0,0 +1,43 @@
+/*
+ * esp_heap_caps.h - ESP-IDF capability-based allocation (host build)
+ *
+ * Allocations come from malloc() and can be released with free(), as on
+ * the device. MALLOC_CAP_SPIRAM requests fail unless PSRAM is enabled with
+ * nativeSetPSRAM().
+ *
+ * Heap statistics describe a board with NATIVE_HEAP_SIZE bytes of internal
+ * heap (NATIVE_PSRAM_SIZE of PSRAM when enabled), of which the bytes the
+ * process has allocated from malloc() are in use. The minimum free size is
+ * the lowest value seen by the statistics calls, not by every allocation.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef NATIVE_ESP_HEAP_CAPS_H
+#define NATIVE_ESP_HEAP_CAPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MALLOC_CAP_EXEC (1 << 0)
+#define MALLOC_CAP_32BIT (1 << 1)
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+void* heap_caps_malloc(size_t size, uint32_t caps);
+void* heap_caps_calloc(size_t count, size_t size, uint32_t caps);
+void heap_caps_free(void* ptr);
+
+#define NATIVE_HEAP_SIZE (320 * 1024)
+#define NATIVE_PSRAM_SIZE (8 * 1024 * 1024)
+
+size_t heap_caps_get_total_size(uint32_t caps);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+#endif // NATIVE_ESP_HEAP_CAPS_H
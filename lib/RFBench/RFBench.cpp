@@ -0,0 +1,84 @@
+/*
+ * RFBench - Shared pieces of the ESP433RF benchmarks
+ */
+
+#include "RFBench.h"
+
+void RFBenchHistogram::reset() {
+  memset(_buckets, 0, sizeof(_buckets));
+  _count = 0;
+  _low = UINT32_MAX;
+  _high = 0;
+  _sum = 0;
+}
+
+uint16_t RFBenchHistogram::bucketOf(uint32_t value) {
+  if (value < RF_BENCH_HISTOGRAM_SUB) {
+    return value;
+  }
+  // 最高位所在的2的幂区间再按随后4位细分
+  uint8_t exponent = 31 - __builtin_clz(value);
+  uint8_t sub = (value >> (exponent - 4)) & (RF_BENCH_HISTOGRAM_SUB - 1);
+  return RF_BENCH_HISTOGRAM_SUB + (exponent - 4) * RF_BENCH_HISTOGRAM_SUB + sub;
+}
+
+uint32_t RFBenchHistogram::bucketLow(uint16_t bucket) {
+  if (bucket < RF_BENCH_HISTOGRAM_SUB) {
+    return bucket;
+  }
+  uint8_t exponent = (bucket - RF_BENCH_HISTOGRAM_SUB) / RF_BENCH_HISTOGRAM_SUB + 4;
+  uint8_t sub = (bucket - RF_BENCH_HISTOGRAM_SUB) % RF_BENCH_HISTOGRAM_SUB;
+  return (uint32_t)(RF_BENCH_HISTOGRAM_SUB + sub) << (exponent - 4);
+}
+
+void RFBenchHistogram::add(uint32_t value) {
+  _buckets[bucketOf(value)]++;
+  _count++;
+  _sum += value;
+  if (value < _low) {
+    _low = value;
+  }
+  if (value > _high) {
+    _high = value;
+  }
+}
+
+uint32_t RFBenchHistogram::percentile(float percent) const {
+  if (_count == 0) {
+    return 0;
+  }
+  uint32_t rank = (uint32_t)(percent / 100.0f * _count + 0.5f);
+  if (rank < 1) {
+    rank = 1;
+  }
+  uint32_t seen = 0;
+  for (uint16_t i = 0; i < RF_BENCH_HISTOGRAM_BUCKETS; i++) {
+    seen += _buckets[i];
+    if (seen >= rank) {
+      uint32_t low = bucketLow(i);
+      uint32_t high = i + 1 < RF_BENCH_HISTOGRAM_BUCKETS ? bucketLow(i + 1) - 1 : UINT32_MAX;
+      uint32_t value = low + (high - low) / 2;
+      return value < _low ? _low : (value > _high ? _high : value);
+    }
+  }
+  return _high;
+}
+
+void RFBenchHistogram::printJSON(Print& out) const {
+  out.printf("{\"min\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu,\"mean\":%lu}",
+             (unsigned long)min(), (unsigned long)percentile(50), (unsigned long)percentile(90),
+             (unsigned long)percentile(99), (unsigned long)max(), (unsigned long)mean());
+}
+
+void rfBenchPrintString(Print& out, const char* text) {
+  out.print('"');
+  for (const char* p = text != nullptr ? text : ""; *p != '\0'; p++) {
+    if (*p == '"' || *p == '\\') {
+      out.print('\\');
+    }
+    if ((uint8_t)*p >= 0x20) {
+      out.print(*p);
+    }
+  }
+  out.print('"');
+}
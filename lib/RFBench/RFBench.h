@@ -0,0 +1,69 @@
+/*
+ * RFBench - Shared pieces of the ESP433RF benchmarks
+ *
+ * The benchmarks only use the Arduino API and ESP433RF, so the same code
+ * runs on the device and in the `native` host build. Whatever differs
+ * between the two (how bytes reach the receiver UART, how allocations are
+ * counted, free heap) is passed in as a function pointer.
+ *
+ * Reports are printed as one JSON object per line so that runs can be
+ * collected and compared across releases (RF_BENCH_SCHEMA increases when
+ * fields change meaning).
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_BENCH_H
+#define RF_BENCH_H
+
+#include <Arduino.h>
+
+#define RF_BENCH_SCHEMA 1
+
+// Log-linear histogram: values below 16 have their own bucket, every power of
+// two above that is split into 16 buckets (at most 6.25% relative error)
+#define RF_BENCH_HISTOGRAM_SUB 16
+#define RF_BENCH_HISTOGRAM_BUCKETS (RF_BENCH_HISTOGRAM_SUB + 28 * RF_BENCH_HISTOGRAM_SUB)
+
+// Delivers bytes to the receiver side (device: a UART wired to the RX pin,
+// host: nativeUartInject), returns the bytes accepted
+typedef size_t (*RFBenchWriter)(const uint8_t* data, size_t length, void* context);
+
+// Monotonic counter sampled before and after a run (allocations, free heap)
+typedef uint32_t (*RFBenchCounter)();
+
+// Fixed-memory histogram of unsigned values (latencies in us, pulse errors)
+// Single writer; read it only when the writer has stopped
+class RFBenchHistogram {
+public:
+  RFBenchHistogram() { reset(); }
+  
+  void reset();
+  void add(uint32_t value);
+  
+  uint32_t count() const { return _count; }
+  uint32_t min() const { return _count > 0 ? _low : 0; }
+  uint32_t max() const { return _high; }
+  uint32_t mean() const { return _count > 0 ? (uint32_t)(_sum / _count) : 0; }
+  // Value at or below which `percent` of the samples lie (bucket midpoint, clamped to min/max)
+  uint32_t percentile(float percent) const;
+  
+  // {"min":..,"p50":..,"p90":..,"p99":..,"max":..,"mean":..}
+  void printJSON(Print& out) const;
+
+private:
+  uint32_t _buckets[RF_BENCH_HISTOGRAM_BUCKETS];
+  uint32_t _count;
+  uint32_t _low;
+  uint32_t _high;
+  uint64_t _sum;
+  
+  static uint16_t bucketOf(uint32_t value);
+  static uint32_t bucketLow(uint16_t bucket);
+};
+
+// JSON string value (quotes and backslashes escaped)
+void rfBenchPrintString(Print& out, const char* text);
+
+#endif // RF_BENCH_H
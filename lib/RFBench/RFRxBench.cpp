@@ -0,0 +1,266 @@
+/*
+ * RFRxBench - Receive path throughput and latency benchmark implementation
+ */
+
+#include "RFRxBench.h"
+
+std::atomic<RFRxBench*> RFRxBench::_active(nullptr);
+
+static std::atomic<uint8_t> callbacksRunning(0);
+
+RFRxBench::RFRxBench(ESP433RF& rf, RFBenchWriter writer, void* writerContext)
+  : _rf(rf), _writer(writer), _writerContext(writerContext) {
+  _forward = nullptr;
+  _allocationCounter = nullptr;
+  _heapProbe = nullptr;
+  _head = 0;
+  _tail = 0;
+  _lastReceivedUs = 0;
+  #ifdef ESP32
+  _lock = portMUX_INITIALIZER_UNLOCKED;
+  #endif
+  memset(&_config, 0, sizeof(_config));
+  _result = RFRxBenchResult();
+}
+
+// 生成的行：地址码和按键值由固定种子的序列产生，每次运行的码相同
+static uint32_t generatedCode(uint32_t index) {
+  uint32_t x = index * 2654435761u + 0x2DD9A4AAu;
+  x ^= x >> 15;
+  x *= 0x85EBCA6Bu;
+  x ^= x >> 13;
+  return x;
+}
+
+// 取第index行（录制数据循环使用），返回行长度，0表示没有可用的行
+size_t RFRxBench::nextLine(uint32_t index, const char*& cursor, char* line, size_t size) {
+  if (_config.recording == nullptr) {
+    static const char* const prefixes[] = {"LC:", "RX:", ""};
+    uint8_t format = _config.format == RF_RX_BENCH_MIX ? (uint8_t)(index % 3) : (uint8_t)_config.format;
+    int length = snprintf(line, size, "%s%08lX", prefixes[format], (unsigned long)generatedCode(index));
+    return length > 0 && (size_t)length < size ? length : 0;
+  }
+  
+  // 跳过空行，到结尾时从头开始（整个录制数据都是空行时返回0）
+  bool wrapped = false;
+  while (true) {
+    if (*cursor == '\0') {
+      if (wrapped) {
+        return 0;
+      }
+      cursor = _config.recording;
+      wrapped = true;
+    }
+    const char* end = cursor;
+    while (*end != '\0' && *end != '\n') {
+      end++;
+    }
+    size_t length = end - cursor;
+    if (length > 0 && cursor[length - 1] == '\r') {
+      length--;
+    }
+    const char* start = cursor;
+    cursor = *end == '\n' ? end + 1 : end;
+    if (length > 0) {
+      if (length >= size) {
+        length = size - 1;  // 超长行截断后发送（接收端同样按超长行丢弃）
+      }
+      memcpy(line, start, length);
+      line[length] = '\0';
+      return length;
+    }
+  }
+}
+
+void RFRxBench::lock() {
+  #ifdef ESP32
+  portENTER_CRITICAL(&_lock);
+  #endif
+}
+
+void RFRxBench::unlock() {
+  #ifdef ESP32
+  portEXIT_CRITICAL(&_lock);
+  #endif
+}
+
+uint32_t RFRxBench::outstanding() {
+  lock();
+  uint32_t count = _head - _tail;
+  unlock();
+  return count;
+}
+
+// 超过drainMs仍未收到的行计为丢失（丢失的行不会再有回调来移出队列）
+void RFRxBench::expire(uint32_t now) {
+  lock();
+  while (_tail != _head && now - _pending[_tail & (RF_RX_BENCH_PENDING_SIZE - 1)].writtenUs > _config.drainMs * 1000UL) {
+    _tail++;
+    _result.dropped++;
+  }
+  unlock();
+}
+
+bool RFRxBench::run(const RFRxBenchConfig& config) {
+  if (_writer == nullptr || config.lines == 0 || _active != nullptr) {
+    return false;
+  }
+  _config = config;
+  _result = RFRxBenchResult();
+  _result.allocations = -1;
+  _result.heapLow = -1;
+  _head = 0;
+  _tail = 0;
+  _lastReceivedUs = 0;
+  
+  // 录制数据中同一个码连续出现是多帧，不按一次按键合并
+  uint16_t dedupWindow = _rf.getDedupWindow();
+  _rf.setDedupWindow(0);
+  uint32_t queueDropped = _rf.getQueueDropped();
+  _active = this;
+  _rf.setReceiveCallback(onReceive);
+  
+  const char* cursor = config.recording != nullptr ? config.recording : "";
+  char line[RF_LINE_BUFFER_SIZE + 2];  // 超过接收端行缓冲区的行截断到这里
+  uint32_t allocationsBefore = _allocationCounter != nullptr ? _allocationCounter() : 0;
+  uint32_t start = micros();
+  
+  for (uint32_t i = 0; i < config.lines; i++) {
+    // 按速率定时：长等待让出CPU，最后2ms忙等
+    if (config.rate > 0) {
+      uint32_t due = start + (uint32_t)((uint64_t)i * 1000000ULL / config.rate);
+      int32_t remaining;
+      while ((remaining = (int32_t)(due - micros())) > 0) {
+        if (remaining > 2000) {
+          delay((remaining - 1000) / 1000);
+        } else {
+          yield();
+        }
+      }
+    }
+  
+    size_t length = nextLine(i, cursor, line, sizeof(line) - 2);
+    if (length == 0) {
+      break;
+    }
+  
+    // 能解析出信号的行才等待接收；等待队列满时等接收端追上（或等最早的行超时）
+    RFSignal expected;
+    bool expect = length < RF_LINE_BUFFER_SIZE && _rf.parseSignal(line, length, expected);
+    expire(micros());
+    if (expect && outstanding() >= RF_RX_BENCH_PENDING_SIZE) {
+      _result.stalls++;
+      do {
+        delay(1);
+        expire(micros());
+      } while (outstanding() >= RF_RX_BENCH_PENDING_SIZE);
+    }
+  
+    line[length] = '\r';
+    line[length + 1] = '\n';
+    if (expect) {
+      // 先登记再写入：接收回调可能在写入返回之前执行
+      lock();
+      Pending& pending = _pending[_head & (RF_RX_BENCH_PENDING_SIZE - 1)];
+      pending.signal = expected;
+      pending.writtenUs = micros();
+      _head++;
+      unlock();
+      _result.expected++;
+    }
+    _writer((const uint8_t*)line, length + 2, _writerContext);
+    _result.lines++;
+  
+    if (_heapProbe != nullptr) {
+      int32_t heap = (int32_t)_heapProbe();
+      if (_result.heapLow < 0 || heap < _result.heapLow) {
+        _result.heapLow = heap;
+      }
+    }
+  }
+  
+  // 等待未完成的帧（全部收到或超时）
+  while (outstanding() > 0) {
+    delay(1);
+    expire(micros());
+  }
+  
+  // 恢复应用回调，等待正在执行的基准回调返回后再读取结果
+  _rf.setReceiveCallback(_forward);
+  _active = nullptr;
+  while (callbacksRunning.load() != 0) {
+    delay(1);
+  }
+  _rf.setDedupWindow(dedupWindow);
+  
+  if (_allocationCounter != nullptr) {
+    _result.allocations = (int32_t)(_allocationCounter() - allocationsBefore);
+  }
+  _result.queueDropped = _rf.getQueueDropped() - queueDropped;
+  _result.queueHighWater = _rf.getQueueHighWater();
+  _result.elapsedUs = (_result.received > 0 ? _lastReceivedUs : micros()) - start;
+  return true;
+}
+
+void RFRxBench::onReceive(const RFSignal& signal) {
+  uint32_t now = micros();
+  callbacksRunning++;
+  RFRxBench* bench = _active;
+  if (bench != nullptr) {
+    bench->match(signal, now);
+    if (bench->_forward != nullptr) {
+      bench->_forward(signal);
+    }
+  }
+  callbacksRunning--;
+}
+
+// 帧按顺序到达：与最早的同码待接收行匹配，跳过的行视为丢失
+void RFRxBench::match(const RFSignal& signal, uint32_t now) {
+  lock();
+  for (uint32_t i = _tail; i != _head; i++) {
+    const Pending& pending = _pending[i & (RF_RX_BENCH_PENDING_SIZE - 1)];
+    if (pending.signal.sameCode(signal)) {
+      uint32_t latency = now - pending.writtenUs;
+      _result.dropped += i - _tail;
+      _result.received++;
+      _lastReceivedUs = now;
+      _tail = i + 1;
+      unlock();
+      _result.latency.add(latency);
+      return;
+    }
+  }
+  _result.unmatched++;
+  unlock();
+}
+
+void RFRxBench::printReport(Print& out) const {
+  static const char* const formats[] = {"lc", "rx", "hex", "mix"};
+  const RFRxBenchResult& r = _result;
+  float framesPerSecond = r.elapsedUs > 0 ? r.received * 1000000.0f / r.elapsedUs : 0;
+  
+  out.printf("{\"bench\":\"rx\",\"schema\":%d,\"target\":", RF_BENCH_SCHEMA);
+  rfBenchPrintString(out, _config.target);
+  out.print(",\"label\":");
+  rfBenchPrintString(out, _config.label);
+  out.printf(",\"stream\":\"%s\",\"rate\":%lu", _config.recording != nullptr ? "recording" : formats[_config.format],
+             (unsigned long)_config.rate);
+  out.printf(",\"lines\":%lu,\"expected\":%lu,\"received\":%lu,\"dropped\":%lu,\"unmatched\":%lu,\"stalls\":%lu",
+             (unsigned long)r.lines, (unsigned long)r.expected, (unsigned long)r.received,
+             (unsigned long)r.dropped, (unsigned long)r.unmatched, (unsigned long)r.stalls);
+  out.printf(",\"elapsed_ms\":%lu,\"frames_per_s\":%.1f,\"latency_us\":", (unsigned long)(r.elapsedUs / 1000), framesPerSecond);
+  r.latency.printJSON(out);
+  out.printf(",\"queue_dropped\":%lu,\"queue_high_water\":%lu", (unsigned long)r.queueDropped, (unsigned long)r.queueHighWater);
+  if (r.allocations >= 0 && r.lines > 0) {
+    out.printf(",\"allocs_per_frame\":%.2f", (float)r.allocations / r.lines);  // 每写入一行
+  } else {
+    out.print(",\"allocs_per_frame\":null");
+  }
+  if (r.heapLow >= 0) {
+    out.printf(",\"heap_low\":%ld", (long)r.heapLow);
+  } else {
+    out.print(",\"heap_low\":null");
+  }
+  out.println("}");
+}
@@ -0,0 +1,126 @@
+/*
+ * RFRxBench - Receive path throughput and latency benchmark
+ *
+ * Replays receiver module output ("LC:XXXXXXYY", "RX:XXXXXXYY" or bare
+ * hex lines, generated or recorded) at a fixed rate through a writer into
+ * the ESP433RF receive path, and measures each frame from the moment its
+ * line was written until the receive callback runs: UART, line parser,
+ * dispatcher queue and callback, exactly as the firmware uses them.
+ *
+ * The receive path is configured by the caller (polling, event-driven
+ * receive, dispatcher task); the benchmark only takes over the receive
+ * callback and turns deduplication off for the run (repeated codes in a
+ * recording are separate frames here). Frames arrive in order, so each
+ * callback is matched to the oldest outstanding line with the same code;
+ * lines skipped over, and lines not received within the drain time, count
+ * as dropped.
+ *
+ * On the device the line timestamp is taken when the line has been handed
+ * to the writer, so the latency includes the line's time on the wire
+ * (about 1 ms per byte at 9600 baud).
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_RX_BENCH_H
+#define RF_RX_BENCH_H
+
+#include <Arduino.h>
+#include <ESP433RF.h>
+#include <atomic>
+#include "RFBench.h"
+
+// Lines written but not yet received (power of two); the writer waits when it is full
+#define RF_RX_BENCH_PENDING_SIZE 64
+
+// Generated stream format
+enum RFRxBenchFormat : uint8_t {
+  RF_RX_BENCH_LC,   // LC:XXXXXXYY
+  RF_RX_BENCH_RX,   // RX:XXXXXXYY
+  RF_RX_BENCH_HEX,  // XXXXXXYY
+  RF_RX_BENCH_MIX   // 依次轮换以上三种
+};
+
+struct RFRxBenchConfig {
+  uint32_t lines;            // Lines to write (a recording is repeated as needed)
+  uint32_t rate;             // Lines per second, 0 = as fast as the writer accepts them
+  RFRxBenchFormat format;    // Generated lines (used when recording is nullptr)
+  const char* recording;     // Recorded module output, '\n' separated ('\r' ignored), or nullptr
+  uint32_t drainMs;          // Time a frame may take before it counts as dropped
+  const char* target;        // Copied into the report ("esp32", "native", ...)
+  const char* label;         // Copied into the report (release, board, receive mode, ...)
+};
+
+struct RFRxBenchResult {
+  uint32_t lines;            // Lines written
+  uint32_t expected;         // Lines that parse into a frame
+  uint32_t received;         // Frames matched to a line
+  uint32_t dropped;          // Expected frames never received
+  uint32_t unmatched;        // Callbacks without a matching line (other transmitters)
+  uint32_t stalls;           // Times the writer waited for a free pending slot
+  uint32_t elapsedUs;        // First line written to last frame received
+  uint32_t queueDropped;     // ESP433RF dispatcher queue drops during the run
+  uint32_t queueHighWater;
+  int32_t allocations;       // Allocation counter delta over the run and the drain, -1 without a counter
+  int32_t heapLow;           // Lowest free heap seen while writing, -1 without a probe
+  RFBenchHistogram latency;  // us, line written -> receive callback
+};
+
+class RFRxBench {
+public:
+  // writer delivers the lines to the receiver UART
+  RFRxBench(ESP433RF& rf, RFBenchWriter writer, void* writerContext = nullptr);
+  
+  // Application callback to run after each frame (included in the measured
+  // cost, as in the firmware); it is also restored as the receive callback after a run
+  void setForward(ESP433RF::ReceiveCallback callback) { _forward = callback; }
+  void setAllocationCounter(RFBenchCounter counter) { _allocationCounter = counter; }
+  void setHeapProbe(RFBenchCounter probe) { _heapProbe = probe; }
+  
+  // Runs in the calling task and blocks until the run has drained.
+  // Only one benchmark can run at a time (the receive callback has no context).
+  bool run(const RFRxBenchConfig& config);
+  
+  const RFRxBenchResult& result() const { return _result; }
+  
+  // One JSON object on one line
+  void printReport(Print& out) const;
+
+private:
+  struct Pending {
+    RFSignal signal;
+    uint32_t writtenUs;
+  };
+  
+  ESP433RF& _rf;
+  RFBenchWriter _writer;
+  void* _writerContext;
+  ESP433RF::ReceiveCallback _forward;
+  RFBenchCounter _allocationCounter;
+  RFBenchCounter _heapProbe;
+  
+  RFRxBenchConfig _config;
+  RFRxBenchResult _result;
+  
+  // Pending lines (added by run(), matched by the receive callback, expired by run())
+  Pending _pending[RF_RX_BENCH_PENDING_SIZE];
+  uint32_t _head;
+  uint32_t _tail;
+  uint32_t _lastReceivedUs;
+  #ifdef ESP32
+  portMUX_TYPE _lock;
+  #endif
+  void lock();
+  void unlock();
+  uint32_t outstanding();
+  void expire(uint32_t now);
+  
+  static std::atomic<RFRxBench*> _active;
+  static void onReceive(const RFSignal& signal);
+  void match(const RFSignal& signal, uint32_t now);
+  
+  size_t nextLine(uint32_t index, const char*& cursor, char* line, size_t size);
+};
+
+#endif // RF_RX_BENCH_H
@@ -0,0 +1,242 @@
+/*
+ * RFTxBench - Transmit pipeline benchmark and timing-accuracy analyzer implementation
+ */
+
+#include "RFTxBench.h"
+
+std::atomic<RFTxBench*> RFTxBench::_active(nullptr);
+
+static std::atomic<uint8_t> callbacksRunning(0);
+
+RFTxBench::RFTxBench(ESP433RF& rf)
+  : _rf(rf), _edgeCount(0), _overflow(0), _capturing(false), _completedHandle(0), _completedUs(0) {
+  _forward = nullptr;
+  _loopbackPin = -1;
+  _idealCount = 0;
+  memset(&_config, 0, sizeof(_config));
+  _result = RFTxBenchResult();
+}
+
+RFTxBench::~RFTxBench() {
+  detachLoopback();
+}
+
+bool RFTxBench::attachLoopback(uint8_t inputPin) {
+  detachLoopback();
+  pinMode(inputPin, INPUT);
+  attachInterruptArg(digitalPinToInterrupt(inputPin), loopbackISR, this, CHANGE);
+  _loopbackPin = inputPin;
+  return true;
+}
+
+void RFTxBench::detachLoopback() {
+  if (_loopbackPin >= 0) {
+    detachInterrupt(digitalPinToInterrupt(_loopbackPin));
+    _loopbackPin = -1;
+  }
+}
+
+void IRAM_ATTR RFTxBench::loopbackISR(void* arg) {
+  RFTxBench* self = static_cast<RFTxBench*>(arg);
+  uint32_t now = micros();
+  self->recordEdge(digitalRead(self->_loopbackPin), now);
+}
+
+void IRAM_ATTR RFTxBench::recordEdge(uint8_t level, uint32_t timeUs) {
+  if (!_capturing.load(std::memory_order_acquire)) {
+    return;
+  }
+  uint32_t count = _edgeCount.load(std::memory_order_relaxed);
+  if (count >= RF_TX_BENCH_MAX_EDGES) {
+    _overflow.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  _edges[count].timeUs = timeUs;
+  _edges[count].level = level ? HIGH : LOW;
+  _edgeCount.store(count + 1, std::memory_order_release);
+}
+
+void RFTxBench::onTransmit(RFTxHandle handle, const RFSignal& signal) {
+  uint32_t now = micros();
+  callbacksRunning++;
+  RFTxBench* bench = _active;
+  if (bench != nullptr) {
+    bench->_completedUs.store(now);
+    bench->_completedHandle.store(handle);
+    if (bench->_forward != nullptr) {
+      bench->_forward(handle, signal);
+    }
+  }
+  callbacksRunning--;
+}
+
+// 按协议表编码一次重复的理想波形，相邻的同电平半周期（拆分的超长脉冲）合并
+bool RFTxBench::buildIdeal(const RFSignal& signal) {
+  const RFProtocol* protocol = rfGetProtocol(signal.protocol);
+  RFPulse items[RF_TX_BENCH_MAX_HALVES / 2];
+  uint16_t count = protocol != nullptr ?
+    rfEncodeWaveform(*protocol, signal.pulseLength, signal.code, signal.bits(), 1, items, RF_TX_BENCH_MAX_HALVES / 2) : 0;
+  if (count == 0) {
+    return false;
+  }
+  _idealCount = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    const uint32_t durations[2] = {items[i].duration0, items[i].duration1};
+    const uint8_t levels[2] = {(uint8_t)items[i].level0, (uint8_t)items[i].level1};
+    for (uint8_t h = 0; h < 2 && durations[h] > 0; h++) {
+      if (_idealCount > 0 && _ideal[_idealCount - 1].level == levels[h]) {
+        _ideal[_idealCount - 1].durationUs += durations[h];
+      } else {
+        _ideal[_idealCount].durationUs = durations[h];
+        _ideal[_idealCount].level = levels[h];
+        _idealCount++;
+      }
+    }
+  }
+  return _idealCount > 0;
+}
+
+// 逐个半周期比较捕获的波形与理想波形（各次重复首尾相接）
+void RFTxBench::analyze() {
+  uint32_t total = (uint32_t)_idealCount * _result.repeats;
+  uint32_t first = _ideal[0].level == LOW ? 1 : 0;  // 与空闲低电平相连，没有起始边沿
+  uint32_t last = _ideal[_idealCount - 1].level == LOW ? total - 1 : total;
+  uint32_t expected = last > first ? last - first : 0;
+  _result.edgesExpected += expected + 1;
+  
+  // 去掉重复电平（中断读到的电平已经变回去时）
+  uint32_t captured = _edgeCount.load(std::memory_order_acquire);
+  uint32_t edges = 0;
+  for (uint32_t i = 0; i < captured; i++) {
+    if (edges == 0 || _edges[i].level != _edges[edges - 1].level) {
+      _edges[edges++] = _edges[i];
+    }
+  }
+  _result.edgesCaptured += edges;
+  
+  uint32_t measured = edges > 0 ? edges - 1 : 0;
+  bool shapeOk = measured == expected;
+  uint32_t compare = measured < expected ? measured : expected;
+  for (uint32_t j = 0; j < compare; j++) {
+    const Half& ideal = _ideal[(first + j) % _idealCount];
+    if (_edges[j].level != ideal.level) {
+      shapeOk = false;
+      break;
+    }
+    int32_t error = (int32_t)(_edges[j + 1].timeUs - _edges[j].timeUs) - (int32_t)ideal.durationUs;
+    _result.pulseError.add(error < 0 ? -error : error);
+    _result.errorSum += error;
+  }
+  if (!shapeOk) {
+    _result.shapeErrors++;
+  }
+}
+
+bool RFTxBench::run(const RFTxBenchConfig& config) {
+  if (config.sends == 0 || config.bits == 0 || config.bits > RF_SIGNAL_MAX_BITS || _active != nullptr) {
+    return false;
+  }
+  _config = config;
+  _result = RFTxBenchResult();
+  _result.protocol = config.protocol != 0 ? config.protocol : _rf.getProtocol();
+  _result.pulseLength = config.pulseLength != 0 ? config.pulseLength : _rf.getPulseLength();
+  _result.repeats = config.repeats != 0 ? config.repeats : _rf.getRepeatCount();
+  if (rfGetProtocol(_result.protocol) == nullptr || _result.repeats == 0) {
+    return false;
+  }
+  
+  uint8_t repeatCount = _rf.getRepeatCount();
+  _rf.setRepeatCount(_result.repeats);
+  _overflow.store(0);
+  _active = this;
+  _rf.setTransmitCallback(onTransmit);
+  
+  for (uint16_t i = 0; i < config.sends; i++) {
+    // 每次发送不同的码（固定种子，每次运行相同）
+    uint32_t x = (i + 1) * 2654435761u;
+    uint64_t code = ((uint64_t)(x ^ (x >> 13)) << 32) | (x * 0x85EBCA6Bu);
+    RFSignal signal = RFSignal();
+    signal.code = config.bits < 64 ? code & ((1ULL << config.bits) - 1) : code;
+    signal.bitLength = config.bits;
+    signal.protocol = _result.protocol;
+    signal.pulseLength = _result.pulseLength;
+    if (!buildIdeal(signal)) {
+      break;
+    }
+    if (i == 0) {
+      for (uint16_t h = 0; h < _idealCount; h++) {
+        _result.airtimeUs += _ideal[h].durationUs;
+      }
+      _result.airtimeUs *= _result.repeats;
+    }
+    RFWaveform* waveform = config.precomputed ? _rf.encodeWaveform(signal) : nullptr;
+  
+    _completedHandle.store(0);
+    _edgeCount.store(0);
+    _capturing.store(true, std::memory_order_release);
+  
+    uint32_t start = micros();
+    RFTxHandle handle = waveform != nullptr ? _rf.sendWaveform(signal, waveform) : _rf.send(signal);
+    uint32_t returned = micros();
+    if (waveform != nullptr) {
+      waveform->release();  // 请求持有自己的引用
+    }
+    if (handle == 0) {
+      _capturing.store(false);
+      continue;  // 发送队列满
+    }
+    _result.sends++;
+    _result.callUs.add(returned - start);
+  
+    // 同步发送时回调已在send()中执行；发送任务中的发送等待回调
+    uint32_t waitStart = millis();
+    while (_completedHandle.load() != handle && millis() - waitStart < config.timeoutMs) {
+      delay(1);
+    }
+    if (_completedHandle.load() == handle) {
+      uint32_t complete = _completedUs.load() - start;
+      _result.completed++;
+      _result.completeUs.add(complete);
+      _result.completeSumUs += complete;
+    }
+  
+    delay(2);  // 最后一个边沿的中断
+    _capturing.store(false, std::memory_order_release);
+    analyze();
+  }
+  
+  _rf.setTransmitCallback(_forward);
+  _active = nullptr;
+  while (callbacksRunning.load() != 0) {
+    delay(1);
+  }
+  _rf.setRepeatCount(repeatCount);
+  _result.edgesOverflow = _overflow.load();
+  return true;
+}
+
+void RFTxBench::printReport(Print& out) const {
+  const RFTxBenchResult& r = _result;
+  float sendsPerSecond = r.completeSumUs > 0 ? r.completed * 1000000.0f / r.completeSumUs : 0;
+  float bias = r.pulseError.count() > 0 ? (float)r.errorSum / r.pulseError.count() : 0;
+  
+  out.printf("{\"bench\":\"tx\",\"schema\":%d,\"target\":", RF_BENCH_SCHEMA);
+  rfBenchPrintString(out, _config.target);
+  out.print(",\"label\":");
+  rfBenchPrintString(out, _config.label);
+  out.printf(",\"backend\":\"%s\",\"precomputed\":%s", _rf.getTxBackend() == RF_TX_RMT ? "rmt" : "rcswitch",
+             _config.precomputed ? "true" : "false");
+  out.printf(",\"protocol\":%u,\"pulse_us\":%u,\"repeats\":%u,\"bits\":%u,\"airtime_us\":%lu",
+             r.protocol, r.pulseLength, r.repeats, _config.bits, (unsigned long)r.airtimeUs);
+  out.printf(",\"sends\":%u,\"completed\":%u,\"sends_per_s\":%.2f", r.sends, r.completed, sendsPerSecond);
+  out.print(",\"call_us\":");
+  r.callUs.printJSON(out);
+  out.print(",\"complete_us\":");
+  r.completeUs.printJSON(out);
+  out.printf(",\"edges_expected\":%lu,\"edges_captured\":%lu,\"edges_overflow\":%lu,\"shape_errors\":%u",
+             (unsigned long)r.edgesExpected, (unsigned long)r.edgesCaptured, (unsigned long)r.edgesOverflow, r.shapeErrors);
+  out.print(",\"pulse_error_us\":");
+  r.pulseError.printJSON(out);
+  out.printf(",\"pulse_bias_us\":%.2f}", bias);
+  out.println();
+}
@@ -0,0 +1,133 @@
+/*
+ * RFTxBench - Transmit pipeline benchmark and timing-accuracy analyzer
+ *
+ * Sends a series of codes through ESP433RF::send() with one protocol,
+ * pulse length, repeat count and code length, captures the waveform the
+ * TX pin actually produced and compares every pulse with the ideal
+ * waveform of the protocol table (RFProtocol.h):
+ *
+ *   - pulse width error histogram (|measured - ideal| per pulse half, us)
+ *     and the mean signed error (bias)
+ *   - shape errors: sends whose captured edge sequence does not match the
+ *     ideal one (missing, extra or inverted pulses)
+ *   - time the caller is blocked in send() (synchronous sends: the whole
+ *     bit-banged transmission; with the transmitter task: queueing only)
+ *   - time until the transmit callback reports the send complete, and the
+ *     back-to-back sends per second that this allows
+ *
+ * Edges are fed in through recordEdge(): on the device from a GPIO
+ * interrupt on a pin wired to the TX pin (attachLoopback()), on the host
+ * from the NativeHAL pin listener. The first low phase of a send and the
+ * final low phase after it merge with the idle line and are not measured.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_TX_BENCH_H
+#define RF_TX_BENCH_H
+
+#include <Arduino.h>
+#include <ESP433RF.h>
+#include <atomic>
+#include "RFBench.h"
+
+// Edges captured per send (32 bits x 10 repeats needs 660)
+#define RF_TX_BENCH_MAX_EDGES 2048
+
+// Pulse halves of one ideal repeat (64 bits + sync, plus split over-long pulses)
+#define RF_TX_BENCH_MAX_HALVES 160
+
+struct RFTxBenchConfig {
+  uint16_t sends;
+  uint8_t protocol;       // 0 = ESP433RF setting
+  uint16_t pulseLength;   // 0 = ESP433RF setting
+  uint8_t repeats;        // 0 = ESP433RF setting
+  uint8_t bits;           // Code length (1-64)
+  bool precomputed;       // Send a precomputed waveform (sendWaveform) instead of send()
+  uint32_t timeoutMs;     // Longest wait for one send to complete
+  const char* target;     // Copied into the report ("esp32", "native", ...)
+  const char* label;      // Copied into the report (release, board, ...)
+};
+
+struct RFTxBenchResult {
+  uint8_t protocol;             // Resolved settings of the run
+  uint16_t pulseLength;
+  uint8_t repeats;
+  uint32_t airtimeUs;           // Ideal duration of one send
+  uint16_t sends;               // Sends accepted
+  uint16_t completed;           // Sends reported complete in time
+  uint16_t shapeErrors;         // Sends whose edges did not match the ideal waveform
+  uint32_t edgesExpected;       // Over all sends
+  uint32_t edgesCaptured;
+  uint32_t edgesOverflow;       // Edges lost to a full capture buffer
+  int64_t errorSum;             // Signed pulse error sum (bias = errorSum / pulseError.count())
+  uint64_t completeSumUs;       // Sum of complete times (back-to-back throughput)
+  RFBenchHistogram pulseError;  // us, |measured - ideal| per pulse half
+  RFBenchHistogram callUs;      // us, caller blocked in send()
+  RFBenchHistogram completeUs;  // us, send() called -> transmit callback
+};
+
+class RFTxBench {
+public:
+  RFTxBench(ESP433RF& rf);
+  ~RFTxBench();
+  
+  // Device capture: GPIO interrupt on inputPin, which is wired to the TX pin
+  bool attachLoopback(uint8_t inputPin);
+  void detachLoopback();
+  
+  // One level change of the TX pin (interrupt- and thread-safe, single producer)
+  void recordEdge(uint8_t level, uint32_t timeUs);
+  
+  // Application callback restored after a run (the benchmark takes over the transmit callback)
+  void setForward(ESP433RF::TransmitCallback callback) { _forward = callback; }
+  
+  // Runs in the calling task and blocks until all sends completed.
+  // The repeat count setting is restored afterwards.
+  bool run(const RFTxBenchConfig& config);
+  
+  const RFTxBenchResult& result() const { return _result; }
+  
+  // One JSON object on one line
+  void printReport(Print& out) const;
+
+private:
+  struct Edge {
+    uint32_t timeUs;
+    uint8_t level;
+  };
+  struct Half {
+    uint32_t durationUs;
+    uint8_t level;
+  };
+  
+  ESP433RF& _rf;
+  ESP433RF::TransmitCallback _forward;
+  RFTxBenchConfig _config;
+  RFTxBenchResult _result;
+  int16_t _loopbackPin;
+  
+  // Capture (producer: recordEdge(), consumer: run() between sends)
+  Edge _edges[RF_TX_BENCH_MAX_EDGES];
+  std::atomic<uint32_t> _edgeCount;
+  std::atomic<uint32_t> _overflow;
+  std::atomic<bool> _capturing;
+  
+  // Completion (producer: transmit callback)
+  std::atomic<RFTxHandle> _completedHandle;
+  std::atomic<uint32_t> _completedUs;
+  
+  // Ideal waveform of one repeat
+  Half _ideal[RF_TX_BENCH_MAX_HALVES];
+  uint16_t _idealCount;
+  
+  static std::atomic<RFTxBench*> _active;
+  static void onTransmit(RFTxHandle handle, const RFSignal& signal);
+  static void loopbackISR(void* arg);
+  
+  bool buildIdeal(const RFSignal& signal);
+  void analyze();
+};
+
+#endif // RF_TX_BENCH_H
@@ -0,0 +1,108 @@
+/*
+ * RWLock - 读写锁（多读单写）
+ *
+ * 多个任务可以同时持有读锁；写锁与所有读锁/写锁互斥。
+ * ESP32上基于FreeRTOS信号量实现，其他平台（单线程）为空操作。
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RW_LOCK_H
+#define RW_LOCK_H
+
+#include <Arduino.h>
+
+class RWLock {
+public:
+  RWLock() {
+    #ifdef ESP32
+    _readerMutex = nullptr;
+    _writeSem = nullptr;
+    _readers = 0;
+    #endif
+  }
+  
+  ~RWLock() {
+    #ifdef ESP32
+    if (_readerMutex != nullptr) vSemaphoreDelete(_readerMutex);
+    if (_writeSem != nullptr) vSemaphoreDelete(_writeSem);
+    #endif
+  }
+  
+  // 创建信号量（在调度器可用后调用，重复调用无副作用）
+  void begin() {
+    #ifdef ESP32
+    if (_readerMutex == nullptr) {
+      _readerMutex = xSemaphoreCreateMutex();
+    }
+    if (_writeSem == nullptr) {
+      _writeSem = xSemaphoreCreateBinary();
+      xSemaphoreGive(_writeSem);
+    }
+    #endif
+  }
+  
+  void readLock() {
+    #ifdef ESP32
+    if (_readerMutex == nullptr) return;
+    xSemaphoreTake(_readerMutex, portMAX_DELAY);
+    if (++_readers == 1) {
+      xSemaphoreTake(_writeSem, portMAX_DELAY);  // 第一个读者阻止写者
+    }
+    xSemaphoreGive(_readerMutex);
+    #endif
+  }
+  
+  void readUnlock() {
+    #ifdef ESP32
+    if (_readerMutex == nullptr) return;
+    xSemaphoreTake(_readerMutex, portMAX_DELAY);
+    if (--_readers == 0) {
+      xSemaphoreGive(_writeSem);  // 最后一个读者放行写者
+    }
+    xSemaphoreGive(_readerMutex);
+    #endif
+  }
+  
+  void writeLock() {
+    #ifdef ESP32
+    if (_writeSem == nullptr) return;
+    xSemaphoreTake(_writeSem, portMAX_DELAY);
+    #endif
+  }
+  
+  void writeUnlock() {
+    #ifdef ESP32
+    if (_writeSem == nullptr) return;
+    xSemaphoreGive(_writeSem);
+    #endif
+  }
+
+private:
+  #ifdef ESP32
+  SemaphoreHandle_t _readerMutex;  // 保护读者计数
+  SemaphoreHandle_t _writeSem;     // 二值信号量：写者或读者组持有
+  int _readers;
+  #endif
+};
+
+// 作用域读锁
+class ReadGuard {
+public:
+  explicit ReadGuard(RWLock& lock) : _lock(lock) { _lock.readLock(); }
+  ~ReadGuard() { _lock.readUnlock(); }
+private:
+  RWLock& _lock;
+};
+
+// 作用域写锁
+class WriteGuard {
+public:
+  explicit WriteGuard(RWLock& lock) : _lock(lock) { _lock.writeLock(); }
+  ~WriteGuard() { _lock.writeUnlock(); }
+private:
+  RWLock& _lock;
+};
+
+#endif // RW_LOCK_H
@@ -4,41 +4,273 @@
 
 #include "SignalManager.h"
 
-SignalManager::SignalManager(uint8_t maxSignals) {
-  _maxSignals = maxSignals;
-  _signals = nullptr;
+#ifdef ESP32
+#include <esp_heap_caps.h>
+#include <stddef.h>
+
+// 增量记录（日志中变更的信号，键名"r<ID>"，名称按实际长度保存）
+struct SignalRecord {
+  uint32_t code;       // 信号码低32位
+  uint8_t protocol;
+  uint8_t bitLength;   // 0 = 协议默认位数
+  uint16_t pulseLength;
+  uint32_t timestamp;
+  uint32_t codeHigh;   // 信号码高32位
+  char name[SIGNAL_NAME_SIZE];
+};
+
+// 信号表（键名"table"）：表头 + 分块目录（按块号升序）+ 信号顺序（记录ID数组）
+// 信号按记录ID分块（键名"c<块号>"），每块：块头 + 定长记录数组 + 名称字符串池（不含'\0'）
+#define SIGNAL_TABLE_MAGIC 0x54474953  // "SIGT"
+
+struct SignalTableHeader {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t recordSize;
+  uint16_t count;       // 信号数（顺序数组长度）
+  uint16_t nextId;
+  uint16_t chunkCount;  // 分块目录项数
+  uint32_t crc;         // 分块目录 + 信号顺序的CRC32
+};
+
+struct SignalChunkEntry {
+  uint16_t chunk;
+  uint16_t count;
+  uint32_t crc;         // 块头中的CRC32（合并时相同的块不重写）
+};
+
+struct SignalChunkHeader {
+  uint16_t count;
+  uint16_t poolSize;
+  uint32_t crc;         // 记录数组 + 字符串池的CRC32
+};
+
+struct SignalTableRecord {
+  uint32_t code;        // 信号码低32位
+  uint32_t timestamp;
+  uint32_t nameOffset;  // 在本块字符串池中的偏移
+  uint16_t pulseLength;
+  uint16_t id;
+  uint8_t protocol;
+  uint8_t nameLength;
+  uint8_t bitLength;
+  uint8_t reserved;
+  uint32_t codeHigh;    // 信号码高32位
+};
+
+// 日志操作
+#define JOURNAL_PUT    0  // 记录新增或修改（内容在"r<ID>"中）
+#define JOURNAL_REMOVE 1  // 记录删除
+
+static uint32_t crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+// 按记录ID（高16位）比较，低16位为信号索引或顺序位置
+static int compareIds(const void* a, const void* b) {
+  uint16_t left = *(const uint32_t*)a >> 16;
+  uint16_t right = *(const uint32_t*)b >> 16;
+  return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+// 校验信号表（表头、分块目录和信号顺序）
+static bool checkTable(const uint8_t* table, size_t size) {
+  const SignalTableHeader* header = (const SignalTableHeader*)table;
+  return table != nullptr && size >= sizeof(SignalTableHeader) &&
+         header->magic == SIGNAL_TABLE_MAGIC &&
+         header->version == SIGNAL_FLASH_FORMAT &&
+         header->recordSize == sizeof(SignalTableRecord) &&
+         size == sizeof(SignalTableHeader) + sizeof(SignalChunkEntry) * header->chunkCount + sizeof(uint16_t) * header->count &&
+         header->crc == crc32(table + sizeof(SignalTableHeader), size - sizeof(SignalTableHeader));
+}
+
+static size_t chunkSize(const SignalChunkHeader* chunk) {
+  return sizeof(SignalChunkHeader) + sizeof(SignalTableRecord) * chunk->count + chunk->poolSize;
+}
+
+// 加载时信号表中一个位置上的记录及其所在块的字符串池
+struct SignalTableSlot {
+  const SignalTableRecord* record;
+  const char* pool;
+};
+
+// 校验一个分块（只依赖块本身：合并中途掉电时块可能比目录新）
+static bool checkChunk(const uint8_t* data, size_t size) {
+  const SignalChunkHeader* chunk = (const SignalChunkHeader*)data;
+  return data != nullptr && size >= sizeof(SignalChunkHeader) &&
+         size == chunkSize(chunk) &&
+         chunk->crc == crc32(data + sizeof(SignalChunkHeader), size - sizeof(SignalChunkHeader));
+}
+#endif
+
+// 复制名称到定长缓冲区，超长时在UTF-8字符边界截断
+static void copyName(char* dest, const char* src) {
+  size_t len = strlen(src);
+  if (len >= SIGNAL_NAME_SIZE) {
+    len = SIGNAL_NAME_SIZE - 1;
+    while (len > 0 && ((uint8_t)src[len] & 0xC0) == 0x80) {
+      len--;  // 不截断多字节字符
+    }
+  }
+  memcpy(dest, src, len);
+  dest[len] = '\0';
+}
+
+// 原始波形信号的录制数据，编码后的波形紧跟在结构体之后
+struct SignalTrace {
+  uint16_t length;
+  bool dirty;  // 尚未写入闪存（只由闪存写入者修改）
+  
+  uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+#ifdef ESP32
+// 一次刷新要写入的内容：在写锁内从信号表取出，在写锁外写入闪存
+struct SignalFlushBatch {
+  bool full;                                  // 整表保存（table为nullptr时清空命名空间）
+  uint8_t* table;                             // 信号表（表头、分块目录和信号顺序）
+  size_t tableSize;
+  uint8_t* chunks;                            // 各分块依次存放（按4字节对齐），顺序同分块目录
+  uint8_t opCount;
+  uint32_t ops[SIGNAL_JOURNAL_SIZE];          // 增量保存的变更（操作 << 16 | 记录ID）
+  SignalRecord records[SIGNAL_JOURNAL_SIZE];  // JOURNAL_PUT变更的记录内容
+  uint16_t traceCount;
+  uint16_t* traceIds;
+  SignalTrace** traces;                       // 尚未保存的录制数据副本
+  uint16_t removalCount;
+  uint16_t* removals;                         // 待删除的录制数据（记录ID）
+};
+
+// 闪存互斥量守卫（互斥量未创建时为空操作）
+class FlashGuard {
+public:
+  explicit FlashGuard(SemaphoreHandle_t mutex) : _mutex(mutex) {
+    if (_mutex != nullptr) xSemaphoreTake(_mutex, portMAX_DELAY);
+  }
+  ~FlashGuard() {
+    if (_mutex != nullptr) xSemaphoreGive(_mutex);
+  }
+  
+private:
+  SemaphoreHandle_t _mutex;
+  FlashGuard(const FlashGuard&) = delete;
+  FlashGuard& operator=(const FlashGuard&) = delete;
+};
+#endif
+
+SignalManager::SignalManager(uint16_t maxSignals, SignalStorage storage) {
+  _maxSignals = maxSignals > SIGNAL_MAX_CAPACITY ? SIGNAL_MAX_CAPACITY : maxSignals;
+  _storage = storage;
+  _inPSRAM = false;
   _count = 0;
+  _codes = nullptr;
+  _names = nullptr;
+  _timestamps = nullptr;
+  _nameHashes = nullptr;
+  _ids = nullptr;
+  _waveforms = nullptr;
+  _traces = nullptr;
+  _nextId = 0;
+  _codeIndex = nullptr;
+  _nameIndex = nullptr;
+  _indexMask = 0;
   
   #ifdef ESP32
+  _flashMutex = nullptr;
   _preferences = nullptr;
   _flashEnabled = false;
   _flashNamespace = "signal_mgr";
+  _journalCount = 0;
+  _pendingCount = 0;
+  _pendingFull = false;
+  _persistence = nullptr;
+  _persistClient = -1;
+  _traceRemovals = nullptr;
+  _traceRemovalCount = 0;
+  _traceRemovalCapacity = 0;
   #endif
 }
 
 SignalManager::~SignalManager() {
   end();
+  #ifdef ESP32
+  if (_flashMutex != nullptr) {
+    vSemaphoreDelete(_flashMutex);
+  }
+  #endif
 }
 
 void SignalManager::begin() {
-  if (_signals == nullptr) {
-    _signals = new SignalItem[_maxSignals];
+  _lock.begin();
+  #ifdef ESP32
+  if (_flashMutex == nullptr) {
+    _flashMutex = xSemaphoreCreateMutex();
+  }
+  FlashGuard flash(_flashMutex);
+  #endif
+  WriteGuard guard(_lock);
+  
+  if (_codes == nullptr) {
+    // 槽位数取不小于2倍容量的2的幂，保持负载因子≤0.5
+    uint32_t slots = 4;
+    while (slots < (uint32_t)_maxSignals * 2) {
+      slots <<= 1;
+    }
+    _indexMask = slots - 1;
+  
+    _inPSRAM = false;
+    #ifdef ESP32
+    _inPSRAM = (_storage == SIGNAL_STORAGE_PSRAM) && psramFound();
+    #endif
+  
+    _codes = (RFSignal*)allocTable(sizeof(RFSignal) * _maxSignals);
+    _names = (char (*)[SIGNAL_NAME_SIZE])allocTable(SIGNAL_NAME_SIZE * _maxSignals);
+    _timestamps = (uint32_t*)allocTable(sizeof(uint32_t) * _maxSignals);
+    _nameHashes = (uint32_t*)allocTable(sizeof(uint32_t) * _maxSignals);
+    _ids = (uint16_t*)allocTable(sizeof(uint16_t) * _maxSignals);
+    _waveforms = (RFWaveform**)allocTable(sizeof(RFWaveform*) * _maxSignals);
+    _traces = (SignalTrace**)allocTable(sizeof(SignalTrace*) * _maxSignals);
+    _codeIndex = (uint16_t*)allocTable(sizeof(uint16_t) * slots);
+    _nameIndex = (uint16_t*)allocTable(sizeof(uint16_t) * slots);
+  
+    if (_codes == nullptr || _names == nullptr || _timestamps == nullptr ||
+        _nameHashes == nullptr || _ids == nullptr || _waveforms == nullptr || _traces == nullptr ||
+        _codeIndex == nullptr || _nameIndex == nullptr) {
+      RF_LOGE("SIGNAL_MGR", "信号表分配失败（容量%u）", _maxSignals);
+      freeTables();
+      return;
+    }
+  
+    memset(_waveforms, 0, sizeof(RFWaveform*) * _maxSignals);
+    memset(_traces, 0, sizeof(SignalTrace*) * _maxSignals);
     _count = 0;
+    rebuildIndex();
+    RF_LOGI("SIGNAL_MGR", "信号表容量%u，位于%s", _maxSignals, _inPSRAM ? "PSRAM" : "内部SRAM");
   }
   
   #ifdef ESP32
   initFlash();
-  loadFromFlash();
+  loadFromFlashLocked();
   #endif
 }
 
 void SignalManager::end() {
-  if (_signals != nullptr) {
-    #ifdef ESP32
-    saveToFlash();
-    #endif
-    delete[] _signals;
-    _signals = nullptr;
+  // 写入尚未落盘的修改后释放内存
+  #ifdef ESP32
+  flushPending();
+  FlashGuard flash(_flashMutex);
+  #endif
+  WriteGuard guard(_lock);
+  
+  if (_codes != nullptr) {
+    freeTables();
   }
   _count = 0;
   
@@ -47,205 +279,655 @@ void SignalManager::end() {
     delete _preferences;
     _preferences = nullptr;
   }
+  free(_traceRemovals);
+  _traceRemovals = nullptr;
+  _traceRemovalCount = 0;
+  _traceRemovalCapacity = 0;
+  #endif
+}
+
+void* SignalManager::allocTable(size_t bytes) {
+  #ifdef ESP32
+  if (_inPSRAM) {
+    return heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  }
   #endif
+  return malloc(bytes);
+}
+
+void SignalManager::freeTables() {
+  releaseWaveforms();
+  releaseTraces();
+  
+  // heap_caps_malloc分配的内存同样可以用free释放
+  free(_codes);
+  _codes = nullptr;
+  free(_names);
+  _names = nullptr;
+  free(_timestamps);
+  _timestamps = nullptr;
+  free(_nameHashes);
+  _nameHashes = nullptr;
+  free(_ids);
+  _ids = nullptr;
+  free(_waveforms);
+  _waveforms = nullptr;
+  free(_traces);
+  _traces = nullptr;
+  free(_codeIndex);
+  _codeIndex = nullptr;
+  free(_nameIndex);
+  _nameIndex = nullptr;
+}
+
+void SignalManager::setEntry(uint16_t index, const char* name, const RFSignal& signal, uint32_t timestamp) {
+  copyName(_names[index], name);
+  _codes[index] = signal;
+  _timestamps[index] = timestamp;
+  releaseWaveform(index);  // 信号变化，缓存的波形作废
+}
+
+void SignalManager::moveEntry(uint16_t to, uint16_t from) {
+  memcpy(_names[to], _names[from], SIGNAL_NAME_SIZE);
+  _codes[to] = _codes[from];
+  _timestamps[to] = _timestamps[from];
+  _nameHashes[to] = _nameHashes[from];
+  _ids[to] = _ids[from];
+  _waveforms[to] = _waveforms[from];
+  _traces[to] = _traces[from];
+}
+
+// 删除一项并前移后续元素（不重建索引）
+void SignalManager::eraseEntry(uint16_t index) {
+  releaseWaveform(index);
+  setTrace(index, nullptr);
+  for (uint16_t i = index; i < _count - 1; i++) {
+    moveEntry(i, i + 1);
+  }
+  _count--;
+  _waveforms[_count] = nullptr;  // 指针已移到前一项
+  _traces[_count] = nullptr;
+}
+
+// 波形缓存（未使用的槽位保持为nullptr）
+void SignalManager::releaseWaveform(uint16_t index) {
+  if (_waveforms[index] != nullptr) {
+    _waveforms[index]->release();
+    _waveforms[index] = nullptr;
+  }
+}
+
+void SignalManager::releaseWaveforms() {
+  if (_waveforms == nullptr) {
+    return;
+  }
+  for (uint16_t i = 0; i < _maxSignals; i++) {
+    releaseWaveform(i);
+  }
+}
+
+// 原始波形的录制数据（未使用的槽位和普通信号为nullptr）
+void SignalManager::setTrace(uint16_t index, SignalTrace* trace) {
+  if (_traces[index] != trace) {
+    free(_traces[index]);
+    _traces[index] = trace;
+    releaseWaveform(index);
+  }
+}
+
+void SignalManager::releaseTraces() {
+  if (_traces == nullptr) {
+    return;
+  }
+  for (uint16_t i = 0; i < _maxSignals; i++) {
+    free(_traces[i]);
+    _traces[i] = nullptr;
+  }
+}
+
+// 分配未使用的记录ID（线性扫描，与随后的闪存写入相比开销可忽略）
+uint16_t SignalManager::allocateId() {
+  while (true) {
+    uint16_t id = _nextId;
+    _nextId = (_nextId + 1 == INDEX_EMPTY) ? 0 : _nextId + 1;
+    bool used = false;
+    for (uint16_t i = 0; i < _count; i++) {
+      if (_ids[i] == id) {
+        used = true;
+        break;
+      }
+    }
+    if (!used) {
+      return id;
+    }
+  }
+}
+
+void SignalManager::copyItem(uint16_t index, SignalItem& item) {
+  memcpy(item.name, _names[index], SIGNAL_NAME_SIZE);
+  item.signal = _codes[index];
+  item.timestamp = _timestamps[index];
 }
 
 bool SignalManager::addSignal(const String& name, const RFSignal& signal) {
-  if (_signals == nullptr || _count >= _maxSignals) {
+  bool ok;
+  {
+    WriteGuard guard(_lock);
+    ok = addSignalLocked(name, signal);
+  }
+  if (ok) {
+    persistChanges();
+  }
+  return ok;
+}
+
+bool SignalManager::addSignal(const RFSignal& signal) {
+  bool ok;
+  {
+    WriteGuard guard(_lock);
+    String name = generateAutoName(_count);
+    ok = addSignalLocked(name, signal);
+  }
+  if (ok) {
+    persistChanges();
+  }
+  return ok;
+}
+
+bool SignalManager::addRawSignal(const String& name, const uint8_t* trace, uint16_t length) {
+  uint16_t size = rfRawTraceSize(trace, length);
+  if (size == 0) {
     return false;
   }
+  SignalTrace* entry = (SignalTrace*)allocTable(sizeof(SignalTrace) + size);
+  if (entry == nullptr) {
+    return false;
+  }
+  entry->length = size;
+  entry->dirty = true;
+  memcpy(entry->data(), trace, size);
+  
+  RFSignal signal = RFSignal();
+  signal.code = rfRawTraceHash(trace, size);
+  signal.protocol = RF_PROTOCOL_RAW;
+  
+  bool ok;
+  {
+    WriteGuard guard(_lock);
+    ok = addSignalLocked(name, signal, entry);
+  }
+  if (!ok) {
+    free(entry);
+    return false;
+  }
+  persistChanges();
+  return true;
+}
+
+// trace不为nullptr时添加原始波形信号，成功后录制数据归SignalManager所有
+bool SignalManager::addSignalLocked(const String& name, const RFSignal& signal, SignalTrace* trace) {
+  if (_codes == nullptr || _count >= _maxSignals) {
+    return false;
+  }
+  if (signal.protocol == RF_PROTOCOL_RAW && trace == nullptr) {
+    return false;  // 原始波形没有录制数据无法发送
+  }
+  
+  char fixedName[SIGNAL_NAME_SIZE];
+  copyName(fixedName, name.c_str());
   
   // 检查名称是否已存在
-  for (uint8_t i = 0; i < _count; i++) {
-    if (_signals[i].name == name) {
-      // 更新现有信号
-      _signals[i].signal = signal;
-      _signals[i].timestamp = millis();
-      return true;
+  int32_t existing = findNameLocked(fixedName);
+  if (existing >= 0) {
+    // 更新现有信号（信号码变化，重建索引）
+    #ifdef ESP32
+    if (_traces[existing] != nullptr && trace == nullptr) {
+      queueTraceRemoval(_ids[existing]);  // 新的原始波形使用同一个键，直接覆盖
     }
+    #endif
+    _codes[existing] = signal;
+    _timestamps[existing] = millis();
+    releaseWaveform(existing);
+    setTrace(existing, trace);
+    rebuildIndex();
+    
+    #ifdef ESP32
+    queuePersist(JOURNAL_PUT, _ids[existing]);
+    #endif
+    return true;
   }
   
   // 添加新信号
-  _signals[_count].name = name;
-  _signals[_count].signal = signal;
-  _signals[_count].timestamp = millis();
+  setEntry(_count, fixedName, signal, millis());
+  setTrace(_count, trace);
+  _ids[_count] = allocateId();
+  indexInsert(_count);
   _count++;
   
   #ifdef ESP32
-  if (_flashEnabled) {
-    saveToFlash();
-  }
+  queuePersist(JOURNAL_PUT, _ids[_count - 1]);
   #endif
   
   return true;
 }
 
-bool SignalManager::addSignal(const RFSignal& signal) {
-  String name = generateAutoName(_count);
-  return addSignal(name, signal);
+bool SignalManager::removeSignal(uint16_t index) {
+  bool ok;
+  {
+    WriteGuard guard(_lock);
+    ok = removeSignalLocked(index);
+  }
+  if (ok) {
+    persistChanges();
+  }
+  return ok;
 }
 
-bool SignalManager::removeSignal(uint8_t index) {
-  if (_signals == nullptr || index >= _count) {
+bool SignalManager::removeSignalLocked(uint16_t index) {
+  if (_codes == nullptr || index >= _count) {
     return false;
   }
   
-  // 移动后续元素
-  for (uint8_t i = index; i < _count - 1; i++) {
-    _signals[i] = _signals[i + 1];
+  uint16_t id = _ids[index];
+  #ifdef ESP32
+  if (_traces[index] != nullptr) {
+    queueTraceRemoval(id);
   }
-  _count--;
+  #endif
+  
+  // 移动后续元素（后续索引全部变化，重建哈希索引）
+  eraseEntry(index);
+  rebuildIndex();
   
+  // 其他记录不受影响，只追加一条删除日志
   #ifdef ESP32
-  if (_flashEnabled) {
-    saveToFlash();
-  }
+  queuePersist(JOURNAL_REMOVE, id);
   #endif
   
   return true;
 }
 
 bool SignalManager::removeSignal(const String& name) {
-  if (_signals == nullptr) {
-    return false;
+  bool ok;
+  {
+    WriteGuard guard(_lock);
+    int32_t index = findNameLocked(name.c_str());
+    ok = index >= 0 && removeSignalLocked(index);
   }
-  
-  for (uint8_t i = 0; i < _count; i++) {
-    if (_signals[i].name == name) {
-      return removeSignal(i);
-    }
+  if (ok) {
+    persistChanges();
   }
-  
-  return false;
+  return ok;
 }
 
-bool SignalManager::updateSignal(uint8_t index, const String& name, const RFSignal& signal) {
-  if (_signals == nullptr || index >= _count) {
+bool SignalManager::updateSignal(uint16_t index, const String& name, const RFSignal& signal) {
+  bool ok;
+  {
+    WriteGuard guard(_lock);
+    ok = updateSignalLocked(index, name, signal);
+  }
+  if (ok) {
+    persistChanges();
+  }
+  return ok;
+}
+
+bool SignalManager::updateSignalLocked(uint16_t index, const String& name, const RFSignal& signal) {
+  if (_codes == nullptr || index >= _count) {
+    return false;
+  }
+  
+  // 原始波形只能改名（信号码不变），其他修改使其变为普通信号
+  bool keepTrace = _traces[index] != nullptr && signal.protocol == RF_PROTOCOL_RAW &&
+                   signal.code == _codes[index].code;
+  if (signal.protocol == RF_PROTOCOL_RAW && !keepTrace) {
     return false;
   }
+  if (_traces[index] != nullptr && !keepTrace) {
+    #ifdef ESP32
+    queueTraceRemoval(_ids[index]);
+    #endif
+    setTrace(index, nullptr);
+  }
   
-  _signals[index].name = name;
-  _signals[index].signal = signal;
-  _signals[index].timestamp = millis();
+  setEntry(index, name.c_str(), signal, millis());
+  rebuildIndex();
   
   #ifdef ESP32
-  if (_flashEnabled) {
-    saveToFlash();
-  }
+  queuePersist(JOURNAL_PUT, _ids[index]);
   #endif
   
   return true;
 }
 
-bool SignalManager::getSignal(uint8_t index, SignalItem& item) {
-  if (_signals == nullptr || index >= _count) {
+bool SignalManager::getSignal(uint16_t index, SignalItem& item) {
+  ReadGuard guard(_lock);
+  if (_codes == nullptr || index >= _count) {
     return false;
   }
   
-  item = _signals[index];
+  copyItem(index, item);
   return true;
 }
 
 bool SignalManager::getSignal(const String& name, SignalItem& item) {
-  if (_signals == nullptr) {
+  ReadGuard guard(_lock);
+  int32_t index = findNameLocked(name.c_str());
+  if (index < 0) {
     return false;
   }
   
-  for (uint8_t i = 0; i < _count; i++) {
-    if (_signals[i].name == name) {
-      item = _signals[i];
-      return true;
-    }
-  }
-  
-  return false;
+  copyItem(index, item);
+  return true;
 }
 
-uint8_t SignalManager::getCount() {
+uint16_t SignalManager::getCount() {
   return _count;
 }
 
 void SignalManager::clear() {
-  _count = 0;
+  {
+    WriteGuard guard(_lock);
+    #ifdef ESP32
+    for (uint16_t i = 0; i < _count; i++) {
+      if (_traces[i] != nullptr) {
+        queueTraceRemoval(_ids[i]);  // 清空前又添加了信号时整表保存不会清空命名空间
+      }
+    }
+    #endif
+    releaseWaveforms();
+    releaseTraces();
+    _count = 0;  // 记录ID不重新分配，旧日志中的ID不会落到新信号上
+    rebuildIndex();
+    
+    #ifdef ESP32
+    if (_flashEnabled) {
+      _pendingCount = 0;
+      _pendingFull = true;  // 刷新时清空命名空间
+    }
+    #endif
+  }
+  persistChanges();
+}
+
+bool SignalManager::sendSignal(uint16_t index, ESP433RF& rf) {
+  return sendEntry(index, nullptr, rf);
+}
+
+bool SignalManager::sendSignal(const String& name, ESP433RF& rf) {
+  return sendEntry(0, name.c_str(), rf);
+}
+
+// name不为nullptr时按名称查找，否则按索引（每次加锁都重新查找，两次加锁之间表可能变化）
+int32_t SignalManager::resolveEntryLocked(uint16_t index, const char* name) {
+  if (name != nullptr) {
+    return findNameLocked(name);
+  }
+  return (_codes != nullptr && index < _count) ? index : -1;
+}
+
+bool SignalManager::sendEntry(uint16_t index, const char* name, ESP433RF& rf) {
+  RFSignal signal;
+  RFWaveform* waveform = nullptr;
+  {
+    // 只在读锁内复制信号和引用缓存的波形，发送期间不持有锁
+    ReadGuard guard(_lock);
+    int32_t found = resolveEntryLocked(index, name);
+    if (found < 0) {
+      return false;
+    }
+    signal = _codes[found];
+    waveform = acquireWaveformLocked(found, rf, false);
+  }
   
-  #ifdef ESP32
-  if (_flashEnabled) {
-    clearFlash();
+  if (waveform == nullptr) {
+    // 首次发送或协议/脉宽设置已变化：编码一次并缓存到该信号项
+    WriteGuard guard(_lock);
+    int32_t found = resolveEntryLocked(index, name);
+    if (found < 0) {
+      return false;
+    }
+    signal = _codes[found];
+    waveform = acquireWaveformLocked(found, rf, true);
   }
-  #endif
+  
+  // 编码失败（waveform为nullptr）时退回到逐次编码发送
+  return sendCopy(signal, waveform, rf);
 }
 
-bool SignalManager::sendSignal(uint8_t index, ESP433RF& rf) {
-  if (_signals == nullptr || index >= _count) {
+// 引用信号项缓存的波形（调用者负责release），build为true时（持有写锁）重新编码失效的波形
+RFWaveform* SignalManager::acquireWaveformLocked(uint16_t index, ESP433RF& rf, bool build) {
+  RFWaveform* waveform = _waveforms[index];
+  if (waveform == nullptr || !rf.isWaveformCurrent(waveform, _codes[index])) {
+    if (!build) {
+      return nullptr;
+    }
+    releaseWaveform(index);
+    SignalTrace* trace = _traces[index];
+    waveform = trace != nullptr ? rf.encodeRawWaveform(trace->data(), trace->length) : rf.encodeWaveform(_codes[index]);
+    _waveforms[index] = waveform;
+    if (waveform == nullptr) {
+      return nullptr;
+    }
+  }
+  waveform->retain();
+  return waveform;
+}
+
+bool SignalManager::sendBatch(const SignalBatchItem* items, uint8_t count, ESP433RF& rf) {
+  if (items == nullptr || count == 0 || count > RF_TX_BATCH_MAX) {
     return false;
   }
-  
-  // 发送前临时禁用接收，避免接收到自己发送的信号
-  bool wasReceiving = rf.isReceiving();
-  if (wasReceiving) {
-    rf.disableReceive();
+  RFTxItem* batch = (RFTxItem*)malloc(sizeof(RFTxItem) * count);
+  if (batch == nullptr) {
+    return false;
   }
   
-  rf.send(_signals[index].signal);
+  int16_t missing;
+  {
+    ReadGuard guard(_lock);
+    missing = fillBatchLocked(items, count, batch, rf, false);
+  }
+  if (missing > 0) {
+    // 有信号尚未编码：在写锁内重新收集并补齐缓存
+    releaseBatch(batch, count);
+    WriteGuard guard(_lock);
+    missing = fillBatchLocked(items, count, batch, rf, true);
+  }
+  if (missing < 0) {
+    free(batch);
+    return false;
+  }
   
-  // 延迟一下，确保发送完成
-  delay(200);
+  RFTxHandle handle = rf.sendBatch(batch, count, RF_TX_SUPPRESS_ECHO);
+  releaseBatch(batch, count);  // 入队的请求持有自己的引用
+  free(batch);
+  return handle != 0;
+}
+
+// 复制批量发送项的信号并引用缓存的波形，返回缺少波形的项数，索引无效时返回-1（不持有任何引用）
+// 指定了重复次数的项与缓存的波形不一致，由发送任务按项编码（原始波形自带重复次数，总是使用缓存）
+int16_t SignalManager::fillBatchLocked(const SignalBatchItem* items, uint8_t count, RFTxItem* batch,
+                                       ESP433RF& rf, bool build) {
+  int16_t missing = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t index = items[i].index;
+    if (_codes == nullptr || index >= _count) {
+      releaseBatch(batch, i);
+      return -1;
+    }
+    batch[i].signal = _codes[index];
+    batch[i].repeats = items[i].repeats;
+    batch[i].gapMs = items[i].gapMs;
+    batch[i].waveform = nullptr;
+    if (items[i].repeats == 0 || _traces[index] != nullptr) {
+      batch[i].waveform = acquireWaveformLocked(index, rf, build);
+      if (batch[i].waveform == nullptr) {
+        missing++;
+      }
+    }
+  }
+  return missing;
+}
+
+void SignalManager::releaseBatch(RFTxItem* batch, uint8_t count) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (batch[i].waveform != nullptr) {
+      batch[i].waveform->release();
+      batch[i].waveform = nullptr;
+    }
+  }
+}
+
+bool SignalManager::sendCopy(const RFSignal& signal, RFWaveform* waveform, ESP433RF& rf) {
+  // 发送期间继续接收，只过滤自己发送的信号（回声）；启动发送任务时只入队不等待
+  RFTxHandle handle = rf.sendWaveform(signal, waveform, RF_TX_SUPPRESS_ECHO);
+  if (waveform != nullptr) {
+    waveform->release();  // 入队的请求持有自己的引用
+  }
+  return handle != 0;
+}
+
+bool SignalManager::getAllSignals(SignalItem* items, uint16_t maxCount) {
+  ReadGuard guard(_lock);
+  if (_codes == nullptr || items == nullptr) {
+    return false;
+  }
   
-  // 恢复接收
-  if (wasReceiving) {
-    rf.enableReceive();
+  uint16_t copyCount = (_count < maxCount) ? _count : maxCount;
+  for (uint16_t i = 0; i < copyCount; i++) {
+    copyItem(i, items[i]);
   }
   
   return true;
 }
 
-bool SignalManager::sendSignal(const String& name, ESP433RF& rf) {
-  if (_signals == nullptr) {
-    return false;
+void SignalManager::forEachSignal(SignalVisitor visitor, void* context, uint16_t offset, uint16_t limit) {
+  ReadGuard guard(_lock);
+  if (_codes == nullptr || visitor == nullptr) {
+    return;
   }
   
-  for (uint8_t i = 0; i < _count; i++) {
-    if (_signals[i].name == name) {
-      // 发送前临时禁用接收，避免接收到自己发送的信号
-      bool wasReceiving = rf.isReceiving();
-      if (wasReceiving) {
-        rf.disableReceive();
-      }
-      
-      rf.send(_signals[i].signal);
-      
-      // 延迟一下，确保发送完成
-      delay(200);
-      
-      // 恢复接收
-      if (wasReceiving) {
-        rf.enableReceive();
-      }
-      
-      return true;
+  SignalItem item;
+  uint32_t end = (uint32_t)offset + limit < _count ? (uint32_t)offset + limit : _count;
+  for (uint16_t i = offset; i < end; i++) {
+    copyItem(i, item);
+    if (!visitor(i, item, context)) {
+      break;
     }
   }
-  
-  return false;
 }
 
-bool SignalManager::getAllSignals(SignalItem* items, uint8_t maxCount) {
-  if (_signals == nullptr || items == nullptr) {
-    return false;
+int32_t SignalManager::findSignal(const RFSignal& signal) {
+  ReadGuard guard(_lock);
+  return findCodeLocked(signal);
+}
+
+int32_t SignalManager::findSignal(const String& name) {
+  ReadGuard guard(_lock);
+  return findNameLocked(name.c_str());
+}
+
+// ========== 哈希索引 ==========
+
+// FNV-1a
+uint32_t SignalManager::hashName(const char* name) {
+  uint32_t hash = 2166136261u;
+  for (const char* p = name; *p != '\0'; p++) {
+    hash ^= (uint8_t)*p;
+    hash *= 16777619u;
   }
+  return hash;
+}
+
+// 32位整数混合（murmur3 finalizer），让相近的信号码分散到不同槽位
+uint32_t SignalManager::hashCode(const RFSignal& signal) {
+  uint32_t code = signal.digest();
+  code ^= code >> 16;
+  code *= 0x85EBCA6Bu;
+  code ^= code >> 13;
+  code *= 0xC2B2AE35u;
+  code ^= code >> 16;
+  return code;
+}
+
+void SignalManager::indexInsert(uint16_t index) {
+  uint32_t nameHash = hashName(_names[index]);
+  _nameHashes[index] = nameHash;
   
-  uint8_t copyCount = (_count < maxCount) ? _count : maxCount;
-  for (uint8_t i = 0; i < copyCount; i++) {
-    items[i] = _signals[i];
+  uint32_t slot = hashCode(_codes[index]) & _indexMask;
+  while (_codeIndex[slot] != INDEX_EMPTY) {
+    slot = (slot + 1) & _indexMask;
   }
+  _codeIndex[slot] = index;
   
-  return true;
+  slot = nameHash & _indexMask;
+  while (_nameIndex[slot] != INDEX_EMPTY) {
+    slot = (slot + 1) & _indexMask;
+  }
+  _nameIndex[slot] = index;
 }
 
-String SignalManager::generateAutoName(uint8_t index) {
+void SignalManager::rebuildIndex() {
+  if (_codeIndex == nullptr) {
+    return;
+  }
+  memset(_codeIndex, 0xFF, sizeof(uint16_t) * (_indexMask + 1));
+  memset(_nameIndex, 0xFF, sizeof(uint16_t) * (_indexMask + 1));
+  for (uint16_t i = 0; i < _count; i++) {
+    indexInsert(i);
+  }
+}
+
+int32_t SignalManager::findCodeLocked(const RFSignal& signal) {
+  if (_codeIndex == nullptr) {
+    return -1;
+  }
+  uint32_t slot = hashCode(signal) & _indexMask;
+  uint16_t index;
+  while ((index = _codeIndex[slot]) != INDEX_EMPTY) {
+    if (_codes[index].sameCode(signal)) {
+      return index;
+    }
+    slot = (slot + 1) & _indexMask;
+  }
+  return -1;
+}
+
+int32_t SignalManager::findNameLocked(const char* name) {
+  if (_nameIndex == nullptr) {
+    return -1;
+  }
+  uint32_t nameHash = hashName(name);
+  uint32_t slot = nameHash & _indexMask;
+  uint16_t index;
+  while ((index = _nameIndex[slot]) != INDEX_EMPTY) {
+    if (_nameHashes[index] == nameHash && strcmp(_names[index], name) == 0) {
+      return index;
+    }
+    slot = (slot + 1) & _indexMask;
+  }
+  return -1;
+}
+
+String SignalManager::generateAutoName(uint16_t index) {
   return "Signal_" + String(index + 1);
 }
 
+// 修改完成后（已释放写锁）写入闪存：设置了RFPersistence时由它调度，否则在调用者中写入
+void SignalManager::persistChanges() {
+  #ifdef ESP32
+  if (!_flashEnabled) {
+    return;
+  }
+  if (_persistence != nullptr) {
+    _persistence->markDirty(_persistClient);
+  } else {
+    flushPending();
+  }
+  #endif
+}
+
 #ifdef ESP32
 void SignalManager::initFlash() {
   if (_preferences == nullptr) {
@@ -255,58 +937,707 @@ void SignalManager::initFlash() {
 }
 
 bool SignalManager::saveToFlash() {
-  if (!_flashEnabled || _preferences == nullptr || _signals == nullptr) {
+  if (!_flashEnabled) {
+    return false;
+  }
+  {
+    WriteGuard guard(_lock);
+    if (_codes == nullptr) {
+      return false;
+    }
+    _pendingFull = true;
+  }
+  return flushPending();
+}
+
+// 全量保存（调用者持有闪存互斥量和写锁，用于加载时的格式迁移）
+bool SignalManager::saveToFlashLocked() {
+  _pendingFull = true;
+  SignalFlushBatch* batch = takeFlushBatchLocked();
+  if (batch == nullptr) {
+    return false;
+  }
+  bool ok = writeFlushBatch(batch);
+  if (!ok) {
+    restoreFlushBatchLocked(batch);
+  }
+  freeFlushBatch(batch);
+  return ok;
+}
+
+// 生成信号表和各分块（调用者持有写锁），内存不足时返回false（已分配的内存由freeFlushBatch()释放）
+bool SignalManager::buildTableLocked(SignalFlushBatch* batch) {
+  // 按记录ID排序（ID << 16 | 索引），同一块的信号相邻
+  uint32_t* sorted = (uint32_t*)allocTable(sizeof(uint32_t) * _count);
+  if (sorted == nullptr) {
     return false;
   }
+  uint16_t chunkCount = 0;
+  size_t chunksSize = 0;
+  for (uint16_t i = 0; i < _count; i++) {
+    sorted[i] = (uint32_t)_ids[i] << 16 | i;
+    chunksSize += sizeof(SignalTableRecord) + strlen(_names[i]);
+  }
+  qsort(sorted, _count, sizeof(uint32_t), compareIds);
+  for (uint16_t i = 0; i < _count; i++) {
+    if (i == 0 || (sorted[i] >> 16) / SIGNAL_TABLE_CHUNK_SIZE != (sorted[i - 1] >> 16) / SIGNAL_TABLE_CHUNK_SIZE) {
+      chunkCount++;
+    }
+  }
+  chunksSize += (sizeof(SignalChunkHeader) + 3) * chunkCount;
   
-  _preferences->begin(_flashNamespace.c_str(), false);
-  _preferences->putUChar("count", _count);
+  batch->tableSize = sizeof(SignalTableHeader) + sizeof(SignalChunkEntry) * chunkCount + sizeof(uint16_t) * _count;
+  batch->table = (uint8_t*)allocTable(batch->tableSize);
+  batch->chunks = (uint8_t*)allocTable(chunksSize);
+  if (batch->table == nullptr || batch->chunks == nullptr) {
+    free(sorted);
+    return false;
+  }
   
-  for (uint8_t i = 0; i < _count; i++) {
-    String keyPrefix = "sig_" + String(i) + "_";
-    _preferences->putString((keyPrefix + "name").c_str(), _signals[i].name);
-    _preferences->putString((keyPrefix + "addr").c_str(), _signals[i].signal.address);
-    _preferences->putString((keyPrefix + "key").c_str(), _signals[i].signal.key);
-    _preferences->putULong((keyPrefix + "time").c_str(), _signals[i].timestamp);
+  SignalTableHeader* header = (SignalTableHeader*)batch->table;
+  SignalChunkEntry* directory = (SignalChunkEntry*)(header + 1);
+  uint16_t* order = (uint16_t*)(directory + chunkCount);
+  memcpy(order, _ids, sizeof(uint16_t) * _count);
+  
+  uint8_t* out = batch->chunks;
+  uint16_t start = 0;
+  for (uint16_t c = 0; c < chunkCount; c++) {
+    uint16_t chunk = (sorted[start] >> 16) / SIGNAL_TABLE_CHUNK_SIZE;
+    uint16_t end = start;
+    while (end < _count && (sorted[end] >> 16) / SIGNAL_TABLE_CHUNK_SIZE == chunk) {
+      end++;
+    }
+    
+    SignalChunkHeader* chunkHeader = (SignalChunkHeader*)out;
+    SignalTableRecord* records = (SignalTableRecord*)(chunkHeader + 1);
+    char* pool = (char*)(records + (end - start));
+    uint16_t offset = 0;
+    for (uint16_t j = start; j < end; j++) {
+      uint16_t i = sorted[j] & 0xFFFF;
+      uint8_t nameLength = strlen(_names[i]);
+      SignalTableRecord& record = records[j - start];
+      record.code = (uint32_t)_codes[i].code;
+      record.codeHigh = (uint32_t)(_codes[i].code >> 32);
+      record.bitLength = _codes[i].bitLength;
+      record.timestamp = _timestamps[i];
+      record.nameOffset = offset;
+      record.pulseLength = _codes[i].pulseLength;
+      record.id = _ids[i];
+      record.protocol = _codes[i].protocol;
+      record.nameLength = nameLength;
+      record.reserved = 0;
+      memcpy(pool + offset, _names[i], nameLength);
+      offset += nameLength;
+    }
+    chunkHeader->count = end - start;
+    chunkHeader->poolSize = offset;
+    chunkHeader->crc = crc32((const uint8_t*)records, sizeof(SignalTableRecord) * chunkHeader->count + offset);
+    
+    directory[c].chunk = chunk;
+    directory[c].count = chunkHeader->count;
+    directory[c].crc = chunkHeader->crc;
+    out += (chunkSize(chunkHeader) + 3) & ~(size_t)3;  // 下一块的块头对齐
+    start = end;
   }
+  free(sorted);
   
-  _preferences->end();
+  header->magic = SIGNAL_TABLE_MAGIC;
+  header->version = SIGNAL_FLASH_FORMAT;
+  header->recordSize = sizeof(SignalTableRecord);
+  header->count = _count;
+  header->nextId = _nextId;
+  header->chunkCount = chunkCount;
+  header->crc = crc32((const uint8_t*)directory, batch->tableSize - sizeof(SignalTableHeader));
   return true;
 }
 
 bool SignalManager::loadFromFlash() {
-  if (!_flashEnabled || _preferences == nullptr || _signals == nullptr) {
+  FlashGuard flash(_flashMutex);
+  WriteGuard guard(_lock);
+  return loadFromFlashLocked();
+}
+
+bool SignalManager::loadFromFlashLocked() {
+  if (!_flashEnabled || _preferences == nullptr || _codes == nullptr) {
     return false;
   }
   
+  releaseWaveforms();
+  releaseTraces();
+  _count = 0;  // _nextId保持不变：从闪存读到的ID只会使它增大
+  _journalCount = 0;
+  _traceRemovalCount = 0;
+  _pendingCount = 0;
+  _pendingFull = false;
+  
   _preferences->begin(_flashNamespace.c_str(), true);
-  uint8_t savedCount = _preferences->getUChar("count", 0);
+  bool hasTable = _preferences->isKey("table");
+  bool hasLegacy = _preferences->isKey("count");
+  _preferences->end();
   
-  if (savedCount > _maxSignals) {
-    savedCount = _maxSignals;
+  // 旧版格式只迁移一次：加载后写入信号表并删除旧键
+  if (!hasTable && hasLegacy) {
+    return loadLegacyLocked();
   }
   
-  _count = 0;
-  for (uint8_t i = 0; i < savedCount; i++) {
+  // 信号表（没有时为空表）+ 自上次合并以来的增量日志
+  bool ok = !hasTable || loadTableLocked();
+  replayJournalLocked();
+  loadTracesLocked();
+  rebuildIndex();
+  return ok;
+}
+
+// 读取信号表和全部分块并校验，按信号表中的顺序加载；损坏的块跳过，其余的块照常加载
+bool SignalManager::loadTableLocked() {
+  _preferences->begin(_flashNamespace.c_str(), true);
+  size_t total = _preferences->getBytesLength("table");
+  uint8_t* table = total >= sizeof(SignalTableHeader) ? (uint8_t*)allocTable(total) : nullptr;
+  bool ok = table != nullptr && _preferences->getBytes("table", table, total) == total && checkTable(table, total);
+  if (!ok) {
+    _preferences->end();
+    RF_LOGW("SIGNAL_MGR", "信号表损坏或版本不匹配，已忽略");
+    free(table);
+    return false;
+  }
+  
+  const SignalTableHeader* header = (const SignalTableHeader*)table;
+  const SignalChunkEntry* directory = (const SignalChunkEntry*)(header + 1);
+  const uint16_t* order = (const uint16_t*)(directory + header->chunkCount);
+  uint8_t** chunks = (uint8_t**)calloc(header->chunkCount > 0 ? header->chunkCount : 1, sizeof(uint8_t*));
+  uint32_t records = 0;
+  char key[8];
+  for (uint16_t c = 0; c < header->chunkCount && chunks != nullptr; c++) {
+    chunkKey(directory[c].chunk, key);
+    size_t size = _preferences->getBytesLength(key);
+    uint8_t* data = size >= sizeof(SignalChunkHeader) ? (uint8_t*)allocTable(size) : nullptr;
+    if (data == nullptr || _preferences->getBytes(key, data, size) != size || !checkChunk(data, size)) {
+      RF_LOGW("SIGNAL_MGR", "信号表分块%u损坏，已忽略", directory[c].chunk);
+      free(data);
+      ok = false;
+      continue;
+    }
+    chunks[c] = data;
+    records += ((const SignalChunkHeader*)data)->count;
+  }
+  _preferences->end();
+  
+  // 记录ID -> 在信号表中的位置（ID << 16 | 位置，按ID排序）；
+  // 信号表中没有的记录（块比信号表新）排在最后，随后重放的日志会修正
+  uint32_t* positions = (uint32_t*)allocTable(sizeof(uint32_t) * (header->count > 0 ? header->count : 1));
+  size_t slotCount = header->count + records;
+  SignalTableSlot* slots = (SignalTableSlot*)allocTable(sizeof(SignalTableSlot) * (slotCount > 0 ? slotCount : 1));
+  if (chunks == nullptr || positions == nullptr || slots == nullptr) {
+    RF_LOGE("SIGNAL_MGR", "加载失败：内存不足");
+    ok = false;
+  } else {
+    for (uint16_t i = 0; i < header->count; i++) {
+      positions[i] = (uint32_t)order[i] << 16 | i;
+    }
+    qsort(positions, header->count, sizeof(uint32_t), compareIds);
+    memset(slots, 0, sizeof(SignalTableSlot) * slotCount);
+    
+    uint32_t extra = header->count;
+    for (uint16_t c = 0; c < header->chunkCount; c++) {
+      if (chunks[c] == nullptr) {
+        continue;
+      }
+      const SignalChunkHeader* chunk = (const SignalChunkHeader*)chunks[c];
+      const SignalTableRecord* chunkRecords = (const SignalTableRecord*)(chunk + 1);
+      const char* pool = (const char*)(chunkRecords + chunk->count);
+      for (uint16_t j = 0; j < chunk->count; j++) {
+        const SignalTableRecord& record = chunkRecords[j];
+        if (record.nameOffset + record.nameLength > chunk->poolSize || record.nameLength >= SIGNAL_NAME_SIZE) {
+          continue;
+        }
+        uint32_t id = (uint32_t)record.id << 16;
+        const uint32_t* found = (const uint32_t*)bsearch(&id, positions, header->count, sizeof(uint32_t), compareIds);
+        uint32_t slot = found != nullptr ? (*found & 0xFFFF) : extra++;
+        if (slots[slot].record == nullptr) {
+          slots[slot].record = &record;
+          slots[slot].pool = pool;
+        }
+      }
+    }
+    
+    char name[SIGNAL_NAME_SIZE];
+    for (uint32_t slot = 0; slot < extra && _count < _maxSignals; slot++) {
+      const SignalTableRecord* record = slots[slot].record;
+      if (record == nullptr) {
+        continue;  // 记录所在的块损坏（或已在新的块中删除）
+      }
+      memcpy(name, slots[slot].pool + record->nameOffset, record->nameLength);
+      name[record->nameLength] = '\0';
+      
+      RFSignal signal = RFSignal();
+      signal.code = (uint64_t)record->codeHigh << 32 | record->code;
+      signal.bitLength = record->bitLength;
+      signal.protocol = record->protocol;
+      signal.pulseLength = record->pulseLength;
+      setEntry(_count, name, signal, record->timestamp);
+      _ids[_count] = record->id;
+      _count++;
+    }
+  }
+  if (header->nextId > _nextId) {
+    _nextId = header->nextId;
+  }
+  
+  for (uint16_t c = 0; c < header->chunkCount && chunks != nullptr; c++) {
+    free(chunks[c]);
+  }
+  free(chunks);
+  free(positions);
+  free(slots);
+  free(table);
+  return ok;
+}
+
+// 在信号表上重放增量日志（最多SIGNAL_JOURNAL_SIZE条）
+void SignalManager::replayJournalLocked() {
+  _preferences->begin(_flashNamespace.c_str(), true);
+  size_t length = _preferences->getBytesLength("journal");
+  if (length > sizeof(_journal)) {
+    length = sizeof(_journal);
+  }
+  _journalCount = length > 0 ? _preferences->getBytes("journal", _journal, length) / sizeof(uint32_t) : 0;
+  _preferences->end();
+  
+  for (uint8_t i = 0; i < _journalCount; i++) {
+    uint16_t id = _journal[i] & 0xFFFF;
+    // 已删除记录的ID同样不再分配（日志中的删除不能落到新记录上）
+    if (id >= _nextId && id + 1 < INDEX_EMPTY) {
+      _nextId = id + 1;
+    }
+    if ((_journal[i] >> 16) == JOURNAL_PUT) {
+      applyRecordLocked(id);
+    } else {
+      int32_t index = findIdLocked(id);
+      if (index >= 0) {
+        eraseEntry(index);
+      }
+    }
+  }
+}
+
+// 读取一条增量记录，更新同ID的信号或追加到末尾
+bool SignalManager::applyRecordLocked(uint16_t id) {
+  char key[8];
+  recordKey(id, key);
+  SignalRecord record;
+  memset(&record, 0, sizeof(record));
+  _preferences->begin(_flashNamespace.c_str(), true);
+  size_t len = _preferences->getBytes(key, &record, sizeof(record));
+  _preferences->end();
+  if (len <= offsetof(SignalRecord, name)) {
+    return false;  // 记录已删除或未写完
+  }
+  record.name[SIGNAL_NAME_SIZE - 1] = '\0';
+  
+  int32_t index = findIdLocked(id);
+  if (index < 0) {
+    if (_count >= _maxSignals) {
+      return false;
+    }
+    index = _count++;
+  }
+  
+  RFSignal signal = RFSignal();
+  signal.code = (uint64_t)record.codeHigh << 32 | record.code;
+  signal.bitLength = record.bitLength;
+  signal.protocol = record.protocol;
+  signal.pulseLength = record.pulseLength;
+  setEntry(index, record.name, signal, record.timestamp);
+  _ids[index] = id;
+  if (id >= _nextId && id + 1 < INDEX_EMPTY) {
+    _nextId = id + 1;
+  }
+  return true;
+}
+
+int32_t SignalManager::findIdLocked(uint16_t id) {
+  for (uint16_t i = 0; i < _count; i++) {
+    if (_ids[i] == id) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// 迁移格式1（sig_N_name/addr/key/time字符串键）
+bool SignalManager::loadLegacyLocked() {
+  _preferences->begin(_flashNamespace.c_str(), true);
+  uint8_t savedCount = _preferences->getUChar("count", 0);
+  
+  uint16_t loadCount = savedCount > _maxSignals ? _maxSignals : savedCount;
+  for (uint16_t i = 0; i < loadCount; i++) {
     String keyPrefix = "sig_" + String(i) + "_";
     String name = _preferences->getString((keyPrefix + "name").c_str(), "");
-    String addr = _preferences->getString((keyPrefix + "addr").c_str(), "");
-    String key = _preferences->getString((keyPrefix + "key").c_str(), "");
+    char addr[8] = "";
+    char key[4] = "";
+    _preferences->getString((keyPrefix + "addr").c_str(), addr, sizeof(addr));
+    _preferences->getString((keyPrefix + "key").c_str(), key, sizeof(key));
     
-    if (name.length() > 0 && addr.length() > 0 && key.length() > 0) {
-      _signals[_count].name = name;
-      _signals[_count].signal.address = addr;
-      _signals[_count].signal.key = key;
-      _signals[_count].timestamp = _preferences->getULong((keyPrefix + "time").c_str(), millis());
+    RFSignal signal;
+    if (name.length() > 0 && RFSignal::fromHex(addr, key, signal)) {
+      setEntry(_count, name.c_str(), signal, _preferences->getULong((keyPrefix + "time").c_str(), millis()));
+      _ids[_count] = allocateId();
       _count++;
     }
   }
+  _preferences->end();
+  rebuildIndex();
+  
+  RF_LOGI("SIGNAL_MGR", "迁移闪存格式1：%u个信号", _count);
+  bool ok = saveToFlashLocked();
+  if (ok) {
+    // 信号表写入成功后才删除旧键，迁移中途掉电不会丢数据
+    static const char* const FIELDS[] = {"name", "addr", "key", "time"};
+    _preferences->begin(_flashNamespace.c_str(), false);
+    for (uint16_t i = 0; i < savedCount; i++) {
+      for (uint8_t f = 0; f < 4; f++) {
+        String key = "sig_" + String(i) + "_" + FIELDS[f];
+        _preferences->remove(key.c_str());
+      }
+    }
+    _preferences->remove("count");
+    _preferences->end();
+  }
+  return ok;
+}
+
+void SignalManager::recordKey(uint16_t id, char* key) {
+  snprintf(key, 8, "r%04x", id);
+}
+
+void SignalManager::chunkKey(uint16_t chunk, char* key) {
+  snprintf(key, 8, "c%03x", chunk);
+}
+
+void SignalManager::setPersistence(RFPersistence* persistence) {
+  WriteGuard guard(_lock);
+  _persistence = persistence;
+  _persistClient = persistence != nullptr ? persistence->registerClient("SignalManager", persistFlush, this) : -1;
+  if (_persistClient < 0) {
+    _persistence = nullptr;  // 注册失败时回退到同步写入
+  }
+}
+
+// 记录一次修改（调用者持有写锁），释放写锁后由persistChanges()写入或交给持久化任务
+void SignalManager::queuePersist(uint8_t op, uint16_t id) {
+  if (!_flashEnabled) {
+    return;
+  }
+  
+  uint32_t entry = ((uint32_t)op << 16) | id;
+  if (!_pendingFull) {
+    bool queued = false;
+    for (uint8_t i = 0; i < _pendingCount && op == JOURNAL_PUT; i++) {
+      if (_pending[i] == entry) {
+        queued = true;  // 同一记录多次修改只写一次
+        break;
+      }
+    }
+    if (!queued && _pendingCount < SIGNAL_JOURNAL_SIZE) {
+      _pending[_pendingCount++] = entry;
+    } else if (!queued) {
+      _pendingFull = true;
+    }
+  }
+}
+
+bool SignalManager::persistFlush(void* context) {
+  return static_cast<SignalManager*>(context)->flushPending();
+}
+
+// 把待写入的修改写入闪存：写锁内取出，写锁外写入（写闪存期间查询、发送和修改都不等待）
+bool SignalManager::flushPending() {
+  FlashGuard flash(_flashMutex);
+  if (!_flashEnabled || _preferences == nullptr) {
+    return true;
+  }
+  
+  SignalFlushBatch* batch;
+  {
+    WriteGuard guard(_lock);
+    if (_codes == nullptr || (_pendingCount == 0 && !_pendingFull && _traceRemovalCount == 0)) {
+      return true;
+    }
+    batch = takeFlushBatchLocked();
+  }
+  if (batch == nullptr) {
+    return false;  // 内存不足，修改保留到下次刷新
+  }
+  
+  bool ok = writeFlushBatch(batch);
+  if (!ok) {
+    WriteGuard guard(_lock);
+    restoreFlushBatchLocked(batch);
+  }
+  freeFlushBatch(batch);
+  return ok;
+}
+
+// 取出待写入的修改（调用者持有闪存互斥量和写锁）；先分配全部内存，失败时不改变任何状态
+SignalFlushBatch* SignalManager::takeFlushBatchLocked() {
+  SignalFlushBatch* batch = (SignalFlushBatch*)calloc(1, sizeof(SignalFlushBatch));
+  if (batch == nullptr) {
+    RF_LOGE("SIGNAL_MGR", "保存失败：内存不足");
+    return nullptr;
+  }
+  
+  // 日志放不下时合并为新的信号表；清空后整表保存即清空命名空间
+  batch->full = _pendingFull || _journalCount + _pendingCount > SIGNAL_JOURNAL_SIZE;
+  bool ok = true;
+  if (batch->full && _count > 0) {
+    ok = buildTableLocked(batch);
+  }
+  
+  // 录制数据复制一份：写入期间信号可能被删除或替换
+  uint16_t dirty = 0;
+  for (uint16_t i = 0; i < _count; i++) {
+    if (_traces[i] != nullptr && _traces[i]->dirty) {
+      dirty++;
+    }
+  }
+  if (ok && dirty > 0) {
+    batch->traceIds = (uint16_t*)malloc(sizeof(uint16_t) * dirty);
+    batch->traces = (SignalTrace**)calloc(dirty, sizeof(SignalTrace*));
+    ok = batch->traceIds != nullptr && batch->traces != nullptr;
+    for (uint16_t i = 0; i < _count && ok; i++) {
+      SignalTrace* trace = _traces[i];
+      if (trace == nullptr || !trace->dirty) {
+        continue;
+      }
+      SignalTrace* copy = (SignalTrace*)allocTable(sizeof(SignalTrace) + trace->length);
+      if (copy == nullptr) {
+        ok = false;
+        break;
+      }
+      memcpy(copy, trace, sizeof(SignalTrace) + trace->length);
+      batch->traceIds[batch->traceCount] = _ids[i];
+      batch->traces[batch->traceCount++] = copy;
+    }
+  }
+  if (!ok) {
+    RF_LOGE("SIGNAL_MGR", "保存失败：内存不足");
+    freeFlushBatch(batch);
+    return nullptr;
+  }
+  
+  for (uint16_t i = 0; i < _count; i++) {
+    if (_traces[i] != nullptr) {
+      _traces[i]->dirty = false;
+    }
+  }
   
+  // 增量保存：取出记录内容，之后已被删除的记录跳过
+  for (uint8_t i = 0; i < _pendingCount && !batch->full; i++) {
+    uint16_t id = _pending[i] & 0xFFFF;
+    if ((_pending[i] >> 16) == JOURNAL_PUT) {
+      int32_t index = findIdLocked(id);
+      if (index < 0) {
+        continue;
+      }
+      SignalRecord& record = batch->records[batch->opCount];
+      record.code = (uint32_t)_codes[index].code;
+      record.codeHigh = (uint32_t)(_codes[index].code >> 32);
+      record.protocol = _codes[index].protocol;
+      record.bitLength = _codes[index].bitLength;
+      record.pulseLength = _codes[index].pulseLength;
+      record.timestamp = _timestamps[index];
+      memcpy(record.name, _names[index], SIGNAL_NAME_SIZE);
+    }
+    batch->ops[batch->opCount++] = _pending[i];
+  }
+  _pendingCount = 0;
+  _pendingFull = false;
+  
+  // 待删除的录制数据：同一ID又有了新波形的跳过（新波形随本批写入）
+  batch->removals = _traceRemovals;
+  for (uint16_t i = 0; i < _traceRemovalCount; i++) {
+    int32_t index = findIdLocked(_traceRemovals[i]);
+    if (index < 0 || _traces[index] == nullptr) {
+      batch->removals[batch->removalCount++] = _traceRemovals[i];
+    }
+  }
+  _traceRemovals = nullptr;
+  _traceRemovalCount = 0;
+  _traceRemovalCapacity = 0;
+  return batch;
+}
+
+// 写入取出的修改（调用者只持有闪存互斥量）：
+// 原始波形先于引用它的记录写入；整表保存后删除日志和增量记录，增量保存先写记录再写日志
+bool SignalManager::writeFlushBatch(const SignalFlushBatch* batch) {
+  char key[8];
+  _preferences->begin(_flashNamespace.c_str(), false);
+  if (batch->full && batch->table == nullptr) {
+    _preferences->clear();
+    _preferences->end();
+    _journalCount = 0;
+    return true;
+  }
+  
+  for (uint16_t i = 0; i < batch->traceCount; i++) {
+    SignalTrace* trace = batch->traces[i];
+    traceKey(batch->traceIds[i], key);
+    if (_preferences->putBytes(key, trace->data(), trace->length) != trace->length) {
+      _preferences->end();
+      RF_LOGE("SIGNAL_MGR", "保存失败：原始波形写入失败");
+      return false;
+    }
+  }
+  
+  bool ok = true;
+  if (batch->full) {
+    ok = writeTable(batch);
+  } else {
+    uint8_t logged = _journalCount;
+    for (uint8_t i = 0; i < batch->opCount; i++) {
+      uint32_t entry = batch->ops[i];
+      if ((entry >> 16) == JOURNAL_PUT) {
+        const SignalRecord& record = batch->records[i];
+        recordKey(entry & 0xFFFF, key);
+        size_t length = offsetof(SignalRecord, name) + strlen(record.name) + 1;
+        if (_preferences->putBytes(key, &record, length) == 0) {
+          ok = false;
+          continue;
+        }
+      }
+      bool found = false;
+      for (uint8_t j = 0; j < _journalCount && (entry >> 16) == JOURNAL_PUT; j++) {
+        if (_journal[j] == entry) {
+          found = true;  // 重复修改同一记录只覆盖记录本身
+          break;
+        }
+      }
+      if (!found) {
+        _journal[_journalCount++] = entry;
+      }
+    }
+    if (_journalCount != logged) {
+      size_t bytes = sizeof(uint32_t) * _journalCount;
+      ok = _preferences->putBytes("journal", _journal, bytes) == bytes && ok;
+    }
+    // 删除日志写入后才删除已删除信号的记录
+    for (uint8_t i = 0; i < batch->opCount; i++) {
+      if ((batch->ops[i] >> 16) == JOURNAL_REMOVE) {
+        recordKey(batch->ops[i] & 0xFFFF, key);
+        _preferences->remove(key);
+      }
+    }
+  }
+  
+  if (ok) {
+    for (uint16_t i = 0; i < batch->removalCount; i++) {
+      traceKey(batch->removals[i], key);
+      _preferences->remove(key);
+    }
+  }
   _preferences->end();
+  return ok;
+}
+
+// 合并为新的信号表（调用者持有闪存互斥量，命名空间已打开）：
+// 先写变化的分块，再写信号表，然后删除日志、增量记录和不再使用的分块。
+// 每次只重写一个块，所需的空闲闪存空间不超过一个块；中途掉电时已写入的块比信号表新，
+// 日志仍在，加载时在这些块上重放日志得到同样的结果
+bool SignalManager::writeTable(const SignalFlushBatch* batch) {
+  char key[8];
+  const SignalTableHeader* header = (const SignalTableHeader*)batch->table;
+  const SignalChunkEntry* directory = (const SignalChunkEntry*)(header + 1);
+  
+  // 当前的分块目录（读取失败时重写全部分块，旧分块留在闪存中）
+  size_t oldSize = _preferences->getBytesLength("table");
+  uint8_t* oldTable = oldSize >= sizeof(SignalTableHeader) ? (uint8_t*)allocTable(oldSize) : nullptr;
+  if (oldTable != nullptr && (_preferences->getBytes("table", oldTable, oldSize) != oldSize || !checkTable(oldTable, oldSize))) {
+    free(oldTable);
+    oldTable = nullptr;
+  }
+  const SignalChunkEntry* oldDirectory = oldTable != nullptr ? (const SignalChunkEntry*)(oldTable + sizeof(SignalTableHeader)) : nullptr;
+  uint16_t oldCount = oldTable != nullptr ? ((const SignalTableHeader*)oldTable)->chunkCount : 0;
+  
+  // 两个目录都按块号升序
+  const uint8_t* data = batch->chunks;
+  uint16_t previous = 0;
+  for (uint16_t c = 0; c < header->chunkCount; c++) {
+    const SignalChunkHeader* chunk = (const SignalChunkHeader*)data;
+    size_t size = chunkSize(chunk);
+    data += (size + 3) & ~(size_t)3;
+    while (previous < oldCount && oldDirectory[previous].chunk < directory[c].chunk) {
+      previous++;
+    }
+    if (previous < oldCount && oldDirectory[previous].chunk == directory[c].chunk &&
+        oldDirectory[previous].count == directory[c].count && oldDirectory[previous].crc == directory[c].crc) {
+      continue;
+    }
+    chunkKey(directory[c].chunk, key);
+    if (_preferences->putBytes(key, chunk, size) != size) {
+      free(oldTable);
+      RF_LOGE("SIGNAL_MGR", "保存失败：闪存空间不足");
+      return false;
+    }
+  }
+  
+  if (_preferences->putBytes("table", batch->table, batch->tableSize) != batch->tableSize) {
+    free(oldTable);
+    RF_LOGE("SIGNAL_MGR", "保存失败：闪存空间不足");
+    return false;
+  }
+  
+  // 信号表已包含全部变更：先删除日志（之后掉电也不会在新表上重放旧日志），再删除增量记录
+  _preferences->remove("journal");
+  for (uint8_t i = 0; i < _journalCount; i++) {
+    if ((_journal[i] >> 16) == JOURNAL_PUT) {
+      recordKey(_journal[i] & 0xFFFF, key);
+      _preferences->remove(key);
+    }
+  }
+  _journalCount = 0;
+  
+  uint16_t c = 0;
+  for (uint16_t i = 0; i < oldCount; i++) {
+    while (c < header->chunkCount && directory[c].chunk < oldDirectory[i].chunk) {
+      c++;
+    }
+    if (c >= header->chunkCount || directory[c].chunk != oldDirectory[i].chunk) {
+      chunkKey(oldDirectory[i].chunk, key);
+      _preferences->remove(key);
+    }
+  }
+  free(oldTable);
   return true;
 }
 
+// 写入失败：下次刷新整表保存，录制数据重新标记为未保存（调用者持有写锁）
+void SignalManager::restoreFlushBatchLocked(const SignalFlushBatch* batch) {
+  _pendingFull = true;
+  for (uint16_t i = 0; i < batch->traceCount; i++) {
+    int32_t index = findIdLocked(batch->traceIds[i]);
+    if (index >= 0 && _traces[index] != nullptr) {
+      _traces[index]->dirty = true;
+    }
+  }
+  for (uint16_t i = 0; i < batch->removalCount; i++) {
+    queueTraceRemoval(batch->removals[i]);
+  }
+}
+
+void SignalManager::freeFlushBatch(SignalFlushBatch* batch) {
+  for (uint16_t i = 0; i < batch->traceCount; i++) {
+    free(batch->traces[i]);
+  }
+  free(batch->traces);
+  free(batch->traceIds);
+  free(batch->removals);
+  free(batch->table);
+  free(batch->chunks);
+  free(batch);
+}
+
 void SignalManager::clearFlash() {
+  FlashGuard flash(_flashMutex);
   if (!_flashEnabled || _preferences == nullptr) {
     return;
   }
@@ -314,6 +1645,71 @@ void SignalManager::clearFlash() {
   _preferences->begin(_flashNamespace.c_str(), false);
   _preferences->clear();
   _preferences->end();
+  _journalCount = 0;
+}
+
+// ========== 原始波形持久化 ==========
+
+void SignalManager::traceKey(uint16_t id, char* key) {
+  snprintf(key, 8, "t%04x", id);
+}
+
+// 为原始波形信号读取录制数据，缺失或与信号码不符（写入中途掉电）的信号丢弃
+void SignalManager::loadTracesLocked() {
+  char key[8];
+  uint16_t i = 0;
+  _preferences->begin(_flashNamespace.c_str(), true);
+  while (i < _count) {
+    if (_codes[i].protocol != RF_PROTOCOL_RAW) {
+      i++;
+      continue;
+    }
+    
+    traceKey(_ids[i], key);
+    size_t length = _preferences->getBytesLength(key);
+    SignalTrace* trace = nullptr;
+    if (length > 0 && length <= RF_RAW_TRACE_MAX_BYTES) {
+      trace = (SignalTrace*)allocTable(sizeof(SignalTrace) + length);
+    }
+    bool ok = trace != nullptr &&
+              _preferences->getBytes(key, trace->data(), length) == length &&
+              rfRawTraceSize(trace->data(), length) == length &&
+              rfRawTraceHash(trace->data(), length) == _codes[i].code;
+    if (!ok) {
+      free(trace);
+      RF_LOGW("SIGNAL_MGR", "原始波形\"%s\"的录制数据缺失或损坏，已忽略", _names[i]);
+      eraseEntry(i);
+      continue;
+    }
+    
+    trace->length = length;
+    trace->dirty = false;
+    _traces[i] = trace;
+    i++;
+  }
+  _preferences->end();
 }
-#endif
 
+// 记录需要删除的录制数据（调用者持有写锁），在记录删除写入闪存后删除
+// 列表按需扩容（清空大量原始波形时不丢失删除）；内存不足时放弃删除，只多占用闪存空间
+void SignalManager::queueTraceRemoval(uint16_t id) {
+  if (!_flashEnabled) {
+    return;
+  }
+  for (uint16_t i = 0; i < _traceRemovalCount; i++) {
+    if (_traceRemovals[i] == id) {
+      return;
+    }
+  }
+  if (_traceRemovalCount == _traceRemovalCapacity) {
+    uint16_t capacity = _traceRemovalCapacity == 0 ? SIGNAL_JOURNAL_SIZE : _traceRemovalCapacity * 2;
+    uint16_t* removals = (uint16_t*)realloc(_traceRemovals, sizeof(uint16_t) * capacity);
+    if (removals == nullptr) {
+      return;
+    }
+    _traceRemovals = removals;
+    _traceRemovalCapacity = capacity;
+  }
+  _traceRemovals[_traceRemovalCount++] = id;
+}
+#endif
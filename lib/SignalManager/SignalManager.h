@@ -1,8 +1,19 @@
 /*
  * SignalManager - 433MHz信号管理库
- * 
+ *
  * 支持多个信号的存储、添加、删除、查询和持久化
- * 
+ * 线程安全：查询/发送持有读锁（可并发），增删改串行持有写锁；
+ *           闪存写入由独立的闪存互斥量串行化，在写锁内取出待写入内容后在锁外写入
+ * 存储：结构数组分离（SoA），可放在PSRAM中，容量最多65534个信号
+ * 持久化：CRC校验的紧凑二进制信号表（启动时一次读取）+ 增量日志，
+ *         增删改只写变化的记录，日志写满后合并为新的信号表；
+ *         信号表按记录ID分块保存，合并时只重写变化的块，不需要整表两份的闪存空间；
+ *         设置RFPersistence后由后台任务合并延迟写入，增删改不再等待闪存
+ * 发送：每个信号项在首次发送时编码脉冲波形并缓存，之后直接重放；
+ *       信号修改或协议/脉宽设置变化时缓存作废
+ * 原始波形：无法解码的信号（滚动码、未知协议）以RFRawTrace压缩编码的脉冲时序保存，
+ *           与普通信号一样增删、持久化（每个波形一个闪存键）和发送
+ *
  * Author: Zhoushoujian
  * License: MIT
  */
@@ -12,22 +23,63 @@
 
 #include <Arduino.h>
 #include "ESP433RF.h"
+#include "RWLock.h"
 
 #ifdef ESP32
 #include <Preferences.h>
 #endif
 
-// 信号项结构（包含名称和信号数据）
+// 信号名称最大字节数（含结尾'\0'，UTF-8）
+#define SIGNAL_NAME_SIZE 48
+
+// 最大容量（0xFFFF保留为哈希索引空槽标记）
+#define SIGNAL_MAX_CAPACITY 0xFFFE
+
+// 闪存存储格式版本（信号表头中的version）：4 = CRC校验的分块信号表 + 增量日志，信号码64位 + 位数
+// 格式1（旧版按位置保存的sig_N_*字符串键）在启动时迁移一次
+#define SIGNAL_FLASH_FORMAT 4
+
+// 增量日志最大条目数（写满后合并到信号表）
+#define SIGNAL_JOURNAL_SIZE 32
+
+// 信号表每块的信号数（记录ID / 块大小 = 块号，每块一个闪存键）
+// 每个信号约占30字节 + 名称长度；默认分区表的nvs分区为20KB，约可保存250个信号
+// （名称平均20字节，原始波形另计），更多信号需要在分区表中加大nvs分区
+#define SIGNAL_TABLE_CHUNK_SIZE 32
+
+// 信号项结构（包含名称和信号数据，定长无堆分配）
 struct SignalItem {
-  String name;      // 信号名称（用户自定义）
-  RFSignal signal;  // 信号数据
-  uint32_t timestamp; // 捕获时间戳
+  char name[SIGNAL_NAME_SIZE];  // 信号名称（用户自定义）
+  RFSignal signal;              // 信号数据
+  uint32_t timestamp;           // 捕获时间戳
+};
+
+// 批量发送项（场景中的一个信号）
+struct SignalBatchItem {
+  uint16_t index;   // 信号索引
+  uint8_t repeats;  // 重复发送次数（0 = 使用ESP433RF的设置）
+  uint16_t gapMs;   // 发送后到下一个信号的间隔
+};
+
+// 信号表存储位置
+enum SignalStorage : uint8_t {
+  SIGNAL_STORAGE_INTERNAL,  // 内部SRAM
+  SIGNAL_STORAGE_PSRAM      // 外部PSRAM（不可用时自动回退到内部SRAM）
 };
 
+// 原始波形信号的录制数据（堆内存，SignalManager.cpp内部结构）
+struct SignalTrace;
+
+// 一次闪存刷新的内容（SignalManager.cpp内部结构）
+struct SignalFlushBatch;
+
+// 信号遍历回调（在读锁内调用，回调中不可修改SignalManager），返回false停止遍历
+typedef bool (*SignalVisitor)(uint16_t index, const SignalItem& item, void* context);
+
 class SignalManager {
 public:
   // 构造函数
-  SignalManager(uint8_t maxSignals = 50);
+  SignalManager(uint16_t maxSignals = 50, SignalStorage storage = SIGNAL_STORAGE_INTERNAL);
   ~SignalManager();
   
   // 初始化
@@ -37,42 +89,145 @@ public:
   // 信号管理
   bool addSignal(const String& name, const RFSignal& signal);
   bool addSignal(const RFSignal& signal);  // 自动生成名称
-  bool removeSignal(uint8_t index);
+  // 添加原始波形信号（trace为rfRawTraceEncode的编码结果），信号码为波形内容哈希
+  // 同名信号被替换；普通信号不能通过addSignal/updateSignal改成原始波形
+  bool addRawSignal(const String& name, const uint8_t* trace, uint16_t length);
+  bool removeSignal(uint16_t index);
   bool removeSignal(const String& name);
-  bool updateSignal(uint8_t index, const String& name, const RFSignal& signal);
-  bool getSignal(uint8_t index, SignalItem& item);
+  bool updateSignal(uint16_t index, const String& name, const RFSignal& signal);
+  bool getSignal(uint16_t index, SignalItem& item);
   bool getSignal(const String& name, SignalItem& item);
-  uint8_t getCount();
+  uint16_t getCount();
+  uint16_t getCapacity() { return _maxSignals; }
+  bool isPSRAM() { return _inPSRAM; }
   void clear();
   
-  // 发送信号
-  bool sendSignal(uint8_t index, ESP433RF& rf);
+  // 哈希索引查找（O(1)），返回信号索引，未找到返回-1
+  int32_t findSignal(const RFSignal& signal);  // 按信号码（地址码+按键值）
+  int32_t findSignal(const String& name);      // 按名称
+  bool containsSignal(const RFSignal& signal) { return findSignal(signal) >= 0; }
+  
+  // 发送信号（ESP433RF启动发送任务时只入队，返回false表示索引无效或队列已满）
+  bool sendSignal(uint16_t index, ESP433RF& rf);
   bool sendSignal(const String& name, ESP433RF& rf);
+  // 批量发送（场景）：整批作为一个请求入队；任一索引无效时整批不发送
+  bool sendBatch(const SignalBatchItem* items, uint8_t count, ESP433RF& rf);
   
   // 持久化存储（ESP32）
   #ifdef ESP32
   bool saveToFlash();
   bool loadFromFlash();
   void clearFlash();
+  void setPersistence(RFPersistence* persistence);  // 未设置时每次修改同步写入
   #endif
   
   // 获取所有信号（用于Web界面）
-  bool getAllSignals(SignalItem* items, uint8_t maxCount);
+  bool getAllSignals(SignalItem* items, uint16_t maxCount);
   
+  // 遍历信号（不复制整个表），可只遍历从offset开始的limit个
+  void forEachSignal(SignalVisitor visitor, void* context, uint16_t offset = 0, uint16_t limit = 0xFFFF);
+
 private:
-  uint8_t _maxSignals;
-  SignalItem* _signals;
-  uint8_t _count;
+  uint16_t _maxSignals;
+  SignalStorage _storage;
+  bool _inPSRAM;
+  volatile uint16_t _count;
+  RWLock _lock;
+  
+  // 信号表（SoA：查找/去重只访问紧凑的信号码数组）
+  RFSignal* _codes;                    // 信号数据
+  char (*_names)[SIGNAL_NAME_SIZE];    // 信号名称
+  uint32_t* _timestamps;               // 捕获时间戳
+  uint32_t* _nameHashes;               // 名称哈希值
+  uint16_t* _ids;                      // 稳定记录ID（闪存键名，不随位置变化）
+  RFWaveform** _waveforms;             // 缓存的发送波形（延迟编码，引用计数，nullptr为未编码）
+  SignalTrace** _traces;               // 原始波形信号的录制数据（其他信号为nullptr）
+  uint16_t _nextId;
+  
+  // 开放寻址哈希索引（线性探测，槽位存信号索引，INDEX_EMPTY为空）
+  static const uint16_t INDEX_EMPTY = 0xFFFF;
+  uint16_t* _codeIndex;    // 按信号码
+  uint16_t* _nameIndex;    // 按名称哈希
+  uint32_t _indexMask;     // 槽位数 - 1（槽位数为2的幂）
   
   #ifdef ESP32
+  // 闪存状态（持有闪存互斥量访问；需要读写锁时先取闪存互斥量）
+  SemaphoreHandle_t _flashMutex;
   Preferences* _preferences;
   bool _flashEnabled;
   String _flashNamespace;
+  uint32_t _journal[SIGNAL_JOURNAL_SIZE];  // 自上次合并以来的变更（操作 << 16 | 记录ID）
+  uint8_t _journalCount;
+  
+  // 尚未写入闪存的修改（写锁内追加，刷新时在写锁内取出）
+  uint32_t _pending[SIGNAL_JOURNAL_SIZE];
+  uint8_t _pendingCount;
+  bool _pendingFull;  // 修改太多或已清空：刷新时整表保存
+  RFPersistence* _persistence;
+  int8_t _persistClient;
+  
+  // 待删除的原始波形闪存键（记录ID）：引用它的记录删除或改为普通信号后删除
+  uint16_t* _traceRemovals;
+  uint16_t _traceRemovalCount;
+  uint16_t _traceRemovalCapacity;
   #endif
   
-  String generateAutoName(uint8_t index);
+  String generateAutoName(uint16_t index);
   void initFlash();
+  void* allocTable(size_t bytes);
+  void freeTables();
+  
+  // 内部实现（调用者已持有写锁）
+  bool addSignalLocked(const String& name, const RFSignal& signal, SignalTrace* trace = nullptr);
+  bool removeSignalLocked(uint16_t index);
+  bool updateSignalLocked(uint16_t index, const String& name, const RFSignal& signal);
+  void setEntry(uint16_t index, const char* name, const RFSignal& signal, uint32_t timestamp);
+  void moveEntry(uint16_t to, uint16_t from);
+  void eraseEntry(uint16_t index);
+  void releaseWaveform(uint16_t index);
+  void releaseWaveforms();
+  void setTrace(uint16_t index, SignalTrace* trace);
+  void releaseTraces();
+  void copyItem(uint16_t index, SignalItem& item);
+  uint16_t allocateId();
+  #ifdef ESP32
+  bool saveToFlashLocked();
+  bool loadFromFlashLocked();
+  bool loadTableLocked();
+  void replayJournalLocked();
+  bool applyRecordLocked(uint16_t id);
+  int32_t findIdLocked(uint16_t id);
+  bool loadLegacyLocked();
+  void queuePersist(uint8_t op, uint16_t id);
+  bool flushPending();
+  static bool persistFlush(void* context);
+  bool buildTableLocked(SignalFlushBatch* batch);
+  bool writeTable(const SignalFlushBatch* batch);
+  SignalFlushBatch* takeFlushBatchLocked();
+  bool writeFlushBatch(const SignalFlushBatch* batch);
+  void restoreFlushBatchLocked(const SignalFlushBatch* batch);
+  static void freeFlushBatch(SignalFlushBatch* batch);
+  static void recordKey(uint16_t id, char* key);
+  static void traceKey(uint16_t id, char* key);
+  static void chunkKey(uint16_t chunk, char* key);
+  void loadTracesLocked();
+  void queueTraceRemoval(uint16_t id);
+  #endif
+  void persistChanges();
+  int32_t resolveEntryLocked(uint16_t index, const char* name);
+  bool sendEntry(uint16_t index, const char* name, ESP433RF& rf);
+  RFWaveform* acquireWaveformLocked(uint16_t index, ESP433RF& rf, bool build);
+  int16_t fillBatchLocked(const SignalBatchItem* items, uint8_t count, RFTxItem* batch, ESP433RF& rf, bool build);
+  static void releaseBatch(RFTxItem* batch, uint8_t count);
+  bool sendCopy(const RFSignal& signal, RFWaveform* waveform, ESP433RF& rf);
+  
+  // 哈希索引维护（调用者持有锁）
+  static uint32_t hashName(const char* name);
+  static uint32_t hashCode(const RFSignal& signal);
+  void indexInsert(uint16_t index);
+  void rebuildIndex();
+  int32_t findCodeLocked(const RFSignal& signal);
+  int32_t findNameLocked(const char* name);
 };
 
 #endif // SIGNAL_MANAGER_H
-
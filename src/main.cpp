@@ -13,18 +13,19 @@
 #define LED_PIN 21     // LED指示灯引脚
 
 // 当前发送的信号（用于验证，通过串口命令发送时记录）
-RFSignal currentSent = {"", ""};
+RFSignal currentSent = {};
+bool hasCurrentSent = false;
 
 // 复刻功能：保存接收到的信号
 #define REPLAY_BUFFER_SIZE 10
 RFSignal replayBuffer[REPLAY_BUFFER_SIZE];
 int replayBufferIndex = 0;
 int replayBufferCount = 0;
-RFSignal lastReceived = {"", ""};  // 最后接收到的信号
+RFSignal lastReceived = {};  // 最后接收到的信号
 
 // 复刻模式状态
 bool replayMode = false;           // 是否处于复刻模式（等待接收信号）
-RFSignal capturedSignal = {"", ""}; // 捕获的信号（用于GPIO触发发送）
+RFSignal capturedSignal = {}; // 捕获的信号（用于GPIO触发发送）
 bool signalCaptured = false;       // 是否已捕获信号
 
 // LED状态管理
@@ -43,35 +44,53 @@ static bool testPassed = false;
 // 创建ESP433RF实例
 ESP433RF rf(TX_PIN, RX_PIN, 9600);
 
-// 创建信号管理器实例（最多50个信号）
-SignalManager signalManager(50);
+// 创建信号管理器实例（最多50个信号，信号表放在PSRAM，内部SRAM留给WiFi）
+SignalManager signalManager(50, SIGNAL_STORAGE_PSRAM);
 
 // 创建Web管理界面实例
 ESP433RFWeb webManager(rf, signalManager);
 
+// 闪存延迟写入（Web请求和接收回调只标记修改，由后台任务合并写入）
+RFPersistence persistence;
+int8_t replayPersistClient = -1;
+
 // 闪存存储实例（保留用于向后兼容）
 Preferences preferences;
 const char* PREF_NAMESPACE = "rf_replay";  // 命名空间
-const char* PREF_KEY_ADDRESS = "address";  // 地址码键
-const char* PREF_KEY_KEY = "key";          // 按键值键
+const char* PREF_KEY_CODE = "code";        // 完整信号码键（十六进制）
+const char* PREF_KEY_BITS = "bits";        // 信号码位数键
+const char* PREF_KEY_ADDRESS = "address";  // 地址码键（旧版，只能保存32位信号码）
+const char* PREF_KEY_KEY = "key";          // 按键值键（旧版）
 const char* PREF_KEY_CAPTURED = "captured"; // 是否已捕获标志
 
-// 保存信号到闪存
-void saveSignalToFlash() {
+// 写入复刻信号到闪存（在持久化任务中执行）
+bool flushReplayState(void*) {
   preferences.begin(PREF_NAMESPACE, false);  // false表示读写模式
-  if (signalCaptured && capturedSignal.address.length() > 0) {
-    preferences.putString(PREF_KEY_ADDRESS, capturedSignal.address);
-    preferences.putString(PREF_KEY_KEY, capturedSignal.key);
+  if (signalCaptured) {
+    char code[RF_SIGNAL_HEX_LEN + 1];
+    capturedSignal.toHex(code);
+    preferences.putString(PREF_KEY_CODE, code);
+    preferences.putUChar(PREF_KEY_BITS, capturedSignal.bits());
+    preferences.remove(PREF_KEY_ADDRESS);
+    preferences.remove(PREF_KEY_KEY);
     preferences.putBool(PREF_KEY_CAPTURED, true);
-    Serial.println("[FLASH] 信号已保存到闪存");
+    RF_LOGI("FLASH", "信号已保存到闪存");
   } else {
     // 清空闪存
+    preferences.remove(PREF_KEY_CODE);
+    preferences.remove(PREF_KEY_BITS);
     preferences.remove(PREF_KEY_ADDRESS);
     preferences.remove(PREF_KEY_KEY);
     preferences.putBool(PREF_KEY_CAPTURED, false);
-    Serial.println("[FLASH] 闪存已清空");
+    RF_LOGI("FLASH", "闪存已清空");
   }
   preferences.end();
+  return true;
+}
+
+// 保存信号到闪存（只标记修改，不阻塞接收回调和按钮任务）
+void saveSignalToFlash() {
+  persistence.markDirty(replayPersistClient);
 }
 
 // 从闪存加载信号
@@ -79,28 +98,41 @@ void loadSignalFromFlash() {
   preferences.begin(PREF_NAMESPACE, true);  // true表示只读模式
   bool saved = preferences.getBool(PREF_KEY_CAPTURED, false);
   if (saved) {
-    capturedSignal.address = preferences.getString(PREF_KEY_ADDRESS, "");
-    capturedSignal.key = preferences.getString(PREF_KEY_KEY, "");
-    if (capturedSignal.address.length() > 0 && capturedSignal.key.length() > 0) {
+    char code[RF_SIGNAL_HEX_LEN + 1] = "";
+    char address[8] = "";
+    char key[4] = "";
+    bool valid;
+    if (preferences.isKey(PREF_KEY_CODE)) {
+      preferences.getString(PREF_KEY_CODE, code, sizeof(code));
+      valid = RFSignal::fromHex(code, capturedSignal) &&
+              capturedSignal.setBitLength(preferences.getUChar(PREF_KEY_BITS, capturedSignal.bitLength));
+    } else {
+      preferences.getString(PREF_KEY_ADDRESS, address, sizeof(address));
+      preferences.getString(PREF_KEY_KEY, key, sizeof(key));
+      valid = RFSignal::fromHex(address, key, capturedSignal);
+    }
+    if (valid) {
       signalCaptured = true;
       currentLEDState = LED_ON;  // 已加载信号，LED常亮
-      Serial.printf("[FLASH] 从闪存加载信号: %s%s\n", 
-                   capturedSignal.address.c_str(), capturedSignal.key.c_str());
+      capturedSignal.toHex(code);
+      RF_LOGI("FLASH", "从闪存加载信号: %s (%u位)", code, capturedSignal.bits());
     } else {
       signalCaptured = false;
-      Serial.println("[FLASH] 闪存中的信号数据无效");
+      RF_LOGW("FLASH", "闪存中的信号数据无效");
     }
   } else {
     signalCaptured = false;
-    Serial.println("[FLASH] 闪存中没有保存的信号");
+    RF_LOGI("FLASH", "闪存中没有保存的信号");
   }
   preferences.end();
 }
 
 // 接收回调函数
-void onReceive(RFSignal signal) {
+void onReceive(const RFSignal& signal) {
   receiveCount++;
-  Serial.printf("[RECV] 第%lu次接收: %s%s\n", receiveCount, signal.address.c_str(), signal.key.c_str());
+  char hex[RF_SIGNAL_HEX_LEN + 1];
+  signal.toHex(hex);
+  RF_LOGI("RECV", "第%lu次接收: %s (%u位)", (unsigned long)receiveCount, hex, signal.bits());
   
   // 保存接收到的信号到复刻缓冲区（向后兼容）
   lastReceived = signal;
@@ -112,19 +144,10 @@ void onReceive(RFSignal signal) {
   
   // 只在捕获模式下添加到信号管理器
   if (replayMode || rf.isCaptureMode()) {
-    // 去重：检查是否已存在相同的信号
-    bool isDuplicate = false;
-    uint8_t count = signalManager.getCount();
-    SignalItem item;
-    for (uint8_t i = 0; i < count; i++) {
-      if (signalManager.getSignal(i, item)) {
-        if (item.signal.address == signal.address && item.signal.key == signal.key) {
-          isDuplicate = true;
-          Serial.printf("[SIGNAL_MGR] 信号已存在，跳过: %s%s\n", 
-                       signal.address.c_str(), signal.key.c_str());
-          break;
-        }
-      }
+    // 去重：哈希索引查找是否已存在相同的信号
+    bool isDuplicate = signalManager.containsSignal(signal);
+    if (isDuplicate) {
+      RF_LOGI("SIGNAL_MGR", "信号已存在，跳过: %s", hex);
     }
     
     // 只有不重复的信号才添加
@@ -132,8 +155,7 @@ void onReceive(RFSignal signal) {
       // 生成自动名称
       String autoName = "Signal_" + String(signalManager.getCount() + 1);
       signalManager.addSignal(autoName, signal);
-      Serial.printf("[SIGNAL_MGR] 信号已添加到管理器: %s (%s%s)\n", 
-                   autoName.c_str(), signal.address.c_str(), signal.key.c_str());
+      RF_LOGI("SIGNAL_MGR", "信号已添加到管理器: %s (%s)", autoName.c_str(), hex);
     }
     
     // 捕获一个信号后自动退出捕获模式
@@ -142,105 +164,54 @@ void onReceive(RFSignal signal) {
     replayMode = false;  // 捕获完成后退出复刻模式
     currentLEDState = LED_ON;  // 完成复刻，LED常亮
     rf.disableCaptureMode();  // 禁用库的捕获模式
-    Serial.println("[CAPTURE] 已退出捕获模式");
+    RF_LOGI("CAPTURE", "已退出捕获模式");
     
     // 保存到闪存（向后兼容）
     saveSignalToFlash();
     
-    // 计算实际发送的24位数据（前24位，去掉最后8位）
-    String fullHex = capturedSignal.address + capturedSignal.key;
-    uint32_t fullData = 0;
-    for (int i = 0; i < 8 && i < fullHex.length(); i++) {
-      char c = fullHex.charAt(i);
-      uint8_t val = 0;
-      if (c >= '0' && c <= '9') val = c - '0';
-      else if (c >= 'A' && c <= 'F') val = c - 'A' + 10;
-      else if (c >= 'a' && c <= 'f') val = c - 'a' + 10;
-      fullData = (fullData << 4) | val;
-    }
-    uint32_t code24bit = (fullData >> 8) & 0xFFFFFF;  // 前24位（去掉最后8位）
-    
-    Serial.printf("[REPLAY] ✓ 信号已捕获: %s%s (地址码:%s, 按键值:%s)\n", 
-                 capturedSignal.address.c_str(), capturedSignal.key.c_str(),
-                 capturedSignal.address.c_str(), capturedSignal.key.c_str());
-    Serial.printf("[REPLAY] 实际将发送: 32位=0x%08lX, 24位=0x%06lX\n", fullData, code24bit);
-    Serial.printf("[REPLAY] 现在可以按下GPIO%d按钮发送复刻信号\n", REPLAY_BUTTON_PIN);
-    Serial.printf("[REPLAY] 提示：复刻时将发送完整的8位数据 %s%s（24位编码）\n",
-                 capturedSignal.address.c_str(), capturedSignal.key.c_str());
+    // 复刻时原样发送接收到的全部位（接收模块的信号为32位：地址码 + 按键值）
+    RF_LOGI("REPLAY", "✓ 信号已捕获: %s (%u位)", hex, capturedSignal.bits());
+    RF_LOGI("REPLAY", "现在可以按下GPIO%d按钮发送复刻信号", REPLAY_BUTTON_PIN);
   }
   
   // 如果有发送记录，进行验证
-  if (currentSent.address.length() > 0) {
-    // 计算发送的实际24位数据（RCSwitch发送的是前24位，去掉最后8位）
-    String fullHex = currentSent.address + currentSent.key;
-    uint32_t sentFullData = 0;
-    for (int i = 0; i < 8 && i < fullHex.length(); i++) {
-      char c = fullHex.charAt(i);
-      uint8_t val = 0;
-      if (c >= '0' && c <= '9') val = c - '0';
-      else if (c >= 'A' && c <= 'F') val = c - 'A' + 10;
-      else if (c >= 'a' && c <= 'f') val = c - 'a' + 10;
-      sentFullData = (sentFullData << 4) | val;
-    }
-    uint32_t sent24bit = (sentFullData >> 8) & 0xFFFFFF;  // 前24位（去掉最后8位）
-    
-    // 将接收到的地址码转换为数值
-    uint32_t recvAddress = 0;
-    for (int i = 0; i < signal.address.length() && i < 6; i++) {
-      char c = signal.address.charAt(i);
-      uint8_t val = 0;
-      if (c >= '0' && c <= '9') val = c - '0';
-      else if (c >= 'A' && c <= 'F') val = c - 'A' + 10;
-      else if (c >= 'a' && c <= 'f') val = c - 'a' + 10;
-      recvAddress = (recvAddress << 4) | val;
-    }
-    
-    // 验证：只比较地址码（前6位），忽略按键值
-    char sentHex[7];
-    sprintf(sentHex, "%06lX", sent24bit);
-    bool matchAddress = (signal.address == String(sentHex));
-    
-    if (matchAddress) {
+  if (hasCurrentSent) {
+    // 发送的是信号的全部位，验证时比较完整信号码和位数
+    char sentHex[RF_SIGNAL_HEX_LEN + 1];
+    currentSent.toHex(sentHex);
+    if (signal.sameCode(currentSent)) {
       testPassed = true;
-      Serial.printf("[TEST] ✓ 验证通过！地址码匹配\n");
-      Serial.printf("[TEST]   期望地址码:%s (24位:0x%06lX), 接收地址码:%s (按键:%s)\n", 
-                  sentHex, sent24bit, signal.address.c_str(), signal.key.c_str());
+      RF_LOGI("TEST", "✓ 验证通过！信号码匹配: %s (%u位)", hex, signal.bits());
     } else {
-      Serial.printf("[TEST] ✗ 验证失败！\n");
-      Serial.printf("[TEST]   期望地址码:%s (24位:0x%06lX)\n", 
-                  sentHex, sent24bit);
-      Serial.printf("[TEST]   接收地址码:%s (按键:%s, 地址码:0x%06lX)\n", 
-                  signal.address.c_str(), signal.key.c_str(), recvAddress);
+      RF_LOGW("TEST", "✗ 验证失败！");
+      RF_LOGW("TEST", "  期望: %s (%u位)", sentHex, currentSent.bits());
+      RF_LOGW("TEST", "  接收: %s (%u位)", hex, signal.bits());
     }
   }
 }
 
-// 接收任务
-void receiveTask(void *parameter) {
-  while (true) {
-    // 检查接收（回调函数会自动处理）
-    if (rf.receiveAvailable()) {
-      RFSignal signal;
-      if (rf.receive(signal)) {
-        // 回调函数已经处理了验证逻辑
-      }
-    }
-    
-    vTaskDelay(pdMS_TO_TICKS(10));
-  }
+// 按键结束回调（帧数和按住时长）
+void onPress(const RFSignal& signal, uint16_t frames, uint32_t holdMs) {
+  char hex[RF_SIGNAL_HEX_LEN + 1];
+  signal.toHex(hex);
+  RF_LOGI("PRESS", "%s: %u帧, 按住%lums", hex, frames, (unsigned long)holdMs);
 }
 
 // 状态监控任务
-void statusTask(void *parameter) {
+void statusTask(void *) {
   while (true) {
-    Serial.printf("[STATUS] 发送:%lu次, 接收:%lu次, 测试:%s\n", 
-                  sendCount, receiveCount, testPassed ? "通过" : "进行中");
+    RF_LOGI("STATUS", "发送:%lu次, 接收:%lu次 (%lu帧), 测试:%s, 队列丢帧:%lu (峰值%lu), 发送队列:%lu (峰值%lu, 丢弃%lu), 回声过滤:%lu, 闪存写入:%lu/%lu次标记", 
+                  (unsigned long)sendCount, (unsigned long)receiveCount, (unsigned long)rf.getFrameCount(), testPassed ? "通过" : "进行中",
+                  (unsigned long)rf.getQueueDropped(), (unsigned long)rf.getQueueHighWater(),
+                  (unsigned long)rf.getTxQueueDepth(), (unsigned long)rf.getTxQueueHighWater(), (unsigned long)rf.getTxQueueDropped(),
+                  (unsigned long)rf.getEchoSuppressed(),
+                  (unsigned long)persistence.getFlushCount(), (unsigned long)persistence.getMarkCount());
     vTaskDelay(pdMS_TO_TICKS(5000));
   }
 }
 
 // LED控制任务 - 根据复刻状态控制LED（反向逻辑）
-void ledTask(void *parameter) {
+void ledTask(void *) {
   unsigned long lastBlinkTime = 0;
   bool ledBlinkState = false;
   const unsigned long blinkInterval = 200;  // 快闪间隔200ms
@@ -270,7 +241,7 @@ void ledTask(void *parameter) {
 }
 
 // GPIO按钮检测任务 - 检测复刻按钮按下（支持短按和长按）
-void buttonTask(void *parameter) {
+void buttonTask(void *) {
   bool lastStableState = HIGH;
   bool currentReading = HIGH;
   bool lastReading = HIGH;
@@ -301,7 +272,7 @@ void buttonTask(void *parameter) {
             buttonPressed = true;
             buttonPressStartTime = millis();
             longPressTriggered = false;
-            Serial.printf("\n[BUTTON] ✓ 检测到按钮按下（GPIO%d）\n", REPLAY_BUTTON_PIN);
+            RF_LOGI("BUTTON", "✓ 检测到按钮按下（GPIO%d）", REPLAY_BUTTON_PIN);
           }
         } else if (currentReading == HIGH && lastStableState == LOW) {
           // 从LOW稳定变为HIGH（释放）
@@ -310,53 +281,43 @@ void buttonTask(void *parameter) {
             
             if (!longPressTriggered && pressDuration < longPressDuration) {
               // 短按：优先发送Web绑定的信号，否则发送复刻信号
-              Serial.printf("[BUTTON] 短按检测（%lums）\n", pressDuration);
+              RF_LOGI("BUTTON", "短按检测（%lums）", pressDuration);
               
               // 检查是否有Web绑定的信号
-              int8_t boundIndex = webManager.getBootBoundIndex();
+              int32_t boundIndex = webManager.getBootBoundIndex();
               if (boundIndex >= 0) {
                 // 发送Web绑定的信号
-                Serial.printf("[BUTTON] 发送Web绑定信号 #%d\n", boundIndex);
+                RF_LOGI("BUTTON", "发送Web绑定信号 #%ld", (long)boundIndex);
                 if (signalManager.sendSignal(boundIndex, rf)) {
-                  Serial.println("[BUTTON] Web绑定信号已发送");
+                  RF_LOGI("BUTTON", "Web绑定信号已加入发送队列");
                   sendCount++;
                 } else {
-                  Serial.println("[BUTTON] 警告：Web绑定信号发送失败");
+                  RF_LOGW("BUTTON", "警告：Web绑定信号发送失败（索引无效或发送队列已满）");
                 }
               } else if (signalCaptured) {
                 // 发送复刻信号
                 currentSent = capturedSignal;  // 记录发送的信号用于验证
-                Serial.printf("[REPLAY] 发送复刻信号: %s%s\n", 
-                             capturedSignal.address.c_str(), capturedSignal.key.c_str());
-                Serial.printf("[REPLAY] 地址码: %s, 按键值: %s\n",
-                             capturedSignal.address.c_str(), capturedSignal.key.c_str());
+                hasCurrentSent = true;
+                char hex[RF_SIGNAL_HEX_LEN + 1];
+                capturedSignal.toHex(hex);
+                RF_LOGI("REPLAY", "发送复刻信号: %s (%u位)", hex, capturedSignal.bits());
                 
-                // 计算实际发送的24位数据（前24位，去掉最后8位）
-                String fullHex = capturedSignal.address + capturedSignal.key;
-                uint32_t fullData = 0;
-                for (int i = 0; i < 8 && i < fullHex.length(); i++) {
-                  char c = fullHex.charAt(i);
-                  uint8_t val = 0;
-                  if (c >= '0' && c <= '9') val = c - '0';
-                  else if (c >= 'A' && c <= 'F') val = c - 'A' + 10;
-                  else if (c >= 'a' && c <= 'f') val = c - 'a' + 10;
-                  fullData = (fullData << 4) | val;
+                // 发送完整信号（全部位），只入队，不阻塞按钮任务
+                if (rf.send(capturedSignal) != 0) {
+                  sendCount++;
+                } else {
+                  RF_LOGW("BUTTON", "警告：发送队列已满");
                 }
-                uint32_t code24bit = (fullData >> 8) & 0xFFFFFF;  // 前24位（去掉最后8位）
-                Serial.printf("[REPLAY] 实际发送: 32位=0x%08lX, 24位=0x%06lX\n", fullData, code24bit);
-                
-                rf.send(capturedSignal);  // 发送完整信号（地址码+按键值）
-                sendCount++;
               } else {
-                Serial.println("[BUTTON] 警告：没有绑定或捕获的信号");
-                Serial.println("[BUTTON] 提示：在Web界面绑定信号或使用 'capture' 命令捕获信号");
+                RF_LOGW("BUTTON", "警告：没有绑定或捕获的信号");
+                RF_LOGI("BUTTON", "提示：在Web界面绑定信号或使用 'capture' 命令捕获信号");
               }
             } else if (longPressTriggered) {
-              Serial.println("[BUTTON] 长按释放：复刻信号已清空");
+              RF_LOGI("BUTTON", "长按释放：复刻信号已清空");
             }
             
             buttonPressed = false;
-            Serial.printf("[BUTTON] 按钮释放（GPIO%d断开）\n", REPLAY_BUTTON_PIN);
+            RF_LOGI("BUTTON", "按钮释放（GPIO%d断开）", REPLAY_BUTTON_PIN);
           }
         }
         lastStableState = currentReading;
@@ -369,24 +330,24 @@ void buttonTask(void *parameter) {
         // 检测长按（按下超过2秒）- 立即清空，不等待释放
         if (pressDuration >= longPressDuration) {
           longPressTriggered = true;
-          Serial.println("[BUTTON] 长按检测（2秒）：立即清空复刻信号");
+          RF_LOGI("BUTTON", "长按检测（2秒）：立即清空复刻信号");
           
           // 立即清空复刻信号
           signalCaptured = false;
-          capturedSignal = {"", ""};
+          capturedSignal = RFSignal();
           replayMode = true;  // 清空后自动进入复刻模式
           currentLEDState = LED_BLINK;  // LED快闪，等待接收信号
           
           // 清空闪存
           saveSignalToFlash();
           
-          Serial.println("[REPLAY] 复刻信号已清空（内存+闪存），自动进入复刻模式");
+          RF_LOGI("REPLAY", "复刻信号已清空（内存+闪存），自动进入复刻模式");
         } else {
           // 显示长按倒计时（可选，每500ms显示一次）
           static unsigned long lastProgressTime = 0;
           if (millis() - lastProgressTime >= 500) {
             unsigned long remaining = longPressDuration - pressDuration;
-            Serial.printf("[BUTTON] 长按中... 还需按住 %lums 才能清空\n", remaining);
+            RF_LOGI("BUTTON", "长按中... 还需按住 %lums 才能清空", remaining);
             lastProgressTime = millis();
           }
         }
@@ -414,8 +375,15 @@ void setup() {
   rf.setProtocol(1);        // Protocol 1 (EV1527/PT2262)
   rf.setPulseLength(320);  // 320μs脉冲长度
   
-  // 设置接收回调
+  // 设置接收回调（重复帧已合并，每次按键只回调一次）
   rf.setReceiveCallback(onReceive);
+  rf.setPressCallback(onPress);
+  
+  // 启动闪存延迟写入任务（修改静默500ms后写入，最长延迟5秒）
+  persistence.setMode(PERSIST_DELAYED, 500, 5000);
+  persistence.start(1, 4096);
+  replayPersistClient = persistence.registerClient("rf_replay", flushReplayState, nullptr);
+  signalManager.setPersistence(&persistence);
   
   // 初始化信号管理器
   signalManager.begin();
@@ -427,7 +395,7 @@ void setup() {
     if (enabled) {
       replayMode = true;
       currentLEDState = LED_BLINK;
-      Serial.println("[WEB] 通过Web界面进入捕获模式");
+      RF_LOGI("WEB", "通过Web界面进入捕获模式");
     }
   });
   Serial.println("[WEB] Web管理界面已启动");
@@ -460,7 +428,7 @@ void setup() {
   if (!signalCaptured) {
     replayMode = true;
     signalCaptured = false;
-    capturedSignal = {"", ""};
+    capturedSignal = RFSignal();
     currentLEDState = LED_BLINK;  // 进入复刻模式，LED快闪
     Serial.println("\n[自动] 检测到没有复刻信号，自动进入复刻模式");
     Serial.println("[自动] LED指示灯快闪中，等待接收信号...");
@@ -477,6 +445,13 @@ void setup() {
   digitalWrite(TX_PIN, LOW);
   Serial.println("GPIO14输出测试: 完成");
   
+  // GPIO测试之后再交给RMT（pinMode会把引脚切回普通GPIO）
+  if (rf.setTxBackend(RF_TX_RMT, 0)) {
+    Serial.println("发送后端: RMT硬件时序");
+  } else {
+    Serial.println("发送后端: RCSwitch（RMT初始化失败）");
+  }
+  
   // 测试复刻按钮
   bool buttonState = digitalRead(REPLAY_BUTTON_PIN);
   Serial.printf("GPIO%d按钮状态: %s (当前: %s)\n", 
@@ -494,8 +469,15 @@ void setup() {
   }
   Serial.println("========================================");
   
+  // 日志任务：之后的运行日志先放入缓冲区，由低优先级任务按串口速率输出，不阻塞接收和发送
+  // 默认只输出INFO及以上；接收的原始数据和解析结果（ESP433RF的调试日志）仍然输出
+  rfLog.setLevel("ESP433RF", RF_LOG_DEBUG);
+  rfLog.start(1, 3072);
+  
   // 创建RTOS任务
-  xTaskCreate(receiveTask, "ReceiveTask", 4096, NULL, 2, NULL);
+  rf.startDispatcher(1, 4096);     // 回调分发任务（去重、闪存写入等在此执行）
+  rf.enableEventReceive(2, 4096);  // 事件驱动接收任务（收到完整一行才唤醒）
+  rf.startTransmitter(3, 4096);    // 发送任务（Web请求和按钮只把信号放入发送队列）
   xTaskCreate(statusTask, "StatusTask", 2048, NULL, 1, NULL);
   xTaskCreate(buttonTask, "ButtonTask", 2048, NULL, 2, NULL);  // GPIO按钮检测任务
   xTaskCreate(ledTask, "LEDTask", 2048, NULL, 1, NULL);  // LED控制任务
@@ -0,0 +1,358 @@
+/*
+ * Pulse captures for the RFDecoder test
+ *
+ * One capture per protocol in the RFProtocol table, plus captures that must
+ * not decode. Each is a sequence of pulse durations in us as the raw GPIO
+ * receive path records them: positive = high, negative = low.
+ *
+ * The protocol captures hold four repeats as a typical OOK receiver outputs
+ * them: high phases stretched by 1/8 of the pulse length (lows shortened by
+ * the same), up to +-40us of jitter per edge, and a few noise pulses and an
+ * idle gap before the first repeat. They were generated once from the
+ * encoder and are kept fixed here, so decoder changes are checked against
+ * the same input.
+ *
+ * Author: Zhoushoujian
+ * License: MIT
+ */
+
+#ifndef RF_PULSE_FIXTURES_H
+#define RF_PULSE_FIXTURES_H
+
+#include <stdint.h>
+
+static const int16_t PULSES_PROTOCOL_1[] = {
+  77, -766, 385, -194, 310, -126, 396, -377, 286, -516, 173, -642,
+  -9755, 380, -1003, 402, -1000, 1081, -270, 400, -1021, 1114, -329, 1073,
+  -319, 413, -976, 1078, -302, 1081, -314, 1107, -285, 385, -976, 1131,
+  -293, 1086, -292, 423, -996, 397, -978, 1081, -323, 1078, -300, 363,
+  -1021, 1109, -274, 410, -982, 359, -986, 1123, -319, 377, -1017, 407,
+  -982, 371, -10821, 387, -980, 416, -1027, 1087, -301, 417, -1011, 1103,
+  -303, 1127, -285, 375, -1010, 1091, -275, 1112, -300, 1123, -279, 357,
+  -1014, 1063, -347, 1079, -301, 379, -1026, 422, -1021, 1064, -301, 1115,
+  -273, 421, -978, 1105, -340, 393, -987, 401, -974, 1072, -308, 433,
+  -1003, 382, -1011, 418, -10808, 373, -982, 381, -1010, 1110, -273, 397,
+  -1047, 1087, -310, 1091, -305, 423, -973, 1106, -315, 1066, -271, 1090,
+  -317, 373, -1009, 1113, -270, 1063, -322, 427, -1028, 382, -1041, 1088,
+  -271, 1060, -301, 372, -1023, 1130, -272, 364, -990, 395, -1038, 1085,
+  -317, 365, -989, 391, -1018, 361, -10801, 430, -1002, 365, -979, 1120,
+  -321, 374, -972, 1071, -322, 1063, -332, 401, -987, 1086, -330, 1109,
+  -309, 1087, -322, 391, -1024, 1106, -346, 1067, -313, 414, -1042, 412,
+  -992, 1117, -271, 1077, -286, 426, -1045, 1101, -345, 396, -1006, 386,
+  -1014, 1058, -344, 353, -1012, 425, -1014, 405, -10821
+};
+
+static const int16_t PULSES_PROTOCOL_2[] = {
+  364, -411, 143, -173, 217, -393, 373, -435, 114, -469, 108, -319,
+  -11937, 765, -1254, 1378, -577, 719, -1223, 1405, -545, 1370, -588, 718,
+  -1227, 1392, -580, 739, -1253, 770, -1191, 1378, -578, 744, -1179, 1347,
+  -579, 1383, -608, 692, -1234, 1411, -556, 743, -1197, 694, -1179, 693,
+  -1253, 1385, -540, 1382, -573, 737, -1195, 711, -1188, 1348, -582, 1345,
+  -585, 704, -6423, 710, -1249, 1352, -569, 728, -1233, 1373, -537, 1392,
+  -555, 734, -1231, 1368, -591, 718, -1205, 710, -1255, 1402, -574, 709,
+  -1214, 1388, -542, 1420, -535, 696, -1253, 1408, -540, 729, -1191, 710,
+  -1184, 710, -1214, 1387, -571, 1401, -585, 706, -1181, 717, -1243, 1400,
+  -592, 1417, -553, 745, -6400, 757, -1180, 1388, -576, 721, -1244, 1395,
+  -601, 1394, -553, 708, -1252, 1360, -548, 745, -1188, 733, -1227, 1363,
+  -556, 743, -1200, 1366, -558, 1394, -536, 752, -1248, 1414, -588, 752,
+  -1254, 726, -1211, 699, -1192, 1392, -587, 1414, -531, 700, -1202, 715,
+  -1199, 1416, -566, 1385, -579, 721, -6439, 770, -1227, 1394, -542, 695,
+  -1181, 1360, -562, 1378, -573, 730, -1209, 1394, -580, 766, -1223, 758,
+  -1224, 1372, -552, 747, -1240, 1341, -569, 1390, -560, 763, -1214, 1414,
+  -582, 761, -1201, 692, -1184, 769, -1192, 1407, -582, 1352, -599, 703,
+  -1191, 760, -1209, 1392, -548, 1401, -555, 737, -6411
+};
+
+static const int16_t PULSES_PROTOCOL_3[] = {
+  176, -379, 295, -337, 285, -510, 232, -148, 329, -340, 86, -549,
+  -9508, 424, -1092, 432, -1071, 412, -1075, 895, -603, 419, -1089, 398,
+  -1102, 915, -606, 912, -576, 403, -1105, 902, -584, 425, -1089, 908,
+  -603, 413, -1076, 894, -578, 902, -581, 906, -580, 911, -601, 421,
+  -1101, 429, -1071, 924, -572, 902, -576, 411, -1092, 915, -596, 897,
+  -568, 2996, -7093, 414, -1097, 398, -1068, 429, -1092, 916, -602, 393,
+  -1068, 417, -1094, 916, -601, 897, -588, 416, -1105, 914, -573, 399,
+  -1081, 902, -601, 402, -1072, 918, -600, 931, -599, 895, -576, 911,
+  -601, 412, -1081, 430, -1074, 929, -576, 896, -570, 432, -1090, 897,
+  -569, 922, -598, 3013, -7086, 397, -1100, 413, -1099, 404, -1093, 931,
+  -592, 429, -1082, 419, -1076, 932, -598, 926, -596, 417, -1072, 917,
+  -588, 418, -1107, 902, -578, 429, -1070, 900, -605, 928, -604, 923,
+  -570, 893, -587, 419, -1076, 417, -1088, 928, -603, 908, -602, 430,
+  -1098, 921, -569, 929, -582, 3002, -7089, 404, -1077, 419, -1103, 411,
+  -1091, 912, -591, 412, -1108, 413, -1070, 898, -580, 901, -588, 417,
+  -1089, 892, -568, 409, -1103, 930, -578, 421, -1076, 909, -603, 896,
+  -573, 928, -586, 924, -590, 430, -1085, 396, -1104, 897, -580, 893,
+  -584, 428, -1078, 907, -583, 908, -569, 3005, -7099
+};
+
+static const int16_t PULSES_PROTOCOL_4[] = {
+  104, -298, 238, -822, 125, -602, 212, -194, 72, -319, 238, -639,
+  -11972, 1188, -301, 1171, -345, 451, -1106, 455, -1070, 444, -1130, 405,
+  -1103, 396, -1072, 447, -1118, 1213, -309, 1172, -307, 1164, -334, 1181,
+  -309, 1187, -355, 1173, -352, 1154, -335, 1175, -297, 1159, -329, 1210,
+  -306, 1181, -328, 388, -1066, 1186, -313, 1156, -301, 1178, -357, 388,
+  -1082, 458, -2207, 1209, -315, 1226, -351, 410, -1068, 457, -1086, 439,
+  -1071, 460, -1073, 461, -1126, 401, -1083, 1155, -312, 1161, -331, 1189,
+  -314, 1203, -319, 1195, -333, 1204, -353, 1155, -308, 1187, -323, 1213,
+  -373, 1152, -322, 1194, -373, 416, -1070, 1202, -339, 1175, -306, 1174,
+  -369, 409, -1133, 401, -2232, 1183, -364, 1166, -339, 425, -1089, 439,
+  -1116, 436, -1070, 390, -1122, 446, -1067, 447, -1097, 1192, -351, 1153,
+  -355, 1167, -334, 1187, -352, 1181, -333, 1175, -352, 1186, -327, 1152,
+  -364, 1208, -334, 1161, -364, 1211, -337, 458, -1113, 1176, -373, 1188,
+  -335, 1160, -295, 402, -1077, 458, -2269, 1193, -347, 1223, -301, 455,
+  -1123, 397, -1101, 399, -1109, 402, -1125, 420, -1055, 439, -1066, 1172,
+  -315, 1207, -295, 1206, -299, 1212, -340, 1223, -368, 1191, -324, 1223,
+  -308, 1187, -342, 1217, -304, 1193, -324, 1178, -360, 457, -1059, 1186,
+  -339, 1175, -333, 1217, -333, 389, -1059, 465, -2271
+};
+
+static const int16_t PULSES_PROTOCOL_5[] = {
+  220, -495, 104, -657, 384, -640, 331, -346, 377, -600, 364, -742,
+  -10286, 1053, -471, 575, -919, 543, -947, 548, -960, 597, -950, 1084,
+  -413, 557, -931, 573, -900, 562, -978, 539, -911, 1091, -420, 599,
+  -960, 529, -971, 553, -925, 535, -933, 1063, -450, 1053, -446, 1090,
+  -414, 1098, -453, 1096, -468, 536, -943, 554, -941, 589, -946, 575,
+  -959, 3042, -6963, 1061, -410, 544, -974, 532, -944, 573, -963, 525,
+  -956, 1045, -426, 546, -905, 580, -957, 543, -907, 538, -939, 1024,
+  -436, 535, -954, 531, -928, 589, -971, 577, -944, 1084, -444, 1039,
+  -476, 1042, -414, 1030, -437, 1059, -475, 572, -972, 548, -976, 544,
+  -948, 598, -941, 3099, -6913, 1055, -404, 530, -964, 560, -964, 531,
+  -937, 552, -923, 1089, -404, 571, -938, 525, -917, 578, -928, 587,
+  -956, 1080, -429, 533, -910, 586, -952, 600, -953, 570, -973, 1078,
+  -399, 1051, -469, 1032, -466, 1101, -446, 1054, -454, 579, -915, 568,
+  -899, 580, -900, 574, -938, 3074, -6967, 1023, -420, 562, -951, 593,
+  -964, 583, -911, 551, -958, 1093, -477, 561, -928, 533, -931, 543,
+  -976, 569, -899, 1056, -426, 589, -970, 598, -907, 590, -937, 599,
+  -908, 1025, -443, 1066, -460, 1029, -465, 1096, -458, 1080, -423, 591,
+  -944, 564, -898, 565, -903, 577, -964, 3051, -6938
+};
+
+static const int16_t PULSES_PROTOCOL_6[] = {
+  348, -735, 318, -563, 379, -289, 101, -551, 282, -516, 235, -771,
+  -10695, 992, -839, 496, -838, 546, -380, 988, -835, 471, -362, 947,
+  -813, 469, -403, 916, -359, 933, -373, 984, -865, 520, -827, 502,
+  -872, 467, -841, 480, -422, 947, -368, 938, -373, 964, -832, 468,
+  -419, 944, -818, 509, -879, 483, -829, 528, -842, 503, -387, 918,
+  -354, 941, -420, 966, -429, 993, -830, 471, -10305, 495, -383, 964,
+  -870, 523, -811, 470, -369, 984, -884, 489, -396, 980, -839, 533,
+  -411, 972, -391, 973, -394, 922, -806, 525, -825, 480, -833, 484,
+  -840, 466, -422, 960, -388, 966, -416, 963, -858, 483, -387, 993,
+  -860, 529, -862, 506, -875, 540, -858, 482, -430, 933, -428, 932,
+  -393, 972, -418, 992, -811, 481, -10317, 521, -361, 952, -830, 533,
+  -825, 512, -396, 966, -881, 473, -375, 936, -859, 499, -402, 925,
+  -412, 974, -425, 975, -882, 470, -839, 518, -868, 527, -879, 532,
+  -423, 954, -403, 957, -365, 942, -851, 539, -403, 933, -833, 534,
+  -842, 543, -857, 508, -806, 514, -371, 930, -388, 993, -398, 969,
+  -399, 972, -851, 504, -10328, 487, -412, 989, -836, 470, -817, 503,
+  -399, 951, -817, 528, -429, 921, -840, 494, -427, 943, -392, 916,
+  -385, 927, -871, 505, -872, 537, -833, 484, -865, 537, -382, 974,
+  -368, 923, -367, 944, -852, 541, -375, 948, -866, 486, -861, 491,
+  -819, 533, -812, 517, -427, 917, -392, 923, -372, 954, -390, 961,
+  -842, 507, -10308, 511, -11238
+};
+
+static const int16_t PULSES_PROTOCOL_7[] = {
+  236, -184, 222, -145, 135, -421, 249, -283, 211, -803, 95, -702,
+  -11796, 159, -899, 139, -889, 910, -106, 160, -895, 156, -883, 896,
+  -152, 143, -908, 197, -853, 159, -879, 910, -113, 944, -143, 161,
+  -901, 922, -114, 178, -888, 172, -881, 144, -858, 921, -112, 153,
+  -890, 938, -149, 164, -887, 933, -118, 919, -121, 198, -897, 153,
+  -881, 344, -9263, 143, -894, 186, -862, 918, -122, 165, -866, 146,
+  -895, 904, -143, 168, -878, 167, -874, 157, -905, 903, -141, 941,
+  -114, 146, -887, 898, -107, 169, -857, 167, -877, 189, -882, 909,
+  -162, 182, -909, 919, -150, 158, -881, 937, -157, 916, -129, 138,
+  -876, 190, -907, 335, -9270, 183, -910, 167, -890, 945, -109, 175,
+  -869, 173, -898, 946, -155, 150, -912, 179, -877, 141, -899, 936,
+  -141, 892, -149, 174, -860, 894, -131, 196, -907, 155, -889, 139,
+  -861, 910, -128, 163, -904, 923, -108, 138, -856, 903, -138, 899,
+  -128, 174, -904, 157, -906, 312, -9283, 183, -872, 197, -881, 915,
+  -102, 172, -859, 189, -870, 941, -123, 145, -879, 185, -904, 183,
+  -888, 948, -154, 946, -127, 161, -905, 896, -125, 146, -900, 170,
+  -882, 178, -877, 930, -116, 176, -903, 893, -134, 195, -889, 921,
+  -107, 903, -160, 194, -881, 173, -885, 324, -9276
+};
+
+static const int16_t PULSES_PROTOCOL_8[] = {
+  368, -847, 171, -527, 62, -445, 176, -855, 280, -796, 157, -247,
+  -9521, 653, -3156, 1423, -3183, 617, -3191, 630, -3160, 1407, -3152, 593,
+  -3186, 1416, -3188, 622, -3205, 612, -3146, 1455, -3209, 608, -3162, 1419,
+  -3180, 1437, -3144, 592, -3202, 659, -3180, 1465, -3208, 604, -3135, 611,
+  -3205, 1454, -3136, 1447, -3152, 1405, -3188, 1435, -3169, 638, -3191, 635,
+  -3158, 612, -25963, 649, -3178, 1457, -3199, 635, -3210, 616, -3204, 1444,
+  -3207, 629, -3201, 1462, -3179, 652, -3160, 634, -3192, 1425, -3176, 634,
+  -3191, 1403, -3159, 1385, -3152, 664, -3153, 623, -3154, 1408, -3154, 601,
+  -3162, 595, -3196, 1456, -3154, 1423, -3161, 1453, -3136, 1457, -3178, 661,
+  -3157, 665, -3155, 605, -25959, 664, -3211, 1403, -3144, 657, -3168, 604,
+  -3182, 1408, -3169, 657, -3212, 1446, -3145, 645, -3160, 650, -3171, 1389,
+  -3205, 648, -3135, 1461, -3151, 1455, -3152, 599, -3148, 610, -3199, 1434,
+  -3140, 592, -3166, 660, -3160, 1456, -3141, 1386, -3159, 1410, -3188, 1465,
+  -3192, 620, -3162, 640, -3172, 620, -26009, 593, -3194, 1433, -3209, 609,
+  -3191, 628, -3190, 1390, -3158, 634, -3146, 1455, -3210, 602, -3148, 652,
+  -3139, 1394, -3204, 641, -3188, 1443, -3199, 1400, -3214, 614, -3146, 586,
+  -3169, 1458, -3205, 653, -3192, 596, -3194, 1447, -3149, 1456, -3152, 1435,
+  -3138, 1392, -3157, 630, -3206, 618, -3147, 650, -25973
+};
+
+static const int16_t PULSES_PROTOCOL_9[] = {
+  281, -894, 102, -884, 121, -306, 140, -434, 250, -486, 128, -534,
+  -12208, 1451, -3144, 662, -3163, 1456, -3210, 1455, -3146, 665, -3210, 652,
+  -3171, 1408, -3135, 1388, -3139, 1440, -3200, 1422, -3176, 660, -3165, 632,
+  -3170, 645, -3140, 1457, -3171, 590, -3215, 635, -3171, 1427, -3144, 1459,
+  -3180, 631, -3166, 1409, -3172, 665, -3179, 1433, -3205, 627, -3137, 1457,
+  -25966, 1393, -3169, 1444, -3146, 588, -3165, 1424, -3209, 1455, -3187, 622,
+  -3207, 631, -3200, 1464, -3195, 1409, -3156, 1464, -3181, 1436, -3189, 608,
+  -3136, 621, -3205, 590, -3207, 1402, -3199, 610, -3188, 630, -3205, 1425,
+  -3173, 1412, -3167, 628, -3159, 1436, -3175, 636, -3213, 1394, -3208, 650,
+  -3184, 1409, -25945, 1422, -3137, 1406, -3141, 637, -3153, 1453, -3193, 1421,
+  -3196, 589, -3147, 604, -3197, 1424, -3142, 1456, -3206, 1393, -3190, 1419,
+  -3212, 607, -3209, 598, -3147, 615, -3204, 1402, -3206, 638, -3193, 662,
+  -3162, 1411, -3183, 1409, -3202, 642, -3174, 1434, -3198, 601, -3172, 1387,
+  -3192, 585, -3196, 1412, -26011, 1401, -3137, 1447, -3167, 623, -3178, 1446,
+  -3144, 1397, -3137, 604, -3145, 597, -3210, 1388, -3157, 1424, -3163, 1387,
+  -3196, 1404, -3171, 622, -3176, 640, -3174, 613, -3160, 1406, -3151, 613,
+  -3152, 615, -3197, 1404, -3173, 1399, -3206, 650, -3180, 1408, -3173, 592,
+  -3198, 1442, -3135, 646, -3151, 1438, -25936, 1452, -11990
+};
+
+static const int16_t PULSES_PROTOCOL_10[] = {
+  69, -852, 155, -500, 352, -704, 397, -189, 200, -200, 112, -858,
+  -10337, 1130, -303, 1170, -360, 1122, -1032, 444, -1059, 410, -1082, 438,
+  -1019, 401, -296, 1155, -348, 1146, -337, 1116, -1030, 426, -348, 1133,
+  -1043, 414, -1088, 422, -282, 1174, -1041, 432, -296, 1167, -316, 1103,
+  -1072, 370, -1011, 377, -1042, 437, -1054, 372, -281, 1119, -325, 1175,
+  -6505, 444, -298, 1149, -343, 1108, -313, 1135, -1083, 410, -1050, 391,
+  -1053, 437, -1075, 390, -315, 1115, -323, 1178, -319, 1153, -1057, 443,
+  -350, 1161, -1041, 428, -1030, 380, -320, 1111, -1031, 439, -344, 1134,
+  -324, 1140, -1074, 394, -1058, 377, -1049, 415, -1079, 386, -299, 1177,
+  -287, 1177, -6539, 448, -330, 1135, -351, 1175, -288, 1154, -1090, 374,
+  -1075, 442, -1038, 379, -1023, 380, -360, 1142, -357, 1122, -332, 1146,
+  -1049, 428, -319, 1177, -1067, 427, -1079, 424, -330, 1148, -1016, 438,
+  -326, 1136, -345, 1130, -1080, 384, -1072, 379, -1054, 419, -1053, 431,
+  -345, 1139, -310, 1118, -6509, 402, -323, 1180, -339, 1176, -293, 1155,
+  -1051, 399, -1033, 402, -1055, 440, -1055, 428, -288, 1126, -305, 1178,
+  -283, 1139, -1072, 435, -347, 1168, -1043, 375, -1037, 426, -282, 1103,
+  -1027, 448, -310, 1131, -308, 1104, -1071, 441, -1039, 414, -1064, 372,
+  -1034, 374, -281, 1116, -298, 1152, -6527, 398, -11751
+};
+
+static const int16_t PULSES_PROTOCOL_11[] = {
+  289, -642, 396, -645, 114, -796, 336, -360, 277, -379, 393, -655,
+  -12031, 331, -219, 586, -223, 566, -532, 314, -536, 268, -224, 597,
+  -518, 273, -270, 586, -229, 546, -477, 330, -224, 542, -516, 281,
+  -9672, 294, -490, 330, -197, 539, -260, 556, -528, 292, -490, 273,
+  -264, 542, -502, 292, -203, 574, -246, 579, -541, 315, -225, 554,
+  -470, 295, -9680, 329, -475, 334, -218, 560, -222, 539, -480, 277,
+  -532, 292, -226, 568, -477, 272, -212, 606, -268, 595, -475, 313,
+  -217, 536, -526, 320, -9703, 287, -478, 285, -252, 535, -227, 552,
+  -531, 312, -477, 321, -217, 573, -470, 287, -203, 583, -242, 598,
+  -527, 299, -258, 546, -547, 338, -9704, 327, -10898
+};
+
+static const int16_t PULSES_PROTOCOL_12[] = {
+  363, -237, 221, -215, 165, -746, 212, -726, 160, -748, 356, -102,
+  -9492, 709, -612, 353, -586, 322, -256, 658, -616, 399, -618, 376,
+  -279, 688, -280, 711, -289, 649, -245, 706, -562, 338, -609, 370,
+  -11509, 376, -296, 714, -572, 379, -631, 367, -261, 698, -588, 346,
+  -612, 389, -247, 642, -264, 649, -318, 672, -241, 669, -590, 395,
+  -631, 339, -11465, 356, -265, 677, -628, 331, -612, 331, -288, 699,
+  -606, 356, -638, 396, -263, 661, -313, 663, -259, 678, -312, 648,
+  -582, 350, -603, 339, -11501, 397, -281, 660, -577, 335, -573, 390,
+  -261, 699, -627, 388, -639, 324, -288, 643, -316, 655, -265, 658,
+  -299, 692, -589, 389, -615, 370, -11513, 381, -9654
+};
+
+static const int16_t PULSES_SINGLE_REPEAT[] = {
+  328, -850, 248, -810, 157, -213, 311, -769, 383, -637, 142, -365,
+  -10205, 353, -971, 366, -1037, 1059, -286, 376, -1005, 1060, -283, 1070,
+  -307, 378, -987, 1133, -341, 1123, -344, 1059, -323, 391, -973, 1085,
+  -310, 1075, -293, 398, -1047, 409, -986, 1066, -307, 1114, -310, 414,
+  -1007, 1084, -276, 405, -990, 384, -989, 1117, -301, 421, -1006, 400,
+  -1040, 428, -10838
+};
+
+static const int16_t PULSES_NOISE[] = {
+  385, -49, 929, -692, 1134, -1014, 216, -837, 447, -1135, 1099, -258,
+  1049, -876, 1165, -176, 267, -1067, 1196, -595, 105, -6189, 215, -10131,
+  49, -707, 655, -1178, 1083, -529, 1035, -728, 452, -420, 430, -1121,
+  312, -764, 1072, -820, 779, -1198, 1098, -1037, 484, -131, 80, -1031,
+  608, -383, 771, -274, 867, -1076, 582, -948, 255, -1051, 1103, -718,
+  509, -99, 289, -974, 754, -784, 406, -351, 538, -11763, 1159, -561,
+  743, -1130, 809, -761, 1097, -131, 762, -9956, 64, -324, 885, -996,
+  833, -917, 1134, -444, 408, -1162, 995, -249, 814, -653, 494, -782,
+  490, -940, 317, -5399, 311, -201, 292, -604, 1036, -1024, 959, -523,
+  284, -930, 718, -45, 708, -677, 855, -9784, 699, -440, 271, -1044,
+  882, -8379, 1112, -886, 886, -555, 944, -740, 977, -206, 310, -1049,
+  513, -1039, 1150, -657, 149, -225, 1187, -451, 1049, -1112, 1069, -764,
+  648, -2280, 210, -777, 575, -929, 740, -371, 995, -233, 175, -501,
+  554, -2996, 602, -159, 732, -740, 434, -887, 791, -726, 1155, -7515,
+  152, -1049, 147, -312, 502, -721, 64, -2150, 725, -829, 878, -492,
+  336, -1189, 834, -372, 904, -772, 719, -648, 453, -312, 908, -786,
+  331, -165, 186, -195, 797, -5820, 922, -1038, 455, -89, 1133, -517,
+  783, -7375, 931, -11823, 603, -5756, 40, -688, 499, -473, 555, -736,
+  939, -4028, 60, -485, 421, -648, 575, -816, 579, -2854, 455, -108,
+  295, -927, 1014, -3438, 228, -577, 977, -923, 1046, -309, 351, -126,
+  540, -886, 684, -214, 647, -904, 1061, -1155, 1052, -809, 173, -4015,
+  770, -1082, 1115, -682, 402, -757, 1138, -313, 280, -913, 110, -994,
+  968, -1127, 834, -673, 1137, -277, 1068, -432, 965, -477, 218, -134,
+  669, -477, 1142, -667, 391, -45, 583, -7418, 838, -1082, 1121, -834,
+  821, -722, 851, -170, 243, -280, 124, -206, 758, -1131, 1128, -1001,
+  184, -477, 522, -459, 1164, -679, 897, -206, 229, -760, 186, -324,
+  234, -122, 511, -110, 222, -534, 1149, -523, 284, -441, 143, -758,
+  850, -443, 1011, -11723, 713, -314, 1006, -952, 273, -1049, 987, -1808,
+  1178, -96, 605, -529, 402, -8742, 944, -328, 879, -641, 140, -975,
+  972, -593, 441, -504, 1199, -1164, 408, -72, 289, -157, 1005, -497,
+  558, -925, 1129, -8526, 876, -946, 1034, -771, 614, -343, 596, -620,
+  419, -480, 886, -376, 299, -482, 713, -65, 59, -5521, 1047, -1175,
+  742, -681, 258, -74, 307, -1023, 703, -804, 638, -205, 48, -189,
+  643, -475, 911, -279, 417, -990, 798, -5672, 989, -409, 408, -802,
+  312, -721, 237, -256, 814, -1909, 1067, -763, 1160, -523, 1152, -847,
+  761, -4638, 192, -610, 1007, -1189, 353, -214, 439, -378, 973, -201,
+  120, -1080, 1075, -1178, 1044, -935, 356, -720, 876, -736, 1189, -242,
+  155, -1043, 936, -945, 569, -2730, 1056, -81, 1007, -763, 847, -43,
+  486, -6532, 250, -505, 495, -1017, 614, -8912, 665, -638, 931, -126,
+  1056, -780, 703, -846, 818, -761, 568, -823, 261, -163, 824, -633,
+  141, -964, 985, -359, 498, -953, 1131, -245, 236, -728, 1145, -367,
+  359, -134, 420, -600, 1002, -390, 1170, -894, 948, -1027, 637, -241,
+  1051, -803, 933, -103, 47, -1077, 477, -3854, 988, -226, 65, -110,
+  577, -467, 603, -1113, 124, -141, 146, -217, 689, -75, 340, -753,
+  394, -949, 877, -1098, 564, -299, 999, -656, 903, -507, 331, -818,
+  153, -10410, 586, -1067, 253, -49, 922, -6388, 820, -895, 241, -401,
+  222, -200, 449, -739, 1006, -635, 165, -480, 305, -205, 247, -274,
+  428, -6234, 489, -306, 931, -1158, 369, -612, 979, -66, 62, -880,
+  492, -82, 1134, -843, 682, -663, 878, -627, 1056, -83, 237, -48,
+  324, -711, 1170, -11722, 768, -130, 1043, -757, 408, -803, 1067, -424
+};
+
+struct PulseFixture {
+  const char* name;
+  uint8_t protocol;
+  uint64_t code;
+  uint8_t bitLength;
+  const int16_t* pulses;
+  uint16_t count;
+};
+
+#define PULSE_FIXTURE(name, protocol, code, bits) \
+  { #name, protocol, code, bits, PULSES_##name, sizeof(PULSES_##name) / sizeof(int16_t) }
+
+static const PulseFixture PROTOCOL_FIXTURES[] = {
+  PULSE_FIXTURE(PROTOCOL_1, 1, 0x2DD9A4, 24),    // EV1527/PT2262
+  PULSE_FIXTURE(PROTOCOL_2, 2, 0x5A5A33, 24),
+  PULSE_FIXTURE(PROTOCOL_3, 3, 0x13579B, 24),
+  PULSE_FIXTURE(PROTOCOL_4, 4, 0xC0FFEE, 24),
+  PULSE_FIXTURE(PROTOCOL_5, 5, 0x8421F0, 24),
+  PULSE_FIXTURE(PROTOCOL_6, 6, 0x6A3C5E1, 28),   // HT6P20B
+  PULSE_FIXTURE(PROTOCOL_7, 7, 0x2468AC, 24),    // HS2303-PT
+  PULSE_FIXTURE(PROTOCOL_8, 8, 0xB5A6C3, 24),    // Conrad RS-200 RX
+  PULSE_FIXTURE(PROTOCOL_9, 9, 0x4C3B2A, 24),    // Conrad RS-200 TX
+  PULSE_FIXTURE(PROTOCOL_10, 10, 0xE1D2C3, 24),  // 1ByOne Doorbell
+  PULSE_FIXTURE(PROTOCOL_11, 11, 0x9A5, 12),     // HT12E
+  PULSE_FIXTURE(PROTOCOL_12, 12, 0x6C3, 12)      // SM5212
+};
+
+// Must not decode: one protocol 1 repeat (nothing confirms it), random pulses
+static const PulseFixture REJECT_FIXTURES[] = {
+  PULSE_FIXTURE(SINGLE_REPEAT, 1, 0x2DD9A4, 24),
+  PULSE_FIXTURE(NOISE, 0, 0, 0)
+};
+
+#endif // RF_PULSE_FIXTURES_H
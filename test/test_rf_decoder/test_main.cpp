@@ -0,0 +1,67 @@
+/*
+ * RFDecoder test: feeds the captures in pulse_fixtures.h through the decoder
+ *
+ * Run: pio test -e native
+ */
+
+#include <unity.h>
+#include "RFDecoder.h"
+#include "pulse_fixtures.h"
+
+void setUp() {}
+void tearDown() {}
+
+// 按原始接收路径的编码（电平位 | 时长）逐个送入解码器，返回确认的帧数，frame为第一帧
+static uint16_t decodeFixture(const PulseFixture& fixture, RFDecodedFrame& frame) {
+  RFDecoder decoder;
+  uint16_t frames = 0;
+  for (uint16_t i = 0; i < fixture.count; i++) {
+    int16_t value = fixture.pulses[i];
+    uint16_t pulse = value > 0 ? (RF_RAW_LEVEL_HIGH | value) : (uint16_t)-value;
+    RFDecodedFrame decoded;
+    if (decoder.feed(pulse, decoded)) {
+      if (frames == 0) {
+        frame = decoded;
+      }
+      frames++;
+    }
+  }
+  return frames;
+}
+
+static void test_protocol_captures() {
+  for (const PulseFixture& fixture : PROTOCOL_FIXTURES) {
+    RFDecodedFrame frame = RFDecodedFrame();
+    uint16_t frames = decodeFixture(fixture, frame);
+    TEST_ASSERT_GREATER_THAN_UINT16_MESSAGE(0, frames, fixture.name);
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE((uint32_t)(fixture.code >> 32), (uint32_t)(frame.code >> 32), fixture.name);
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE((uint32_t)fixture.code, (uint32_t)frame.code, fixture.name);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(fixture.bitLength, frame.bitLength, fixture.name);
+    TEST_ASSERT_EQUAL_UINT8_MESSAGE(fixture.protocol, frame.protocol, fixture.name);
+  }
+}
+
+// 脉宽按所有数据位平均，应接近协议默认脉宽（接收机展宽的高电平和缩短的低电平相互抵消）
+static void test_protocol_pulse_length() {
+  for (const PulseFixture& fixture : PROTOCOL_FIXTURES) {
+    RFDecodedFrame frame = RFDecodedFrame();
+    decodeFixture(fixture, frame);
+    uint16_t expected = rfGetProtocol(fixture.protocol)->pulseLength;
+    TEST_ASSERT_UINT16_WITHIN_MESSAGE(expected / 10, expected, frame.pulseLength, fixture.name);
+  }
+}
+
+static void test_rejected_captures() {
+  for (const PulseFixture& fixture : REJECT_FIXTURES) {
+    RFDecodedFrame frame;
+    TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, decodeFixture(fixture, frame), fixture.name);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_protocol_captures);
+  RUN_TEST(test_protocol_pulse_length);
+  RUN_TEST(test_rejected_captures);
+  return UNITY_END();
+}